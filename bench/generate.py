@@ -0,0 +1,129 @@
+"""
+Synthetic Pyrinas Programs for Benchmarks
+
+Each shape stresses one dimension of the compiler at a given size:
+
+- functions: many small functions, all called from main
+- nesting: if and while statements nested size levels deep
+- structs: a struct with size fields, set and summed field by field
+- imports: size modules of size functions each, all imported by main
+
+generate(shape, size) returns the files of the program, main.pyr first, as
+a dict of path to source. The Python compiler accepts every shape; the C
+compiler has no module imports, so it skips the imports shape.
+"""
+
+import argparse
+import os
+
+SHAPES = ['functions', 'nesting', 'structs', 'imports']
+SIZES = {'functions': 2000, 'nesting': 90, 'structs': 1000, 'imports': 30}
+
+
+def _function(name, i):
+    return [
+        f"def {name}(a: int, b: int) -> int:",
+        f"    total: int = a * {i % 7 + 1} + b",
+        f"    k: int = 0",
+        f"    while k < 3:",
+        f"        if total % 2 == 0:",
+        f"            total = total - k",
+        f"        else:",
+        f"            total = total * 3 + 1",
+        f"        k = k + 1",
+        f"    return total % 1000",
+        "",
+    ]
+
+
+def _program_functions(size):
+    lines = []
+    for i in range(size):
+        lines += _function(f"f{i}", i)
+    lines += ["def main():", "    acc: int = 0"]
+    for i in range(size):
+        lines.append(f"    acc = (acc + f{i}(acc, {i})) % 100000")
+    lines.append("    print(acc)")
+    return {'main.pyr': "\n".join(lines) + "\n"}
+
+
+def _program_nesting(size):
+    lines = ["def main():", "    acc: int = 0"]
+    indent = "    "
+    for depth in range(size):
+        if depth % 2 == 0:
+            lines.append(f"{indent}if acc >= 0:")
+            indent += "    "
+            lines.append(f"{indent}acc = acc + {depth}")
+        else:
+            lines.append(f"{indent}j{depth}: int = 0")
+            lines.append(f"{indent}while j{depth} < 1:")
+            indent += "    "
+            lines.append(f"{indent}j{depth} = j{depth} + 1")
+            lines.append(f"{indent}acc = acc + j{depth}")
+    lines.append(f"{indent}print(acc)")
+    return {'main.pyr': "\n".join(lines) + "\n"}
+
+
+def _program_structs(size):
+    lines = ["class Wide:"]
+    for i in range(size):
+        lines.append(f"    f{i}: {'int' if i % 2 == 0 else 'float'}")
+    lines += ["", "def main():", "    w: Wide"]
+    for i in range(size):
+        lines.append(f"    w.f{i} = {i if i % 2 == 0 else float(i)}")
+    lines.append("    acc: int = 0")
+    for i in range(0, size, 2):
+        lines.append(f"    acc = acc + w.f{i}")
+    lines.append("    print(acc)")
+    return {'main.pyr': "\n".join(lines) + "\n"}
+
+
+def _program_imports(size):
+    files = {}
+    main = []
+    for m in range(size):
+        module = []
+        for i in range(size):
+            module += _function(f"f{i}", i + m)
+        files[f'modules/mod{m}.pyr'] = "\n".join(module)
+        main += [f'@module_import("modules/mod{m}")', f"def _import_mod{m}():", "    pass", ""]
+    main += ["def main():", "    acc: int = 0"]
+    for m in range(size):
+        for i in range(size):
+            main.append(f"    acc = (acc + mod{m}.f{i}(acc, {i})) % 100000")
+    main.append("    print(acc)")
+    return {'main.pyr': "\n".join(main) + "\n", **files}
+
+
+def generate(shape, size):
+    """Returns {relative path: source} for the program, main.pyr first."""
+    return globals()[f'_program_{shape}'](size)
+
+
+def write_program(files, directory):
+    """Writes the program under directory and returns the path of main.pyr."""
+    for path, source in files.items():
+        full = os.path.join(directory, path)
+        os.makedirs(os.path.dirname(full), exist_ok=True)
+        with open(full, 'w') as f:
+            f.write(source)
+    return os.path.join(directory, 'main.pyr')
+
+
+def line_count(files):
+    return sum(source.count("\n") + 1 for source in files.values())
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Write a synthetic Pyrinas program.')
+    parser.add_argument('shape', choices=SHAPES)
+    parser.add_argument('size', type=int, nargs='?', help='default: %s' % SIZES)
+    parser.add_argument('-o', '--output', default='.', help='directory to write main.pyr (and modules/) into')
+    args = parser.parse_args()
+    files = generate(args.shape, args.size or SIZES[args.shape])
+    print(write_program(files, args.output))
+
+
+if __name__ == '__main__':
+    main()
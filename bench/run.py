@@ -0,0 +1,148 @@
+"""
+Compiler Throughput Benchmark
+
+Compiles the synthetic programs from bench/generate.py with the C compiler
+(c_compiler/pyrinas-compiler, timed with --stats-json) and the Python
+compiler (timed in-process through compile_file), and reports source lines
+per second for each phase. A phase's rate is the best of --repeat runs.
+
+With --baseline, every phase that took at least MIN_SECONDS in the
+baseline must keep its rate within --threshold of it, otherwise the run
+fails; --save-baseline records the current rates there instead.
+
+    python3 bench/run.py --save-baseline --baseline bench/baseline.json
+    python3 bench/run.py --baseline bench/baseline.json --threshold 0.25
+"""
+
+import argparse
+import io
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from contextlib import redirect_stderr, redirect_stdout
+
+REPO_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+C_COMPILER = os.path.join(REPO_DIR, 'c_compiler', 'pyrinas-compiler')
+MIN_SECONDS = 0.005  # shorter phases are too noisy to compare
+
+sys.path.insert(0, REPO_DIR)
+from bench.generate import SHAPES, SIZES, generate, line_count, write_program  # noqa: E402
+
+
+def time_c(main_file, workdir):
+    """Seconds per phase for one C compiler run."""
+    stats_file = os.path.join(workdir, 'stats.json')
+    # The C compiler finds the runtime relative to its own directory
+    subprocess.run([C_COMPILER, main_file, '-o', os.path.join(workdir, 'main_c'), '--stats-json', stats_file],
+                   cwd=os.path.dirname(C_COMPILER), check=True, capture_output=True)
+    with open(stats_file) as f:
+        phases = json.load(f)['phases']
+    return {name: phase['wall_ms'] / 1000 for name, phase in phases.items()}
+
+
+def time_python(main_file, workdir):
+    """Seconds per phase for one Python compiler run, without the module cache."""
+    from pyrinas import cli
+    timings = {}
+    cwd = os.getcwd()
+    try:
+        # The Python compiler finds the runtime relative to the repository
+        os.chdir(REPO_DIR)
+        with redirect_stdout(io.StringIO()), redirect_stderr(io.StringIO()) as err:
+            cli.compile_file(main_file, os.path.join(workdir, 'main.c'), os.path.join(workdir, 'main_py'),
+                             cli.BuildOptions(module_cache=False), timings=timings)
+    except SystemExit:
+        raise RuntimeError(f"Python compiler failed on {main_file}:\n{err.getvalue()}")
+    finally:
+        os.chdir(cwd)
+    return timings
+
+
+COMPILERS = {'c': time_c, 'python': time_python}
+
+
+def bench(compiler, shape, size, repeat):
+    """Returns {'lines': n, 'phases': {phase: {'seconds', 'lines_per_sec'}}} for the best runs."""
+    files = generate(shape, size)
+    lines = line_count(files)
+    best = {}
+    with tempfile.TemporaryDirectory(prefix='pyrinas_bench_') as workdir:
+        main_file = write_program(files, workdir)
+        for _ in range(repeat):
+            timings = COMPILERS[compiler](main_file, workdir)
+            timings['total'] = sum(seconds for name, seconds in timings.items() if name != 'total')
+            for name, seconds in timings.items():
+                best[name] = min(best.get(name, seconds), seconds)
+    return {'lines': lines,
+            'phases': {name: {'seconds': seconds, 'lines_per_sec': lines / seconds if seconds else None}
+                       for name, seconds in best.items()}}
+
+
+def compare(results, baseline, threshold):
+    """Returns a message for every phase that got slower than the baseline allows."""
+    regressions = []
+    for key, base in baseline.items():
+        current = results.get(key)
+        if current is None:
+            continue
+        for name, phase in base['phases'].items():
+            now = current['phases'].get(name)
+            if now is None or phase['seconds'] < MIN_SECONDS or not now['lines_per_sec']:
+                continue
+            if now['lines_per_sec'] < phase['lines_per_sec'] * (1 - threshold):
+                regressions.append(f"{key} {name}: {now['lines_per_sec']:.0f} lines/s, "
+                                   f"baseline {phase['lines_per_sec']:.0f} lines/s")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Measure compiler throughput on synthetic programs.')
+    parser.add_argument('--compiler', choices=['c', 'python', 'both'], default='both')
+    parser.add_argument('--shape', choices=SHAPES, action='append', help='default: every shape')
+    parser.add_argument('--scale', type=float, default=1.0, help='multiply the default program sizes')
+    parser.add_argument('--repeat', type=int, default=3, help='runs per program; the fastest counts')
+    parser.add_argument('--baseline', help='JSON file of earlier results to compare against')
+    parser.add_argument('--threshold', type=float, default=0.25,
+                        help='allowed drop in lines/s against the baseline (default: 0.25)')
+    parser.add_argument('--save-baseline', action='store_true', help='write the results to --baseline')
+    parser.add_argument('--json', help='also write the results to this file')
+    args = parser.parse_args()
+
+    compilers = ['c', 'python'] if args.compiler == 'both' else [args.compiler]
+    if 'c' in compilers and not os.path.exists(C_COMPILER):
+        sys.exit(f"{C_COMPILER} not found; build it with make -C c_compiler")
+
+    results = {}
+    print(f"{'program':<22} {'phase':<10} {'seconds':>9} {'lines/s':>12}")
+    for compiler in compilers:
+        for shape in args.shape or SHAPES:
+            if compiler == 'c' and shape == 'imports':
+                continue  # the C compiler has no module imports
+            size = max(1, int(SIZES[shape] * args.scale))
+            key = f"{compiler}/{shape}/{size}"
+            results[key] = bench(compiler, shape, size, args.repeat)
+            for name, phase in results[key]['phases'].items():
+                rate = f"{phase['lines_per_sec']:.0f}" if phase['lines_per_sec'] else '-'
+                print(f"{key:<22} {name:<10} {phase['seconds']:>9.4f} {rate:>12}")
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(results, f, indent=2)
+    if args.baseline and args.save_baseline:
+        with open(args.baseline, 'w') as f:
+            json.dump(results, f, indent=2)
+        print(f"Saved baseline to {args.baseline}")
+    elif args.baseline:
+        with open(args.baseline) as f:
+            regressions = compare(results, json.load(f), args.threshold)
+        for message in regressions:
+            print(f"REGRESSION {message}")
+        if regressions:
+            sys.exit(1)
+        print(f"No phase is more than {args.threshold:.0%} slower than {args.baseline}")
+
+
+if __name__ == '__main__':
+    main()
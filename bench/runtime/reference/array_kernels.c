@@ -0,0 +1,36 @@
+/* Hand-written reference for array_kernels.pyr */
+#include <stdio.h>
+
+#define N 4096
+
+static void fill(int* values, int seed) {
+    for (int i = 0; i < N; i++) values[i] = (i * seed + 7) % 1000;
+}
+
+static void axpy(int a, const int* x, int* y) {
+    for (int i = 0; i < N; i++) y[i] = (a * x[i] + y[i]) % 65536;
+}
+
+static int dot(const int* x, const int* y) {
+    int total = 0;
+    for (int i = 0; i < N; i++) total = (total + x[i] * y[i]) % 1000003;
+    return total;
+}
+
+static void prefix_sums(int* x) {
+    for (int i = 0; i < N - 1; i++) x[i + 1] = (x[i + 1] + x[i]) % 65536;
+}
+
+int main(void) {
+    int x[N], y[N];
+    fill(x, 31);
+    fill(y, 17);
+    int checksum = 0;
+    for (int round = 0; round < 8000; round++) {
+        axpy(round % 7 + 1, x, y);
+        prefix_sums(y);
+        checksum = (checksum + dot(x, y)) % 1000003;
+    }
+    printf("%d\n", checksum);
+    return 0;
+}
@@ -0,0 +1,45 @@
+/* Hand-written reference for linked_list.pyr, with a bump allocator in
+   place of the arena */
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct Node {
+    int value;
+    struct Node* next;
+} Node;
+
+static Node* pool;
+static int used;
+
+static Node* new_node(int value, Node* next) {
+    Node* node = &pool[used++];
+    node->value = value;
+    node->next = next;
+    return node;
+}
+
+static void insert_sorted(Node* head, int value) {
+    Node* node = head;
+    while (node->next->value < value) node = node->next;
+    node->next = new_node(value, node->next);
+}
+
+static int checksum(Node* head, int count) {
+    int total = 0;
+    Node* node = head;
+    for (int i = 0; i < count; i++) {
+        node = node->next;
+        total = (total * 31 + node->value) % 1000003;
+    }
+    return total;
+}
+
+int main(void) {
+    pool = malloc(14002 * sizeof(Node));
+    Node* tail = new_node(2147483647, NULL);
+    Node* head = new_node(-1, tail);
+    for (int i = 0; i < 14000; i++) insert_sorted(head, i * 7919 % 100003);
+    printf("%d\n", checksum(head, 14000));
+    free(pool);
+    return 0;
+}
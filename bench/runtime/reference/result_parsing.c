@@ -0,0 +1,40 @@
+/* Hand-written reference for result_parsing.pyr */
+#include <stdio.h>
+
+#define N 8000
+
+static int parse_digit(int c, int* digit) {
+    if (c < 48 || c > 57) return 0;
+    *digit = c - 48;
+    return 1;
+}
+
+static int parse_field(const int* buf, int start, int* value) {
+    int v = 0;
+    for (int k = 0; k < 5; k++) {
+        int digit;
+        if (!parse_digit(buf[start + k], &digit)) return 0;
+        v = v * 10 + digit;
+    }
+    *value = v;
+    return 1;
+}
+
+int main(void) {
+    int buf[N];
+    for (int i = 0; i < N; i++) buf[i] = i % 97 == 0 ? 120 : 48 + (i * 7 + 3) % 10;
+    int total = 0, errors = 0;
+    for (int round = 0; round < 30000; round++) {
+        buf[round * 13 % N] = 48 + round % 11;
+        for (int field = 0; field < 1600; field++) {
+            int value;
+            if (parse_field(buf, field * 5, &value)) {
+                total = (total + value + round) % 1000003;
+            } else {
+                errors++;
+            }
+        }
+    }
+    printf("%d\n%d\n", total, errors);
+    return 0;
+}
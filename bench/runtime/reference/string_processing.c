@@ -0,0 +1,40 @@
+/* Hand-written reference for string_processing.pyr */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int count_char(const char* text, int n, char c) {
+    int count = 0;
+    for (int i = 0; i < n; i++) count += text[i] == c;
+    return count;
+}
+
+static int count_word(const char* text, int n, const char* word) {
+    int count = 0;
+    int width = (int)strlen(word);
+    for (int i = 0; i <= n - width; i++) count += memcmp(text + i, word, width) == 0;
+    return count;
+}
+
+int main(void) {
+    size_t capacity = 16, length = 0;
+    char* text = malloc(capacity);
+    for (int i = 0; i < 20000; i++) {
+        char piece[32];
+        int n = snprintf(piece, sizeof(piece), "%s%d ", i % 3 == 0 ? "alpha " : "beta ", i % 100);
+        if (length + n > capacity) {
+            while (length + n > capacity) capacity *= 2;
+            text = realloc(text, capacity);
+        }
+        memcpy(text + length, piece, n);
+        length += n;
+    }
+    int total = 0;
+    for (int round = 0; round < 100; round++) {
+        total += count_char(text, (int)length, 'a') + count_char(text, (int)length, ' ')
+               + count_word(text, (int)length, "beta");
+    }
+    printf("%d\n%d\n", (int)length, total);
+    free(text);
+    return 0;
+}
@@ -0,0 +1,39 @@
+/* Hand-written reference for struct_recursion.pyr */
+#include <stdio.h>
+
+typedef struct {
+    int count;
+    int total;
+    int low;
+    int high;
+} Stats;
+
+static Stats leaf(int value) {
+    Stats s = {1, value, value, value};
+    return s;
+}
+
+static Stats merge(Stats a, Stats b) {
+    Stats s;
+    s.count = a.count + b.count;
+    s.total = (a.total + b.total) % 1000003;
+    s.low = b.low < a.low ? b.low : a.low;
+    s.high = b.high > a.high ? b.high : a.high;
+    return s;
+}
+
+static Stats summarize(int lo, int hi, int seed) {
+    if (hi - lo == 1) return leaf((lo * seed + 11) % 997);
+    int mid = (lo + hi) / 2;
+    return merge(summarize(lo, mid, seed), summarize(mid, hi, seed));
+}
+
+int main(void) {
+    int checksum = 0;
+    for (int seed = 0; seed < 400; seed++) {
+        Stats s = summarize(0, 65536, seed + 1);
+        checksum = (checksum + s.total + s.low * 7 + s.high * 13 + s.count) % 1000003;
+    }
+    printf("%d\n", checksum);
+    return 0;
+}
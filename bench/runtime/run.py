@@ -0,0 +1,120 @@
+"""
+Generated-Code Runtime Benchmark
+
+Each program here has a hand-written C equivalent in reference/. Both are
+built at every -O level given, run --repeat times, and the fastest runs
+are compared as a ratio of the Pyrinas time to the C time, so a codegen
+regression (a boxed Result, a needless struct copy) shows up as a number
+rather than a feeling. The two must print the same output.
+
+With --baseline, a program's ratio may grow by at most --threshold over
+the baseline's before the run fails; --save-baseline records the ratios.
+Ratios carry over between machines better than times, but the baseline is
+best recorded where it is compared.
+
+    python3 bench/runtime/run.py -O 0 -O 2 --repeat 5
+    python3 bench/runtime/run.py --baseline bench/runtime/baseline.json --threshold 0.2
+"""
+
+import argparse
+import json
+import math
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_DIR = os.path.dirname(os.path.dirname(BENCH_DIR))
+PROGRAMS = sorted(name[:-4] for name in os.listdir(BENCH_DIR) if name.endswith('.pyr'))
+
+
+def build_pyrinas(name, level, workdir):
+    # Compile a copy, since the compiler writes the generated C next to its input
+    source = os.path.join(workdir, f'{name}.pyr')
+    shutil.copy(os.path.join(BENCH_DIR, f'{name}.pyr'), source)
+    exe = os.path.join(workdir, f'{name}_pyr_O{level}')
+    subprocess.run([sys.executable, '-m', 'pyrinas.cli', source, '-o', exe, f'-O{level}'],
+                   cwd=REPO_DIR, check=True, capture_output=True)
+    return exe
+
+
+def build_reference(name, level, workdir, cc):
+    exe = os.path.join(workdir, f'{name}_c_O{level}')
+    subprocess.run([cc, f'-O{level}', '-o', exe, os.path.join(BENCH_DIR, 'reference', f'{name}.c')],
+                   check=True, capture_output=True)
+    return exe
+
+
+def best_run(exe, repeat):
+    """Returns (fastest wall time in seconds, output)."""
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = subprocess.run([exe], check=True, capture_output=True, text=True)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best, result.stdout
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare Pyrinas programs against hand-written C.')
+    parser.add_argument('-O', dest='levels', type=int, action='append', choices=range(4),
+                        help='optimization level, repeatable (default: 0 to 3)')
+    parser.add_argument('--program', choices=PROGRAMS, action='append', help='default: every program')
+    parser.add_argument('--repeat', type=int, default=3, help='runs per build; the fastest counts')
+    parser.add_argument('--cc', default='gcc', help='C compiler for the references (default: gcc)')
+    parser.add_argument('--baseline', help='JSON file of earlier ratios to compare against')
+    parser.add_argument('--threshold', type=float, default=0.2,
+                        help='allowed growth of a ratio over the baseline (default: 0.2)')
+    parser.add_argument('--save-baseline', action='store_true', help='write the results to --baseline')
+    parser.add_argument('--json', help='also write the results to this file')
+    args = parser.parse_args()
+    levels = args.levels or [0, 1, 2, 3]
+
+    results = {}
+    mismatches = []
+    print(f"{'program':<20} {'level':<6} {'pyrinas s':>10} {'C s':>10} {'ratio':>7}")
+    with tempfile.TemporaryDirectory(prefix='pyrinas_runtime_bench_') as workdir:
+        for name in args.program or PROGRAMS:
+            for level in levels:
+                pyr_time, pyr_output = best_run(build_pyrinas(name, level, workdir), args.repeat)
+                c_time, c_output = best_run(build_reference(name, level, workdir, args.cc), args.repeat)
+                if pyr_output != c_output:
+                    mismatches.append(f"{name} -O{level}: output differs from the C reference")
+                ratio = pyr_time / c_time
+                results[f"{name}/O{level}"] = {'pyrinas_seconds': pyr_time, 'c_seconds': c_time, 'ratio': ratio}
+                print(f"{name:<20} -O{level:<4} {pyr_time:>10.4f} {c_time:>10.4f} {ratio:>7.2f}")
+
+    for level in levels:
+        ratios = [result['ratio'] for key, result in results.items() if key.endswith(f'/O{level}')]
+        print(f"{'geometric mean':<20} -O{level:<4} {'':>10} {'':>10} "
+              f"{math.exp(sum(map(math.log, ratios)) / len(ratios)):>7.2f}")
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(results, f, indent=2)
+    regressions = []
+    if args.baseline and args.save_baseline:
+        with open(args.baseline, 'w') as f:
+            json.dump(results, f, indent=2)
+        print(f"Saved baseline to {args.baseline}")
+    elif args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        for key, result in results.items():
+            if key in baseline and result['ratio'] > baseline[key]['ratio'] * (1 + args.threshold):
+                regressions.append(f"{key}: ratio {result['ratio']:.2f}, baseline {baseline[key]['ratio']:.2f}")
+
+    for message in mismatches:
+        print(f"MISMATCH {message}")
+    for message in regressions:
+        print(f"REGRESSION {message}")
+    if mismatches or regressions:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,127 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGNMENT 16
+
+static Arena* current_arena = NULL;
+
+static size_t align_up(size_t size) {
+    return (size + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static ArenaBlock* arena_block_new(Arena* arena, size_t min_size) {
+    size_t capacity = arena->block_size;
+    if (min_size > capacity) {
+        capacity = min_size;  // Oversized requests get a dedicated block
+    }
+
+    ArenaBlock* block = malloc(sizeof(ArenaBlock) + capacity);
+    if (!block) return NULL;
+
+    block->next = arena->head;
+    block->used = 0;
+    block->capacity = capacity;
+    arena->head = block;
+    arena->bytes_reserved += capacity;
+    return block;
+}
+
+// Arena management
+Arena* arena_new(size_t block_size) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) return NULL;
+
+    arena->head = NULL;
+    arena->block_size = block_size ? align_up(block_size) : ARENA_DEFAULT_BLOCK_SIZE;
+    arena->bytes_allocated = 0;
+    arena->bytes_reserved = 0;
+    return arena;
+}
+
+void arena_free(Arena* arena) {
+    if (!arena) return;
+
+    ArenaBlock* block = arena->head;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+
+    if (current_arena == arena) {
+        current_arena = NULL;
+    }
+    free(arena);
+}
+
+// Allocation
+void* arena_alloc(Arena* arena, size_t size) {
+    if (!arena) return NULL;
+
+    size = align_up(size ? size : 1);
+
+    ArenaBlock* block = arena->head;
+    if (!block || block->capacity - block->used < size) {
+        block = arena_block_new(arena, size);
+        if (!block) return NULL;
+    }
+
+    void* ptr = block->data + block->used;
+    block->used += size;
+    arena->bytes_allocated += size;
+    return ptr;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    void* ptr = arena_alloc(arena, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void* arena_grow(Arena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!ptr) return arena_alloc(arena, new_size);
+    if (new_size <= old_size) return ptr;
+
+    // Extend in place when ptr is the most recent allocation of the head block
+    ArenaBlock* block = arena->head;
+    size_t old_aligned = align_up(old_size ? old_size : 1);
+    size_t new_aligned = align_up(new_size);
+    if (block && (char*)ptr + old_aligned == block->data + block->used &&
+        block->capacity - block->used >= new_aligned - old_aligned) {
+        block->used += new_aligned - old_aligned;
+        arena->bytes_allocated += new_aligned - old_aligned;
+        return ptr;
+    }
+
+    void* new_ptr = arena_alloc(arena, new_size);
+    if (!new_ptr) return NULL;
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+char* arena_strdup(Arena* arena, const char* str) {
+    if (!str) return NULL;
+    return arena_strndup(arena, str, strlen(str));
+}
+
+char* arena_strndup(Arena* arena, const char* str, size_t length) {
+    if (!str) return NULL;
+
+    char* copy = arena_alloc(arena, length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// Compilation-unit arena
+void arena_set_current(Arena* arena) {
+    current_arena = arena;
+}
+
+Arena* arena_current(void) {
+    return current_arena;
+}
@@ -0,0 +1,40 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator backed by a chain of fixed-size blocks. Everything the
+// lexer, parser and semantic analyzer allocate for one compilation unit
+// lives here and is released in one go by arena_free().
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock* head;
+    size_t block_size;
+    size_t bytes_allocated;   // Bytes handed out to callers
+    size_t bytes_reserved;    // Bytes obtained from malloc for blocks
+} Arena;
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+// Arena management
+Arena* arena_new(size_t block_size);
+void arena_free(Arena* arena);
+
+// Allocation
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+void* arena_grow(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+char* arena_strdup(Arena* arena, const char* str);
+char* arena_strndup(Arena* arena, const char* str, size_t length);
+
+// Compilation-unit arena used by the AST, token and symbol constructors
+void arena_set_current(Arena* arena);
+Arena* arena_current(void);
+
+#endif // ARENA_H
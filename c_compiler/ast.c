@@ -1,4 +1,5 @@
 #include "ast.h"
+#include <stdarg.h>
 
 // String implementation
 String* string_new(const char* initial) {
@@ -24,22 +25,62 @@ String* string_new(const char* initial) {
     return str;
 }
 
+// Make room for `extra` more bytes plus the terminator, doubling capacity
+static bool string_reserve(String* str, size_t extra) {
+    size_t needed = str->length + extra + 1;
+    if (needed <= str->capacity) return true;
+    
+    size_t new_capacity = str->capacity * 2;
+    if (new_capacity < needed) new_capacity = needed;
+    
+    char* new_data = realloc(str->data, new_capacity);
+    if (!new_data) return false;
+    str->data = new_data;
+    str->capacity = new_capacity;
+    return true;
+}
+
 void string_append(String* str, const char* to_append) {
     if (!str || !to_append) return;
+    string_append_n(str, to_append, strlen(to_append));
+}
+
+void string_append_n(String* str, const char* to_append, size_t length) {
+    if (!str || !to_append || !string_reserve(str, length)) return;
+    
+    memcpy(str->data + str->length, to_append, length);
+    str->length += length;
+    str->data[str->length] = '\0';
+}
+
+void string_append_char(String* str, char c) {
+    if (!str || !string_reserve(str, 1)) return;
+    
+    str->data[str->length++] = c;
+    str->data[str->length] = '\0';
+}
+
+void string_appendf(String* str, const char* format, ...) {
+    if (!str || !format) return;
     
-    size_t append_len = strlen(to_append);
-    size_t new_len = str->length + append_len;
+    // Try formatting into the spare capacity first; retry once after growing
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(str->data + str->length, str->capacity - str->length, format, args);
+    va_end(args);
+    if (written < 0) return;
     
-    if (new_len >= str->capacity) {
-        size_t new_capacity = (new_len + 1) * 2;
-        char* new_data = realloc(str->data, new_capacity);
-        if (!new_data) return;
-        str->data = new_data;
-        str->capacity = new_capacity;
+    if ((size_t)written >= str->capacity - str->length) {
+        if (!string_reserve(str, (size_t)written)) {
+            str->data[str->length] = '\0';
+            return;
+        }
+        va_start(args, format);
+        vsnprintf(str->data + str->length, str->capacity - str->length, format, args);
+        va_end(args);
     }
     
-    strcpy(str->data + str->length, to_append);
-    str->length = new_len;
+    str->length += (size_t)written;
 }
 
 void string_free(String* str) {
@@ -53,17 +94,27 @@ char* string_cstr(String* str) {
     return str ? str->data : NULL;
 }
 
+// Nodes created so far, reported by --time-report
+static size_t nodes_created = 0;
+
+static ASTNode* ast_node_alloc(void) {
+    ASTNode* node = arena_alloc(arena_current(), sizeof(ASTNode));
+    if (node) nodes_created++;
+    return node;
+}
+
+size_t ast_node_count(void) {
+    return nodes_created;
+}
+
 // NodeArray implementation
 NodeArray* node_array_new(void) {
-    NodeArray* arr = malloc(sizeof(NodeArray));
+    NodeArray* arr = arena_alloc(arena_current(), sizeof(NodeArray));
     if (!arr) return NULL;
     
     arr->capacity = 8;
-    arr->items = malloc(sizeof(ASTNode*) * arr->capacity);
-    if (!arr->items) {
-        free(arr);
-        return NULL;
-    }
+    arr->items = arena_alloc(arena_current(), sizeof(ASTNode*) * arr->capacity);
+    if (!arr->items) return NULL;
     arr->count = 0;
     return arr;
 }
@@ -73,7 +124,9 @@ void node_array_push(NodeArray* arr, ASTNode* node) {
     
     if (arr->count >= arr->capacity) {
         size_t new_capacity = arr->capacity * 2;
-        ASTNode** new_items = realloc(arr->items, sizeof(ASTNode*) * new_capacity);
+        ASTNode** new_items = arena_grow(arena_current(), arr->items,
+                                         sizeof(ASTNode*) * arr->capacity,
+                                         sizeof(ASTNode*) * new_capacity);
         if (!new_items) return;
         arr->items = new_items;
         arr->capacity = new_capacity;
@@ -82,29 +135,14 @@ void node_array_push(NodeArray* arr, ASTNode* node) {
     arr->items[arr->count++] = node;
 }
 
-void node_array_free(NodeArray* arr) {
-    if (arr) {
-        if (arr->items) {
-            for (size_t i = 0; i < arr->count; i++) {
-                ast_node_free(arr->items[i]);
-            }
-            free(arr->items);
-        }
-        free(arr);
-    }
-}
-
 // StringArray implementation
 StringArray* string_array_new(void) {
-    StringArray* arr = malloc(sizeof(StringArray));
+    StringArray* arr = arena_alloc(arena_current(), sizeof(StringArray));
     if (!arr) return NULL;
     
     arr->capacity = 8;
-    arr->items = malloc(sizeof(char*) * arr->capacity);
-    if (!arr->items) {
-        free(arr);
-        return NULL;
-    }
+    arr->items = arena_alloc(arena_current(), sizeof(char*) * arr->capacity);
+    if (!arr->items) return NULL;
     arr->count = 0;
     return arr;
 }
@@ -114,46 +152,40 @@ void string_array_push(StringArray* arr, const char* str) {
     
     if (arr->count >= arr->capacity) {
         size_t new_capacity = arr->capacity * 2;
-        char** new_items = realloc(arr->items, sizeof(char*) * new_capacity);
+        char** new_items = arena_grow(arena_current(), arr->items,
+                                      sizeof(char*) * arr->capacity,
+                                      sizeof(char*) * new_capacity);
         if (!new_items) return;
         arr->items = new_items;
         arr->capacity = new_capacity;
     }
     
-    arr->items[arr->count] = strdup(str);
+    arr->items[arr->count] = arena_strdup(arena_current(), str);
     arr->count++;
 }
 
-void string_array_free(StringArray* arr) {
-    if (arr) {
-        if (arr->items) {
-            for (size_t i = 0; i < arr->count; i++) {
-                free(arr->items[i]);
-            }
-            free(arr->items);
-        }
-        free(arr);
-    }
-}
-
 // AST Node constructors
 ASTNode* ast_module_new(NodeArray* body) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_MODULE;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->module.body = body;
     return node;
 }
 
 ASTNode* ast_function_def_new(const char* name, ASTNode* args, ASTNode* returns, NodeArray* body, NodeArray* decorators) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_FUNCTION_DEF;
     node->line_no = 0;
-    node->function_def.name = name ? strdup(name) : NULL;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
+    node->function_def.name = intern(name);
     node->function_def.args = args;
     node->function_def.returns = returns;
     node->function_def.body = body;
@@ -162,34 +194,40 @@ ASTNode* ast_function_def_new(const char* name, ASTNode* args, ASTNode* returns,
 }
 
 ASTNode* ast_class_def_new(const char* name, NodeArray* bases, NodeArray* body) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CLASS_DEF;
     node->line_no = 0;
-    node->class_def.name = name ? strdup(name) : NULL;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
+    node->class_def.name = intern(name);
     node->class_def.bases = bases;
     node->class_def.body = body;
     return node;
 }
 
 ASTNode* ast_assign_new(NodeArray* targets, ASTNode* value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_ASSIGN;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->assign.targets = targets;
     node->assign.value = value;
     return node;
 }
 
 ASTNode* ast_ann_assign_new(ASTNode* target, ASTNode* annotation, ASTNode* value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_ANN_ASSIGN;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->ann_assign.target = target;
     node->ann_assign.annotation = annotation;
     node->ann_assign.value = value;
@@ -197,11 +235,13 @@ ASTNode* ast_ann_assign_new(ASTNode* target, ASTNode* annotation, ASTNode* value
 }
 
 ASTNode* ast_if_new(ASTNode* test, NodeArray* body, NodeArray* orelse) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_IF;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->if_stmt.test = test;
     node->if_stmt.body = body;
     node->if_stmt.orelse = orelse;
@@ -209,22 +249,26 @@ ASTNode* ast_if_new(ASTNode* test, NodeArray* body, NodeArray* orelse) {
 }
 
 ASTNode* ast_while_new(ASTNode* test, NodeArray* body) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_WHILE;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->while_stmt.test = test;
     node->while_stmt.body = body;
     return node;
 }
 
 ASTNode* ast_for_new(ASTNode* target, ASTNode* iter, NodeArray* body) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_FOR;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->for_stmt.target = target;
     node->for_stmt.iter = iter;
     node->for_stmt.body = body;
@@ -232,147 +276,175 @@ ASTNode* ast_for_new(ASTNode* target, ASTNode* iter, NodeArray* body) {
 }
 
 ASTNode* ast_break_new(const char* label) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_BREAK;
     node->line_no = 0;
-    node->break_continue.label = label ? strdup(label) : NULL;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
+    node->break_continue.label = intern(label);
     return node;
 }
 
 ASTNode* ast_continue_new(const char* label) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CONTINUE;
     node->line_no = 0;
-    node->break_continue.label = label ? strdup(label) : NULL;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
+    node->break_continue.label = intern(label);
     return node;
 }
 
 ASTNode* ast_return_new(ASTNode* value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_RETURN;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->return_stmt.value = value;
     return node;
 }
 
 ASTNode* ast_expr_stmt_new(ASTNode* value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_EXPR_STMT;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->expr_stmt.value = value;
     return node;
 }
 
 ASTNode* ast_pass_new(void) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_PASS;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     return node;
 }
 
 ASTNode* ast_match_new(ASTNode* subject, NodeArray* cases) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_MATCH;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->match_stmt.subject = subject;
     node->match_stmt.cases = cases;
     return node;
 }
 
 ASTNode* ast_match_case_new(ASTNode* pattern, NodeArray* body) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_MATCH_CASE;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->match_case.pattern = pattern;
     node->match_case.body = body;
     return node;
 }
 
 ASTNode* ast_name_new(const char* id, ExprContext ctx) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_NAME;
     node->line_no = 0;
-    node->name.id = id ? strdup(id) : NULL;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
+    node->name.id = intern(id);
     node->name.ctx = ctx;
     return node;
 }
 
 ASTNode* ast_constant_int_new(int value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CONSTANT;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->constant.value.type = CONST_INT;
     node->constant.value.int_val = value;
     return node;
 }
 
 ASTNode* ast_constant_float_new(double value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CONSTANT;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->constant.value.type = CONST_FLOAT;
     node->constant.value.float_val = value;
     return node;
 }
 
 ASTNode* ast_constant_string_new(const char* value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CONSTANT;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->constant.value.type = CONST_STRING;
-    node->constant.value.str_val = value ? strdup(value) : NULL;
+    node->constant.value.str_val = arena_strdup(arena_current(), value);
     return node;
 }
 
 ASTNode* ast_constant_bool_new(bool value) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CONSTANT;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->constant.value.type = CONST_BOOL;
     node->constant.value.bool_val = value;
     return node;
 }
 
 ASTNode* ast_constant_none_new(void) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CONSTANT;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->constant.value.type = CONST_NONE;
     return node;
 }
 
 ASTNode* ast_binop_new(ASTNode* left, BinOpType op, ASTNode* right) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_BINOP;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->binop.left = left;
     node->binop.op = op;
     node->binop.right = right;
@@ -380,22 +452,26 @@ ASTNode* ast_binop_new(ASTNode* left, BinOpType op, ASTNode* right) {
 }
 
 ASTNode* ast_unaryop_new(UnaryOpType op, ASTNode* operand) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_UNARYOP;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->unaryop.op = op;
     node->unaryop.operand = operand;
     return node;
 }
 
 ASTNode* ast_compare_new(ASTNode* left, CompareOpType* ops, NodeArray* comparators, size_t ops_count) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_COMPARE;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->compare.left = left;
     node->compare.ops = ops;
     node->compare.comparators = comparators;
@@ -404,207 +480,97 @@ ASTNode* ast_compare_new(ASTNode* left, CompareOpType* ops, NodeArray* comparato
 }
 
 ASTNode* ast_boolop_new(BoolOpType op, NodeArray* values) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_BOOLOP;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->boolop.op = op;
     node->boolop.values = values;
     return node;
 }
 
 ASTNode* ast_call_new(ASTNode* func, NodeArray* args) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_CALL;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->call.func = func;
     node->call.args = args;
     return node;
 }
 
 ASTNode* ast_attribute_new(ASTNode* value, const char* attr, ExprContext ctx) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_ATTRIBUTE;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->attribute.value = value;
-    node->attribute.attr = attr ? strdup(attr) : NULL;
+    node->attribute.attr = intern(attr);
     node->attribute.ctx = ctx;
     return node;
 }
 
 ASTNode* ast_subscript_new(ASTNode* value, ASTNode* slice, ExprContext ctx) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_SUBSCRIPT;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->subscript.value = value;
     node->subscript.slice = slice;
     node->subscript.ctx = ctx;
+    node->subscript.in_bounds = false;
+    return node;
+}
+
+ASTNode* ast_tuple_new(NodeArray* elts) {
+    ASTNode* node = ast_node_alloc();
+    if (!node) return NULL;
+    
+    node->type = AST_TUPLE;
+    node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
+    node->tuple.elts = elts;
     return node;
 }
 
 ASTNode* ast_arg_new(const char* arg, ASTNode* annotation) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_ARG;
     node->line_no = 0;
-    node->arg.arg = arg ? strdup(arg) : NULL;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
+    node->arg.arg = intern(arg);
     node->arg.annotation = annotation;
     return node;
 }
 
 ASTNode* ast_arguments_new(NodeArray* args) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = ast_node_alloc();
     if (!node) return NULL;
     
     node->type = AST_ARGUMENTS;
     node->line_no = 0;
+    node->resolved_type = NULL;
+    node->value_type = NULL;
     node->arguments.args = args;
     return node;
 }
 
-// Memory management
-void ast_node_free(ASTNode* node) {
-    if (!node) return;
-    
-    switch (node->type) {
-        case AST_MODULE:
-            node_array_free(node->module.body);
-            break;
-            
-        case AST_FUNCTION_DEF:
-            free(node->function_def.name);
-            ast_node_free(node->function_def.args);
-            ast_node_free(node->function_def.returns);
-            node_array_free(node->function_def.body);
-            node_array_free(node->function_def.decorator_list);
-            break;
-            
-        case AST_CLASS_DEF:
-            free(node->class_def.name);
-            node_array_free(node->class_def.bases);
-            node_array_free(node->class_def.body);
-            break;
-            
-        case AST_ASSIGN:
-            node_array_free(node->assign.targets);
-            ast_node_free(node->assign.value);
-            break;
-            
-        case AST_ANN_ASSIGN:
-            ast_node_free(node->ann_assign.target);
-            ast_node_free(node->ann_assign.annotation);
-            ast_node_free(node->ann_assign.value);
-            break;
-            
-        case AST_IF:
-            ast_node_free(node->if_stmt.test);
-            node_array_free(node->if_stmt.body);
-            node_array_free(node->if_stmt.orelse);
-            break;
-            
-        case AST_WHILE:
-            ast_node_free(node->while_stmt.test);
-            node_array_free(node->while_stmt.body);
-            break;
-            
-        case AST_FOR:
-            ast_node_free(node->for_stmt.target);
-            ast_node_free(node->for_stmt.iter);
-            node_array_free(node->for_stmt.body);
-            break;
-            
-        case AST_BREAK:
-        case AST_CONTINUE:
-            free(node->break_continue.label);
-            break;
-            
-        case AST_RETURN:
-            ast_node_free(node->return_stmt.value);
-            break;
-            
-        case AST_EXPR_STMT:
-            ast_node_free(node->expr_stmt.value);
-            break;
-            
-        case AST_MATCH:
-            ast_node_free(node->match_stmt.subject);
-            node_array_free(node->match_stmt.cases);
-            break;
-            
-        case AST_MATCH_CASE:
-            ast_node_free(node->match_case.pattern);
-            node_array_free(node->match_case.body);
-            break;
-            
-        case AST_NAME:
-            free(node->name.id);
-            break;
-            
-        case AST_CONSTANT:
-            if (node->constant.value.type == CONST_STRING) {
-                free(node->constant.value.str_val);
-            }
-            break;
-            
-        case AST_BINOP:
-            ast_node_free(node->binop.left);
-            ast_node_free(node->binop.right);
-            break;
-            
-        case AST_UNARYOP:
-            ast_node_free(node->unaryop.operand);
-            break;
-            
-        case AST_COMPARE:
-            ast_node_free(node->compare.left);
-            free(node->compare.ops);
-            node_array_free(node->compare.comparators);
-            break;
-            
-        case AST_BOOLOP:
-            node_array_free(node->boolop.values);
-            break;
-            
-        case AST_CALL:
-            ast_node_free(node->call.func);
-            node_array_free(node->call.args);
-            break;
-            
-        case AST_ATTRIBUTE:
-            ast_node_free(node->attribute.value);
-            free(node->attribute.attr);
-            break;
-            
-        case AST_SUBSCRIPT:
-            ast_node_free(node->subscript.value);
-            ast_node_free(node->subscript.slice);
-            break;
-            
-        case AST_ARG:
-            free(node->arg.arg);
-            ast_node_free(node->arg.annotation);
-            break;
-            
-        case AST_ARGUMENTS:
-            node_array_free(node->arguments.args);
-            break;
-            
-        case AST_PASS:
-            // Nothing to free
-            break;
-    }
-    
-    free(node);
-}
-
 // Utility functions
 const char* ast_node_type_name(ASTNodeType type) {
     switch (type) {
@@ -632,6 +598,7 @@ const char* ast_node_type_name(ASTNodeType type) {
         case AST_CALL: return "Call";
         case AST_ATTRIBUTE: return "Attribute";
         case AST_SUBSCRIPT: return "Subscript";
+        case AST_TUPLE: return "Tuple";
         case AST_ARG: return "arg";
         case AST_ARGUMENTS: return "arguments";
         default: return "Unknown";
@@ -5,6 +5,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "arena.h"
+#include "intern.h"
 
 // Forward declarations
 typedef struct ASTNode ASTNode;
@@ -20,10 +22,13 @@ typedef struct {
 
 String* string_new(const char* initial);
 void string_append(String* str, const char* to_append);
+void string_append_n(String* str, const char* to_append, size_t length);
+void string_append_char(String* str, char c);
+void string_appendf(String* str, const char* format, ...);
 void string_free(String* str);
 char* string_cstr(String* str);
 
-// Dynamic array for AST nodes
+// Dynamic array for AST nodes (arena-owned, no explicit free)
 typedef struct {
     ASTNode** items;
     size_t count;
@@ -32,7 +37,6 @@ typedef struct {
 
 NodeArray* node_array_new(void);
 void node_array_push(NodeArray* arr, ASTNode* node);
-void node_array_free(NodeArray* arr);
 
 // Dynamic array for strings
 typedef struct {
@@ -43,7 +47,6 @@ typedef struct {
 
 StringArray* string_array_new(void);
 void string_array_push(StringArray* arr, const char* str);
-void string_array_free(StringArray* arr);
 
 // AST Node Types
 typedef enum {
@@ -75,6 +78,7 @@ typedef enum {
     AST_CALL,
     AST_ATTRIBUTE,
     AST_SUBSCRIPT,
+    AST_TUPLE,
     
     // Others
     AST_ARG,
@@ -144,6 +148,8 @@ typedef struct {
 struct ASTNode {
     ASTNodeType type;
     int line_no;
+    const struct Type* resolved_type;  // Cached type of an annotation node
+    const struct Type* value_type;     // Type of an expression, set by semantic analysis
     
     union {
         // Module
@@ -283,8 +289,14 @@ struct ASTNode {
             struct ASTNode* value;
             struct ASTNode* slice;
             ExprContext ctx;
+            bool in_bounds;  // Index proven in range; never bounds-checked
         } subscript;
         
+        // Tuple (multi-argument type annotations such as array[int, 5])
+        struct {
+            NodeArray* elts;
+        } tuple;
+        
         // Function argument
         struct {
             char* arg;
@@ -299,6 +311,9 @@ struct ASTNode {
 };
 
 // AST Node constructors
+// Nodes and their strings are allocated from arena_current() and released
+// together with the compilation-unit arena. Identifier fields (names,
+// attributes, parameters, labels) hold interned pointers.
 ASTNode* ast_module_new(NodeArray* body);
 ASTNode* ast_function_def_new(const char* name, ASTNode* args, ASTNode* returns, NodeArray* body, NodeArray* decorators);
 ASTNode* ast_class_def_new(const char* name, NodeArray* bases, NodeArray* body);
@@ -327,14 +342,15 @@ ASTNode* ast_boolop_new(BoolOpType op, NodeArray* values);
 ASTNode* ast_call_new(ASTNode* func, NodeArray* args);
 ASTNode* ast_attribute_new(ASTNode* value, const char* attr, ExprContext ctx);
 ASTNode* ast_subscript_new(ASTNode* value, ASTNode* slice, ExprContext ctx);
+ASTNode* ast_tuple_new(NodeArray* elts);
 ASTNode* ast_arg_new(const char* arg, ASTNode* annotation);
 ASTNode* ast_arguments_new(NodeArray* args);
 
-// Memory management
-void ast_node_free(ASTNode* node);
-
 // Utility functions
 const char* ast_node_type_name(ASTNodeType type);
 void ast_print(ASTNode* node, int indent);
 
+// Number of AST nodes created since startup
+size_t ast_node_count(void);
+
 #endif // AST_H
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "build.h"
+#include "ast.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void build_options_init(BuildOptions* options) {
+    options->cc = "gcc";
+    options->opt_level = 0;
+    options->target_cpu = NULL;
+    options->lto = false;
+    options->runtime_dir = "../runtime";
+    options->debug = false;
+    options->pgo = PGO_NONE;
+    options->pgo_dir = "/tmp/pyrinas_cache/pgo";
+}
+
+void build_options_release(BuildOptions* options) {
+    options->opt_level = 3;
+    options->lto = true;
+}
+
+static bool is_default_profile(const BuildOptions* options) {
+    return strcmp(options->cc, "gcc") == 0 && options->opt_level == 0 &&
+           !options->target_cpu && !options->lto && options->pgo == PGO_NONE;
+}
+
+// Flags shared by the runtime and the program
+static void append_profile_flags(const BuildOptions* options, String* command) {
+    string_appendf(command, " -O%d", options->opt_level);
+    if (options->target_cpu) string_appendf(command, " -march=%s", options->target_cpu);
+    if (options->lto) string_append(command, " -flto");
+}
+
+// Directory-safe profile name, e.g. "gcc-O3-native-lto"
+static void append_profile_name(const BuildOptions* options, String* path) {
+    const char* cc = strrchr(options->cc, '/');
+    cc = cc ? cc + 1 : options->cc;
+
+    char name[256];
+    static const char* const pgo_names[] = {"", "-pgo-generate", "-pgo-use"};
+    snprintf(name, sizeof(name), "%s-O%d%s%s%s%s", cc, options->opt_level,
+             options->target_cpu ? "-" : "", options->target_cpu ? options->target_cpu : "",
+             options->lto ? "-lto" : "", pgo_names[options->pgo]);
+
+    for (char* c = name; *c; c++) {
+        if (!isalnum((unsigned char)*c) && *c != '-' && *c != '_' && *c != '.') *c = '_';
+    }
+    string_append(path, name);
+}
+
+static bool make_directory(const char* path) {
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+// mkdir -p
+static bool make_directories(const char* path) {
+    char partial[1024];
+    snprintf(partial, sizeof(partial), "%s", path);
+    for (char* slash = strchr(partial + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        if (!make_directory(partial)) return false;
+        *slash = '/';
+    }
+    return make_directory(partial);
+}
+
+// Profile-guided optimization. The program and the runtime each keep their
+// profile in <pgo_dir>/<hash>/, the hash covering their sources and the
+// build settings, so one that changed since training finds no profile and
+// is built without one. -dumpdir ./ and -fprofile-prefix-path (GCC 11 and
+// later) name the profile .#<object stem>.gcda wherever the object is.
+
+// FNV-1a, 64-bit
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool hash_file(const char* path, uint64_t* hash) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    char buffer[8192];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        *hash = hash_bytes(*hash, buffer, length);
+    }
+    *hash = hash_bytes(*hash, "", 1);
+    fclose(file);
+    return true;
+}
+
+// Profile file of a unit compiled from sources to object_file
+static bool pgo_profile_file(const BuildOptions* options, const char* const* sources, size_t count,
+                             const char* object_file, char* profile, size_t size) {
+    char settings[512];
+    snprintf(settings, sizeof(settings), "%s -O%d %s %d %d", options->cc, options->opt_level,
+             options->target_cpu ? options->target_cpu : "", options->lto, options->debug);
+    uint64_t hash = hash_bytes(14695981039346656037ull, settings, strlen(settings) + 1);
+    for (size_t i = 0; i < count; i++) {
+        if (!hash_file(sources[i], &hash)) {
+            fprintf(stderr, "Error: Cannot read '%s'\n", sources[i]);
+            return false;
+        }
+    }
+
+    const char* stem = strrchr(object_file, '/');
+    stem = stem ? stem + 1 : object_file;
+    const char* dot = strrchr(stem, '.');
+    snprintf(profile, size, "%s/%016llx/.#%.*s.gcda", options->pgo_dir, (unsigned long long)hash,
+             dot ? (int)(dot - stem) : (int)strlen(stem), stem);
+    return true;
+}
+
+static bool append_pgo_flags(const BuildOptions* options, const char* const* sources, size_t count,
+                             const char* object_file, String* command) {
+    if (options->pgo == PGO_NONE) return true;
+
+    char profile[1024], directory[1024], cwd[1024];
+    if (!pgo_profile_file(options, sources, count, object_file, profile, sizeof(profile))) return false;
+    if (!getcwd(cwd, sizeof(cwd))) {
+        fprintf(stderr, "Error: Cannot determine the current directory\n");
+        return false;
+    }
+    snprintf(directory, sizeof(directory), "%.*s", (int)(strrchr(profile, '/') - profile), profile);
+
+    if (options->pgo == PGO_GENERATE) {
+        if (!make_directories(directory)) {
+            fprintf(stderr, "Error: Cannot create profile directory '%s'\n", directory);
+            return false;
+        }
+        // Tasks and parallel loops update the counters from several threads
+        string_appendf(command, " -dumpdir ./ -fprofile-prefix-path=%s -fprofile-generate=%s"
+                       " -fprofile-update=prefer-atomic", cwd, directory);
+        return true;
+    }
+
+    if (access(profile, F_OK) != 0) {
+        printf("Warning: no profile data for %s; it changed since training or was not run. "
+               "Compiling it without PGO.\n", sources[0]);
+        return true;
+    }
+    string_appendf(command, " -dumpdir ./ -fprofile-prefix-path=%s -fprofile-use=%s -Wno-missing-profile",
+                   cwd, directory);
+    return true;
+}
+
+static void runtime_sources(const BuildOptions* options, char* c_file, char* header, size_t size) {
+    snprintf(c_file, size, "%s/pyrinas.c", options->runtime_dir);
+    snprintf(header, size, "%s/pyrinas.h", options->runtime_dir);
+}
+
+// The object is stale if any runtime source is newer than it, or with
+// PGO_USE, the profile it was built with
+static bool object_is_current(const char* object, const BuildOptions* options) {
+    struct stat object_stat;
+    if (stat(object, &object_stat) != 0) return false;
+
+    if (options->pgo == PGO_USE) {
+        char c_file[1024], header[1024], profile[1024];
+        runtime_sources(options, c_file, header, sizeof(c_file));
+        const char* const sources[] = {c_file, header};
+        struct stat profile_stat;
+        if (pgo_profile_file(options, sources, 2, object, profile, sizeof(profile)) &&
+            stat(profile, &profile_stat) == 0 && profile_stat.st_mtime >= object_stat.st_mtime) {
+            return false;
+        }
+    }
+
+    static const char* const sources[] = {"pyrinas.c", "pyrinas.h"};
+    char path[1024];
+    for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+        struct stat source_stat;
+        snprintf(path, sizeof(path), "%s/%s", options->runtime_dir, sources[i]);
+        if (stat(path, &source_stat) == 0 && source_stat.st_mtime > object_stat.st_mtime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool run_command(const char* label, const char* command) {
+    printf("%s: %s\n", label, command);
+    fflush(stdout);
+    return system(command) == 0;
+}
+
+const char* build_runtime_object(const BuildOptions* options) {
+    static char object[1024];
+
+    // The default profile uses the object built by the top-level Makefile
+    if (is_default_profile(options)) {
+        snprintf(object, sizeof(object), "%s/pyrinas.o", options->runtime_dir);
+        return object;
+    }
+
+    String* path = string_new(options->runtime_dir);
+    if (!path) return NULL;
+
+    string_append(path, "/build");
+    bool ok = make_directory(string_cstr(path));
+    string_append_char(path, '/');
+    append_profile_name(options, path);
+    ok = ok && make_directory(string_cstr(path));
+    snprintf(object, sizeof(object), "%s/pyrinas.o", string_cstr(path));
+    string_free(path);
+
+    if (!ok) {
+        fprintf(stderr, "Error: Cannot create runtime build directory for '%s'\n", object);
+        return NULL;
+    }
+    if (object_is_current(object, options)) return object;
+
+    String* command = string_new(options->cc);
+    if (!command) return NULL;
+
+    char c_file[1024], header[1024];
+    runtime_sources(options, c_file, header, sizeof(c_file));
+    const char* const sources[] = {c_file, header};
+
+    string_appendf(command, " -c -I %s", options->runtime_dir);
+    append_profile_flags(options, command);
+    ok = append_pgo_flags(options, sources, 2, object, command);
+    string_appendf(command, " -o %s %s", object, c_file);
+    ok = ok && run_command("Compiling runtime", string_cstr(command));
+    string_free(command);
+
+    if (!ok) {
+        fprintf(stderr, "Error: Runtime compilation failed\n");
+        return NULL;
+    }
+    return object;
+}
+
+bool build_object(const BuildOptions* options, const char* c_file, const char* object_file) {
+    String* command = string_new(options->cc);
+    if (!command) return false;
+
+    string_appendf(command, " -c -I %s", options->runtime_dir);
+    if (!is_default_profile(options)) append_profile_flags(options, command);
+    if (options->opt_level > 0) {
+        // Use the static inline Result helpers from pyrinas.h
+        string_append(command, " -DPYRINAS_INLINE_RUNTIME");
+    }
+    if (options->debug) string_append(command, " -g");
+    bool ok = append_pgo_flags(options, &c_file, 1, object_file, command);
+    string_appendf(command, " -o %s %s", object_file, c_file);
+    ok = ok && run_command("Compiling C code", string_cstr(command));
+    string_free(command);
+
+    if (!ok) {
+        fprintf(stderr, "Error: C compilation failed\n");
+    }
+    return ok;
+}
+
+bool build_link(const BuildOptions* options, const char* object_file, const char* output_file) {
+    const char* runtime = build_runtime_object(options);
+    if (!runtime) return false;
+
+    String* command = string_new(options->cc);
+    if (!command) return false;
+
+    // With LTO the optimization flags matter at link time too
+    if (!is_default_profile(options)) append_profile_flags(options, command);
+    // The instrumented program links the profiling runtime
+    if (options->pgo == PGO_GENERATE) string_append(command, " -fprofile-generate");
+    string_appendf(command, " -o %s %s %s -lm -pthread", output_file, object_file, runtime);
+    bool ok = run_command("Linking", string_cstr(command));
+    string_free(command);
+
+    if (!ok) {
+        fprintf(stderr, "Error: Linking failed\n");
+    }
+    return ok;
+}
+
+bool build_pgo_train(const BuildOptions* options, const char* c_file, const char* object_file,
+                     const char* command) {
+    char runtime_c_file[1024], header[1024], profile[1024];
+    runtime_sources(options, runtime_c_file, header, sizeof(runtime_c_file));
+    const char* const runtime[] = {runtime_c_file, header};
+
+    if (!pgo_profile_file(options, &c_file, 1, object_file, profile, sizeof(profile))) return false;
+    remove(profile);
+    if (!pgo_profile_file(options, runtime, 2, "pyrinas.o", profile, sizeof(profile))) return false;
+    remove(profile);
+
+    if (!run_command("Training", command)) {
+        fprintf(stderr, "Error: Training command failed\n");
+        return false;
+    }
+    return true;
+}
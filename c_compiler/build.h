@@ -0,0 +1,49 @@
+#ifndef BUILD_H
+#define BUILD_H
+
+#include <stdbool.h>
+
+// Profile-guided optimization: an instrumented build that records a profile
+// when run, or a build optimized with the recorded profile
+typedef enum {
+    PGO_NONE,
+    PGO_GENERATE,  // -fprofile-generate
+    PGO_USE        // -fprofile-use
+} PgoMode;
+
+// C backend settings. Every profile other than the default gets its own
+// runtime object under <runtime_dir>/build/<profile>/, so the runtime is
+// always compiled with the same flags (and LTO mode) as the program.
+typedef struct {
+    const char* cc;          // C compiler driver (default: gcc)
+    int opt_level;           // -O0 .. -O3
+    const char* target_cpu;  // -march value, or NULL
+    bool lto;                // -flto for both the program and the runtime
+    const char* runtime_dir;
+    bool debug;              // -g: debug info for the program
+    PgoMode pgo;
+    const char* pgo_dir;     // Profiles, one directory per program and runtime source
+} BuildOptions;
+
+void build_options_init(BuildOptions* options);
+
+// --release: -O3 with LTO
+void build_options_release(BuildOptions* options);
+
+// Compiles the runtime for this profile if its object is missing or stale
+// and returns the object's path (static buffer).
+const char* build_runtime_object(const BuildOptions* options);
+
+// Compiles a generated C file to an object file
+bool build_object(const BuildOptions* options, const char* c_file, const char* object_file);
+
+// Links a compiled program against the runtime, building the runtime for
+// this profile first if needed
+bool build_link(const BuildOptions* options, const char* object_file, const char* output_file);
+
+// Runs the instrumented program's training command after deleting the
+// profiles of earlier runs, so the next PGO_USE build sees only this one
+bool build_pgo_train(const BuildOptions* options, const char* c_file, const char* object_file,
+                     const char* command);
+
+#endif // BUILD_H
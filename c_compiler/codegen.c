@@ -1,5 +1,20 @@
 #include "codegen.h"
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Six sections, each followed by at most one separator
+#define CODEGEN_MAX_IOV 12
+
+// Functions of at most this many statements, nested ones included, are
+// emitted static inline
+#define INLINE_MAX_STATEMENTS 4
+
+static void append_string_literal(String* output, const char* value);
+static void generate_profile_probe(CodeGenerator* codegen, ASTNode* node, String* output);
+static void generate_line_directive(CodeGenerator* codegen, ASTNode* node, String* output);
 
 // Code generator management
 CodeGenerator* codegen_new(SymbolTable* symbol_table, SemanticAnalyzer* analyzer) {
@@ -9,14 +24,23 @@ CodeGenerator* codegen_new(SymbolTable* symbol_table, SemanticAnalyzer* analyzer
     codegen->main_code = string_new("");
     codegen->function_definitions = string_new("");
     codegen->struct_definitions = string_new("");
+    codegen->parallel_declarations = string_new("");
+    codegen->parallel_definitions = string_new("");
     codegen->includes = string_new("#include \"../runtime/pyrinas.h\"\n");
     codegen->current_output = codegen->main_code;  // Default to main code
     codegen->symbol_table = symbol_table;
     codegen->semantic_analyzer = analyzer;
     codegen->indent_level = 0;
+    codegen->current_function = "main";
+    codegen->parallel_loops = 0;
+    codegen->bounds_check = false;
+    codegen->profile = false;
+    codegen->line_directives = false;
+    codegen->source_file = "";
     
     if (!codegen->main_code || !codegen->function_definitions || 
-        !codegen->struct_definitions || !codegen->includes) {
+        !codegen->struct_definitions || !codegen->parallel_declarations ||
+        !codegen->parallel_definitions || !codegen->includes) {
         codegen_free(codegen);
         return NULL;
     }
@@ -29,6 +53,8 @@ void codegen_free(CodeGenerator* codegen) {
         string_free(codegen->main_code);
         string_free(codegen->function_definitions);
         string_free(codegen->struct_definitions);
+        string_free(codegen->parallel_declarations);
+        string_free(codegen->parallel_definitions);
         string_free(codegen->includes);
         free(codegen);
     }
@@ -37,53 +63,24 @@ void codegen_free(CodeGenerator* codegen) {
 // Utility functions
 void generate_indent(CodeGenerator* codegen, String* output) {
     for (int i = 0; i < codegen->indent_level; i++) {
-        string_append(output, "    ");
+        string_append_n(output, "    ", 4);
     }
 }
 
-char* c_type_from_pyrinas_type(const char* pyrinas_type) {
-    if (!pyrinas_type) return strdup("void");
-    
-    if (strcmp(pyrinas_type, "int") == 0) return strdup("int");
-    if (strcmp(pyrinas_type, "float") == 0) return strdup("float");
-    if (strcmp(pyrinas_type, "bool") == 0) return strdup("int");
-    if (strcmp(pyrinas_type, "str") == 0) return strdup("char*");
-    if (strcmp(pyrinas_type, "void") == 0) return strdup("void");
-    
-    if (is_pointer_type(pyrinas_type)) {
-        char* base_type = extract_pointer_base_type(pyrinas_type);
-        char* c_base = c_type_from_pyrinas_type(base_type);
-        char* result = malloc(strlen(c_base) + 2);
-        sprintf(result, "%s*", c_base);
-        free(base_type);
-        free(c_base);
-        return result;
-    }
-    
-    if (is_array_type(pyrinas_type)) {
-        char* base_type = NULL;
-        parse_array_type(pyrinas_type, &base_type, NULL);
-        char* c_base = c_type_from_pyrinas_type(base_type);
-        char* result = malloc(strlen(c_base) + 2);
-        sprintf(result, "%s*", c_base);  // Arrays become pointers in function params
-        free(base_type);
-        free(c_base);
-        return result;
-    }
-    
-    if (is_result_type(pyrinas_type)) {
-        return strdup("Result");
-    }
-    
-    // Assume it's a user-defined type (struct/enum)
-    char* result = malloc(strlen(pyrinas_type) + 8);
-    sprintf(result, "struct %s", pyrinas_type);
-    return result;
+const char* c_type_from_pyrinas_type(const Type* pyrinas_type) {
+    if (!pyrinas_type) return "void";
+    return pyrinas_type->c_spelling;
 }
 
 // Main generation function
-char* codegen_generate(CodeGenerator* codegen, ASTNode* ast) {
-    if (!codegen || !ast || ast->type != AST_MODULE) return NULL;
+bool codegen_emit(CodeGenerator* codegen, ASTNode* ast) {
+    if (!codegen || !ast || ast->type != AST_MODULE) return false;
+    
+    // Headers named by @c_include
+    StringArray* c_includes = codegen->semantic_analyzer ? codegen->semantic_analyzer->c_includes : NULL;
+    for (size_t i = 0; c_includes && i < c_includes->count; i++) {
+        string_appendf(codegen->includes, "#include <%s>\n", c_includes->items[i]);
+    }
     
     // Generate struct definitions first
     if (codegen->symbol_table && codegen->symbol_table->global_scope) {
@@ -104,7 +101,10 @@ char* codegen_generate(CodeGenerator* codegen, ASTNode* ast) {
         if (item->type == AST_FUNCTION_DEF) {
             if (strcmp(item->function_def.name, "main") == 0) {
                 // Generate main function
+                codegen->current_function = "main";
+                generate_line_directive(codegen, item, codegen->main_code);
                 string_append(codegen->main_code, "int main() {\n");
+                generate_profile_probe(codegen, item, codegen->main_code);
                 codegen->indent_level = 1;
                 
                 for (size_t j = 0; j < item->function_def.body->count; j++) {
@@ -119,26 +119,160 @@ char* codegen_generate(CodeGenerator* codegen, ASTNode* ast) {
         }
     }
     
-    // Combine all parts
-    String* result = string_new("");
-    string_append(result, string_cstr(codegen->includes));
-    string_append(result, "\n");
+    return true;
+}
+
+// Sections in output order; empty sections are skipped along with their
+// trailing blank line
+static size_t codegen_sections(CodeGenerator* codegen, struct iovec* iov) {
+    String* sections[] = {
+        codegen->includes,
+        codegen->struct_definitions,
+        codegen->parallel_declarations,
+        codegen->function_definitions,
+        codegen->parallel_definitions,
+        codegen->main_code,
+    };
+    static char separator[] = "\n";
+    size_t count = 0;
+    
+    for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); i++) {
+        String* section = sections[i];
+        if (section->length == 0 && i > 0) continue;
+        
+        iov[count].iov_base = section->data;
+        iov[count].iov_len = section->length;
+        count++;
+        
+        if (section != codegen->main_code) {
+            iov[count].iov_base = separator;
+            iov[count].iov_len = 1;
+            count++;
+        }
+    }
+    
+    return count;
+}
+
+char* codegen_generate(CodeGenerator* codegen, ASTNode* ast) {
+    if (!codegen_emit(codegen, ast)) return NULL;
+    
+    struct iovec iov[CODEGEN_MAX_IOV];
+    size_t count = codegen_sections(codegen, iov);
+    
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += iov[i].iov_len;
+    }
+    
+    char* result = malloc(total + 1);
+    if (!result) return NULL;
+    
+    char* cursor = result;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(cursor, iov[i].iov_base, iov[i].iov_len);
+        cursor += iov[i].iov_len;
+    }
+    *cursor = '\0';
+    return result;
+}
+
+bool codegen_write_fd(CodeGenerator* codegen, int fd) {
+    if (!codegen) return false;
+    
+    struct iovec iov[CODEGEN_MAX_IOV];
+    size_t count = codegen_sections(codegen, iov);
+    struct iovec* pending = iov;
     
-    if (string_cstr(codegen->struct_definitions)[0] != '\0') {
-        string_append(result, string_cstr(codegen->struct_definitions));
-        string_append(result, "\n");
+    // writev may stop short; advance past whatever was written and retry
+    while (count > 0) {
+        ssize_t written = writev(fd, pending, (int)count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        
+        while (count > 0 && (size_t)written >= pending->iov_len) {
+            written -= pending->iov_len;
+            pending++;
+            count--;
+        }
+        if (count > 0) {
+            pending->iov_base = (char*)pending->iov_base + written;
+            pending->iov_len -= written;
+        }
     }
     
-    if (string_cstr(codegen->function_definitions)[0] != '\0') {
-        string_append(result, string_cstr(codegen->function_definitions));
-        string_append(result, "\n");
+    return true;
+}
+
+bool codegen_write_file(CodeGenerator* codegen, const char* filename) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create file '%s'\n", filename);
+        return false;
     }
     
-    string_append(result, string_cstr(codegen->main_code));
+    bool success = codegen_write_fd(codegen, fd);
+    if (close(fd) != 0) success = false;
     
-    char* final_result = strdup(string_cstr(result));
-    string_free(result);
-    return final_result;
+    if (!success) {
+        fprintf(stderr, "Error: Failed to write '%s'\n", filename);
+    }
+    return success;
+}
+
+static void write_json_string(FILE* out, const char* value) {
+    fputc('"', out);
+    for (const unsigned char* c = (const unsigned char*)value; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if (*c < 32) {
+            fprintf(out, "\\u%04x", *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+bool codegen_write_line_map(CodeGenerator* codegen, const char* filename, const char* c_file) {
+    FILE* out = fopen(filename, "w");
+    if (!out) {
+        fprintf(stderr, "Error: Cannot create file '%s'\n", filename);
+        return false;
+    }
+    
+    fputs("{\"version\": 1, \"file\": ", out);
+    write_json_string(out, c_file);
+    fputs(", \"sources\": [", out);
+    write_json_string(out, codegen->source_file);
+    fputs("], \"mappings\": [", out);
+    
+    struct iovec iov[CODEGEN_MAX_IOV];
+    size_t count = codegen_sections(codegen, iov);
+    long c_line = 1;
+    bool line_start = true;
+    bool first = true;
+    for (size_t i = 0; i < count; i++) {
+        const char* data = iov[i].iov_base;
+        size_t length = iov[i].iov_len;
+        for (size_t j = 0; j < length; j++) {
+            if (line_start && length - j > 6 && strncmp(data + j, "#line ", 6) == 0) {
+                fprintf(out, "%s[%ld, 0, %d]", first ? "" : ", ", c_line + 1, atoi(data + j + 6));
+                first = false;
+            }
+            line_start = data[j] == '\n';
+            if (line_start) c_line++;
+        }
+    }
+    fputs("]}\n", out);
+    
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Error: Failed to write '%s'\n", filename);
+        return false;
+    }
+    return true;
 }
 
 void generate_struct_definition(CodeGenerator* codegen, Symbol* struct_symbol) {
@@ -147,13 +281,12 @@ void generate_struct_definition(CodeGenerator* codegen, Symbol* struct_symbol) {
     string_append(codegen->struct_definitions, " {\n");
     
     for (size_t i = 0; i < struct_symbol->fields.field_count; i++) {
-        char* c_type = c_type_from_pyrinas_type(struct_symbol->fields.field_types[i]);
+        const char* c_type = c_type_from_pyrinas_type(struct_symbol->fields.field_types[i]);
         string_append(codegen->struct_definitions, "    ");
         string_append(codegen->struct_definitions, c_type);
-        string_append(codegen->struct_definitions, " ");
+        string_append_char(codegen->struct_definitions, ' ');
         string_append(codegen->struct_definitions, struct_symbol->fields.field_names[i]);
         string_append(codegen->struct_definitions, ";\n");
-        free(c_type);
     }
     
     string_append(codegen->struct_definitions, "};\n\n");
@@ -167,34 +300,134 @@ void generate_enum_definition(CodeGenerator* codegen, Symbol* enum_symbol) {
     for (size_t i = 0; i < enum_symbol->enum_members.member_count; i++) {
         string_append(codegen->struct_definitions, "    ");
         string_append(codegen->struct_definitions, enum_symbol->name);
-        string_append(codegen->struct_definitions, "_");
+        string_append_char(codegen->struct_definitions, '_');
         string_append(codegen->struct_definitions, enum_symbol->enum_members.member_names[i]);
         string_append(codegen->struct_definitions, " = ");
         
-        char value_str[32];
-        sprintf(value_str, "%d", enum_symbol->enum_members.member_values[i]);
-        string_append(codegen->struct_definitions, value_str);
+        string_appendf(codegen->struct_definitions, "%d", enum_symbol->enum_members.member_values[i]);
         
         if (i < enum_symbol->enum_members.member_count - 1) {
-            string_append(codegen->struct_definitions, ",");
+            string_append_char(codegen->struct_definitions, ',');
         }
-        string_append(codegen->struct_definitions, "\n");
+        string_append_char(codegen->struct_definitions, '\n');
     }
     
     string_append(codegen->struct_definitions, "};\n\n");
 }
 
+// --profile: enter and exit probes for the function, as its first statement
+static void generate_profile_probe(CodeGenerator* codegen, ASTNode* node, String* output) {
+    if (!codegen->profile) return;
+    string_append(output, "    PYRINAS_PROFILE_FUNCTION(");
+    append_string_literal(output, node->function_def.name);
+    string_append(output, ", ");
+    append_string_literal(output, codegen->source_file);
+    string_appendf(output, ", %d);\n", node->line_no);
+}
+
+// -g: the C that follows comes from node's line; at the start of a line
+static void generate_line_directive(CodeGenerator* codegen, ASTNode* node, String* output) {
+    if (!codegen->line_directives || node->line_no <= 0) return;
+    string_appendf(output, "#line %d ", node->line_no);
+    append_string_literal(output, codegen->source_file);
+    string_append_char(output, '\n');
+}
+
+static bool is_docstring(const ASTNode* node) {
+    return node->type == AST_EXPR_STMT && node->expr_stmt.value->type == AST_CONSTANT &&
+           node->expr_stmt.value->constant.value.type == CONST_STRING;
+}
+
+// Statements in body, nested ones included
+static size_t count_statements(const NodeArray* body) {
+    size_t count = 0;
+    for (size_t i = 0; body && i < body->count; i++) {
+        const ASTNode* node = body->items[i];
+        count++;
+        if (node->type == AST_IF) {
+            count += count_statements(node->if_stmt.body) + count_statements(node->if_stmt.orelse);
+        } else if (node->type == AST_WHILE) {
+            count += count_statements(node->while_stmt.body);
+        } else if (node->type == AST_FOR) {
+            count += count_statements(node->for_stmt.body);
+        }
+    }
+    return count;
+}
+
+static bool block_calls(const NodeArray* nodes, const char* name);
+
+// Whether the statement or expression calls the function named name
+// (an interned pointer)
+static bool calls(const ASTNode* node, const char* name) {
+    if (!node) return false;
+    switch (node->type) {
+        case AST_CALL:
+            return (node->call.func->type == AST_NAME && node->call.func->name.id == name) ||
+                   calls(node->call.func, name) || block_calls(node->call.args, name);
+        case AST_BINOP:
+            return calls(node->binop.left, name) || calls(node->binop.right, name);
+        case AST_UNARYOP:
+            return calls(node->unaryop.operand, name);
+        case AST_COMPARE:
+            return calls(node->compare.left, name) || block_calls(node->compare.comparators, name);
+        case AST_BOOLOP:
+            return block_calls(node->boolop.values, name);
+        case AST_ATTRIBUTE:
+            return calls(node->attribute.value, name);
+        case AST_SUBSCRIPT:
+            return calls(node->subscript.value, name) || calls(node->subscript.slice, name);
+        case AST_ANN_ASSIGN:
+            return calls(node->ann_assign.value, name);
+        case AST_ASSIGN:
+            return block_calls(node->assign.targets, name) || calls(node->assign.value, name);
+        case AST_IF:
+            return calls(node->if_stmt.test, name) || block_calls(node->if_stmt.body, name) ||
+                   block_calls(node->if_stmt.orelse, name);
+        case AST_WHILE:
+            return calls(node->while_stmt.test, name) || block_calls(node->while_stmt.body, name);
+        case AST_FOR:
+            return calls(node->for_stmt.iter, name) || block_calls(node->for_stmt.body, name);
+        case AST_RETURN:
+            return calls(node->return_stmt.value, name);
+        case AST_EXPR_STMT:
+            return calls(node->expr_stmt.value, name);
+        default:
+            return false;
+    }
+}
+
+static bool block_calls(const NodeArray* nodes, const char* name) {
+    for (size_t i = 0; nodes && i < nodes->count; i++) {
+        if (calls(nodes->items[i], name)) return true;
+    }
+    return false;
+}
+
+// @inline functions, and small ones that do not call themselves, are
+// emitted static inline
+static bool is_inline_function(const Symbol* symbol, const ASTNode* node) {
+    const NodeArray* body = node->function_def.body;
+    size_t statements = count_statements(body);
+    if (body->count > 0 && is_docstring(body->items[0])) statements--;
+    return symbol->is_inline ||
+           (statements <= INLINE_MAX_STATEMENTS && !block_calls(body, node->function_def.name));
+}
+
 void generate_function_def(CodeGenerator* codegen, ASTNode* node) {
     if (!node || node->type != AST_FUNCTION_DEF) return;
     
     Symbol* func_symbol = symbol_table_lookup(codegen->symbol_table, node->function_def.name);
-    if (!func_symbol) return;
+    if (!func_symbol || func_symbol->is_c_function) return;
     
-    char* return_type = c_type_from_pyrinas_type(func_symbol->return_type);
+    codegen->current_function = node->function_def.name;
+    generate_line_directive(codegen, node, codegen->function_definitions);
+    if (is_inline_function(func_symbol, node)) string_append(codegen->function_definitions, "static inline ");
+    const char* return_type = c_type_from_pyrinas_type(func_symbol->return_type);
     string_append(codegen->function_definitions, return_type);
-    string_append(codegen->function_definitions, " ");
+    string_append_char(codegen->function_definitions, ' ');
     string_append(codegen->function_definitions, node->function_def.name);
-    string_append(codegen->function_definitions, "(");
+    string_append_char(codegen->function_definitions, '(');
     
     // Generate parameters
     if (node->function_def.args && node->function_def.args->type == AST_ARGUMENTS) {
@@ -205,20 +438,17 @@ void generate_function_def(CodeGenerator* codegen, ASTNode* node) {
             
             ASTNode* arg = args->items[i];
             if (arg->type == AST_ARG) {
-                char* param_type_name = get_type_name(arg->arg.annotation);
-                char* c_param_type = c_type_from_pyrinas_type(param_type_name);
+                const char* c_param_type = c_type_from_pyrinas_type(get_type_name(arg->arg.annotation));
                 
                 string_append(codegen->function_definitions, c_param_type);
-                string_append(codegen->function_definitions, " ");
+                string_append_char(codegen->function_definitions, ' ');
                 string_append(codegen->function_definitions, arg->arg.arg);
-                
-                free(param_type_name);
-                free(c_param_type);
             }
         }
     }
     
     string_append(codegen->function_definitions, ") {\n");
+    generate_profile_probe(codegen, node, codegen->function_definitions);
     
     // Switch output target to function definitions
     String* saved_output = codegen->current_output;
@@ -234,13 +464,17 @@ void generate_function_def(CodeGenerator* codegen, ASTNode* node) {
     codegen->current_output = saved_output;
     
     string_append(codegen->function_definitions, "}\n\n");
-    
-    free(return_type);
 }
 
 void generate_statement(CodeGenerator* codegen, ASTNode* node) {
     if (!node) return;
     
+    // The directive is dropped again if the statement emits nothing
+    String* output = codegen->current_output;
+    size_t start = output->length;
+    generate_line_directive(codegen, node, output);
+    size_t directive_end = output->length;
+    
     switch (node->type) {
         case AST_ANN_ASSIGN:
             generate_ann_assign(codegen, node);
@@ -264,12 +498,12 @@ void generate_statement(CodeGenerator* codegen, ASTNode* node) {
             generate_expr_stmt(codegen, node);
             break;
         case AST_BREAK:
-            generate_indent(codegen, codegen->main_code);
-            string_append(codegen->main_code, "break;\n");
+            generate_indent(codegen, codegen->current_output);
+            string_append(codegen->current_output, "break;\n");
             break;
         case AST_CONTINUE:
-            generate_indent(codegen, codegen->main_code);
-            string_append(codegen->main_code, "continue;\n");
+            generate_indent(codegen, codegen->current_output);
+            string_append(codegen->current_output, "continue;\n");
             break;
         case AST_PASS:
             // No-op
@@ -277,44 +511,62 @@ void generate_statement(CodeGenerator* codegen, ASTNode* node) {
         default:
             break;
     }
+    
+    if (output->length == directive_end) {
+        output->length = start;
+        output->data[start] = '\0';
+    }
+}
+
+// Numeric arrays that fill a vector register are aligned for it: 32 bytes
+// suits AVX2, and arrays of a cache line or more get 64
+static const char* array_alignment(const Type* type) {
+    TypeKind element = type->base ? type->base->kind : TYPE_VOID;
+    if (element != TYPE_INT && element != TYPE_FLOAT) return "";
+    long bytes = 4L * type->size;
+    if (bytes >= 64) return "_Alignas(64) ";
+    if (bytes >= 32) return "_Alignas(32) ";
+    return "";
 }
 
 void generate_ann_assign(CodeGenerator* codegen, ASTNode* node) {
     if (!node || node->type != AST_ANN_ASSIGN) return;
     
     char* var_name = node->ann_assign.target->name.id;
-    char* type_name = get_type_name(node->ann_assign.annotation);
-    char* c_type = c_type_from_pyrinas_type(type_name);
+    const Type* type = get_type_name(node->ann_assign.annotation);
     
-    generate_indent(codegen, codegen->main_code);
-    string_append(codegen->main_code, c_type);
-    string_append(codegen->main_code, " ");
-    string_append(codegen->main_code, var_name);
+    generate_indent(codegen, codegen->current_output);
+    if (type && type->kind == TYPE_ARRAY && type->size > 0) {
+        // Sized local arrays are declared with storage, not as pointers
+        string_appendf(codegen->current_output, "%s%s %s[%d]", array_alignment(type),
+                       c_type_from_pyrinas_type(type->base), var_name, type->size);
+    } else {
+        string_append(codegen->current_output, c_type_from_pyrinas_type(type));
+        string_append_char(codegen->current_output, ' ');
+        string_append(codegen->current_output, var_name);
+    }
     
     if (node->ann_assign.value) {
-        string_append(codegen->main_code, " = ");
-        generate_expression(codegen, node->ann_assign.value, codegen->main_code);
+        string_append(codegen->current_output, " = ");
+        generate_expression(codegen, node->ann_assign.value, codegen->current_output);
     }
     
-    string_append(codegen->main_code, ";\n");
-    
-    free(type_name);
-    free(c_type);
+    string_append(codegen->current_output, ";\n");
 }
 
 void generate_assign(CodeGenerator* codegen, ASTNode* node) {
     if (!node || node->type != AST_ASSIGN) return;
     
-    generate_indent(codegen, codegen->main_code);
+    generate_indent(codegen, codegen->current_output);
     
     // Generate target
     if (node->assign.targets->count > 0) {
-        generate_expression(codegen, node->assign.targets->items[0], codegen->main_code);
+        generate_expression(codegen, node->assign.targets->items[0], codegen->current_output);
     }
     
-    string_append(codegen->main_code, " = ");
-    generate_expression(codegen, node->assign.value, codegen->main_code);
-    string_append(codegen->main_code, ";\n");
+    string_append(codegen->current_output, " = ");
+    generate_expression(codegen, node->assign.value, codegen->current_output);
+    string_append(codegen->current_output, ";\n");
 }
 
 void generate_return(CodeGenerator* codegen, ASTNode* node) {
@@ -324,7 +576,7 @@ void generate_return(CodeGenerator* codegen, ASTNode* node) {
     string_append(codegen->current_output, "return");
     
     if (node->return_stmt.value) {
-        string_append(codegen->current_output, " ");
+        string_append_char(codegen->current_output, ' ');
         generate_expression(codegen, node->return_stmt.value, codegen->current_output);
     }
     
@@ -334,9 +586,9 @@ void generate_return(CodeGenerator* codegen, ASTNode* node) {
 void generate_expr_stmt(CodeGenerator* codegen, ASTNode* node) {
     if (!node || node->type != AST_EXPR_STMT) return;
     
-    generate_indent(codegen, codegen->main_code);
-    generate_expression(codegen, node->expr_stmt.value, codegen->main_code);
-    string_append(codegen->main_code, ";\n");
+    generate_indent(codegen, codegen->current_output);
+    generate_expression(codegen, node->expr_stmt.value, codegen->current_output);
+    string_append(codegen->current_output, ";\n");
 }
 
 void generate_expression(CodeGenerator* codegen, ASTNode* node, String* output) {
@@ -380,26 +632,57 @@ void generate_name(CodeGenerator* codegen, ASTNode* node, String* output) {
     string_append(output, node->name.id);
 }
 
+// Shortest spelling that reads back as the same double, so folded
+// constants keep full precision
+static void append_float_literal(String* output, double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.15g", value);
+    if (strtod(buffer, NULL) != value) {
+        snprintf(buffer, sizeof(buffer), "%.17g", value);
+    }
+    string_append(output, buffer);
+    
+    // Keep it a floating-point literal
+    if (!strpbrk(buffer, ".eE")) {
+        string_append(output, ".0");
+    }
+}
+
+// C literal for a decoded string; bytes outside printable ASCII are escaped
+static void append_string_literal(String* output, const char* value) {
+    string_append_char(output, '"');
+    for (const unsigned char* c = (const unsigned char*)value; *c; c++) {
+        switch (*c) {
+            case '"': string_append(output, "\\\""); break;
+            case '\\': string_append(output, "\\\\"); break;
+            case '\n': string_append(output, "\\n"); break;
+            case '\t': string_append(output, "\\t"); break;
+            case '\r': string_append(output, "\\r"); break;
+            default:
+                if (*c < 32 || *c >= 127) {
+                    string_appendf(output, "\\%03o", *c);
+                } else {
+                    string_append_char(output, (char)*c);
+                }
+        }
+    }
+    string_append_char(output, '"');
+}
+
 void generate_constant(CodeGenerator* codegen, ASTNode* node, String* output) {
     if (!node || node->type != AST_CONSTANT) return;
     
     switch (node->constant.value.type) {
-        case CONST_INT: {
-            char buf[32];
-            sprintf(buf, "%d", node->constant.value.int_val);
-            string_append(output, buf);
+        case CONST_INT:
+            string_appendf(output, "%d", node->constant.value.int_val);
             break;
-        }
-        case CONST_FLOAT: {
-            char buf[32];
-            sprintf(buf, "%f", node->constant.value.float_val);
-            string_append(output, buf);
+        case CONST_FLOAT:
+            append_float_literal(output, node->constant.value.float_val);
             break;
-        }
         case CONST_STRING:
-            string_append(output, "\"");
-            string_append(output, node->constant.value.str_val);
-            string_append(output, "\"");
+            string_append(output, "PYRINAS_STR(");
+            append_string_literal(output, node->constant.value.str_val);
+            string_append_char(output, ')');
             break;
         case CONST_BOOL:
             string_append(output, node->constant.value.bool_val ? "1" : "0");
@@ -413,7 +696,19 @@ void generate_constant(CodeGenerator* codegen, ASTNode* node, String* output) {
 void generate_binop(CodeGenerator* codegen, ASTNode* node, String* output) {
     if (!node || node->type != AST_BINOP) return;
     
-    string_append(output, "(");
+    // // and % round toward negative infinity, as in Python, where C's / and % truncate
+    if (node->binop.op == BINOP_FLOORDIV || node->binop.op == BINOP_MOD) {
+        bool is_float = node->value_type && node->value_type->kind == TYPE_FLOAT;
+        string_append(output, node->binop.op == BINOP_FLOORDIV ? "pyrinas_floordiv" : "pyrinas_mod");
+        string_append(output, is_float ? "_float(" : "(");
+        generate_expression(codegen, node->binop.left, output);
+        string_append(output, ", ");
+        generate_expression(codegen, node->binop.right, output);
+        string_append_char(output, ')');
+        return;
+    }
+    
+    string_append_char(output, '(');
     generate_expression(codegen, node->binop.left, output);
     
     switch (node->binop.op) {
@@ -421,12 +716,32 @@ void generate_binop(CodeGenerator* codegen, ASTNode* node, String* output) {
         case BINOP_SUB: string_append(output, " - "); break;
         case BINOP_MULT: string_append(output, " * "); break;
         case BINOP_DIV: string_append(output, " / "); break;
-        case BINOP_MOD: string_append(output, " % "); break;
-        case BINOP_FLOORDIV: string_append(output, " / "); break;
+        default: break;
     }
     
     generate_expression(codegen, node->binop.right, output);
-    string_append(output, ")");
+    string_append_char(output, ')');
+}
+
+// Runtime output routine for a print argument
+static const char* write_routine(const ASTNode* arg) {
+    const Type* type = arg->value_type;
+    TypeKind kind = type ? type->kind : TYPE_INT;
+    if (!type && arg->type == AST_CONSTANT) {
+        // Nodes created by the optimizer carry no analyzed type
+        switch (arg->constant.value.type) {
+            case CONST_FLOAT: kind = TYPE_FLOAT; break;
+            case CONST_STRING: kind = TYPE_STR; break;
+            default: break;
+        }
+    }
+    
+    switch (kind) {
+        case TYPE_FLOAT: return "pyrinas_write_float";
+        case TYPE_STR: return "pyrinas_write_str";
+        case TYPE_PTR: return "pyrinas_write_ptr";
+        default: return "pyrinas_write_int";  // int, bool (0/1) and enums
+    }
 }
 
 void generate_call(CodeGenerator* codegen, ASTNode* node, String* output) {
@@ -437,101 +752,39 @@ void generate_call(CodeGenerator* codegen, ASTNode* node, String* output) {
         
         // Handle special built-in functions
         if (strcmp(func_name, "print") == 0) {
-            string_append(output, "printf(");
-            
-            if (node->call.args->count > 0) {
-                ASTNode* arg = node->call.args->items[0];
-                
-                // Determine format specifier based on argument type
-                if (arg->type == AST_CONSTANT) {
-                    switch (arg->constant.value.type) {
-                        case CONST_INT:
-                            string_append(output, "\"%d\\n\", ");
-                            break;
-                        case CONST_FLOAT:
-                            string_append(output, "\"%f\\n\", ");
-                            break;
-                        case CONST_STRING:
-                            string_append(output, "\"%s\\n\", ");
-                            break;
-                        case CONST_BOOL:
-                            string_append(output, "\"%d\\n\", ");
-                            break;
-                        default:
-                            string_append(output, "\"%s\\n\", ");
-                            break;
-                    }
-                } else if (arg->type == AST_NAME) {
-                    // Look up the variable's type
-                    Symbol* symbol = symbol_table_lookup(codegen->symbol_table, arg->name.id);
-                    if (symbol && symbol->value_type) {
-                        if (strcmp(symbol->value_type, "float") == 0) {
-                            string_append(output, "\"%f\\n\", ");
-                        } else if (strcmp(symbol->value_type, "str") == 0) {
-                            string_append(output, "\"%s\\n\", ");
-                        } else if (strcmp(symbol->value_type, "bool") == 0) {
-                            string_append(output, "\"%d\\n\", ");
-                        } else {
-                            string_append(output, "\"%d\\n\", ");  // Default to int
-                        }
-                    } else {
-                        string_append(output, "\"%d\\n\", ");  // Default fallback
-                    }
-                } else if (arg->type == AST_ATTRIBUTE) {
-                    // For struct field access, we need to look up the field type
-                    if (arg->attribute.value->type == AST_NAME) {
-                        char* var_name = arg->attribute.value->name.id;
-                        Symbol* struct_symbol = symbol_table_lookup(codegen->symbol_table, var_name);
-                        if (struct_symbol && struct_symbol->value_type) {
-                            // Look up the struct definition
-                            Symbol* type_symbol = symbol_table_lookup(codegen->symbol_table, struct_symbol->value_type);
-                            if (type_symbol && type_symbol->type == SYM_STRUCT) {
-                                // Find the field type
-                                char* field_name = arg->attribute.attr;
-                                for (size_t i = 0; i < type_symbol->fields.field_count; i++) {
-                                    if (strcmp(type_symbol->fields.field_names[i], field_name) == 0) {
-                                        char* field_type = type_symbol->fields.field_types[i];
-                                        if (strcmp(field_type, "float") == 0) {
-                                            string_append(output, "\"%f\\n\", ");
-                                        } else if (strcmp(field_type, "str") == 0) {
-                                            string_append(output, "\"%s\\n\", ");
-                                        } else if (strcmp(field_type, "bool") == 0) {
-                                            string_append(output, "\"%d\\n\", ");
-                                        } else {
-                                            string_append(output, "\"%d\\n\", ");  // Default to int
-                                        }
-                                        goto format_found;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    // Default fallback for attributes
-                    string_append(output, "\"%d\\n\", ");
-                    format_found:;
-                } else {
-                    // Default to %d for other expressions
-                    string_append(output, "\"%d\\n\", ");
-                }
-                
+            // Arguments are space-separated, as in Python
+            for (size_t i = 0; i < node->call.args->count; i++) {
+                ASTNode* arg = node->call.args->items[i];
+                if (i > 0) string_append(output, "pyrinas_write_char(' '), ");
+                string_append(output, write_routine(arg));
+                string_append_char(output, '(');
                 generate_expression(codegen, arg, output);
+                string_append(output, "), ");
             }
-            
-            string_append(output, ")");
+            string_append(output, "pyrinas_write_char('\\n')");
+            return;
+        }
+        
+        if (strcmp(func_name, "flush") == 0) {
+            string_append(output, "pyrinas_flush()");
             return;
         }
     }
     
-    // Regular function call
-    generate_expression(codegen, node->call.func, output);
-    string_append(output, "(");
+    // Regular function call; parallel_for() maps onto the runtime scheduler
+    if (node->call.func->type == AST_NAME && strcmp(node->call.func->name.id, "parallel_for") == 0) {
+        string_append(output, "pyrinas_parallel_for_each");
+    } else {
+        generate_expression(codegen, node->call.func, output);
+    }
+    string_append_char(output, '(');
     
     for (size_t i = 0; i < node->call.args->count; i++) {
         if (i > 0) string_append(output, ", ");
         generate_expression(codegen, node->call.args->items[i], output);
     }
     
-    string_append(output, ")");
+    string_append_char(output, ')');
 }
 
 void generate_attribute(CodeGenerator* codegen, ASTNode* node, String* output) {
@@ -539,7 +792,7 @@ void generate_attribute(CodeGenerator* codegen, ASTNode* node, String* output) {
     
     // Generate the object being accessed
     generate_expression(codegen, node->attribute.value, output);
-    string_append(output, ".");
+    string_append_char(output, '.');
     string_append(output, node->attribute.attr);
 }
 
@@ -548,15 +801,227 @@ void generate_subscript(CodeGenerator* codegen, ASTNode* node, String* output) {
     
     // Generate array[index]
     generate_expression(codegen, node->subscript.value, output);
-    string_append(output, "[");
-    generate_expression(codegen, node->subscript.slice, output);
-    string_append(output, "]");
+    string_append_char(output, '[');
+    
+    const Type* array_type = node->subscript.value->value_type;
+    if (codegen->bounds_check && !node->subscript.in_bounds &&
+        array_type && array_type->kind == TYPE_ARRAY && array_type->size > 0) {
+        string_append(output, "pyrinas_check_index(");
+        generate_expression(codegen, node->subscript.slice, output);
+        string_appendf(output, ", %d)", array_type->size);
+    } else {
+        generate_expression(codegen, node->subscript.slice, output);
+    }
+    string_append_char(output, ']');
 }
 
 // Placeholder implementations for remaining functions
 void generate_if(CodeGenerator* codegen, ASTNode* node) { }
 void generate_while(CodeGenerator* codegen, ASTNode* node) { }
-void generate_for(CodeGenerator* codegen, ASTNode* node) { }
+
+static void collect_block_captures(CodeGenerator* codegen, const NodeArray* nodes,
+                                   const StringArray* private_names, NodeArray* captures);
+
+static bool names_contain(const StringArray* names, const char* name) {
+    for (size_t i = 0; i < names->count; i++) {
+        if (strcmp(names->items[i], name) == 0) return true;
+    }
+    return false;
+}
+
+// Pushes the first use of each local the statement or expression reads
+// that is not one of private_names; called functions are not locals
+static void collect_captures(CodeGenerator* codegen, const ASTNode* node,
+                             const StringArray* private_names, NodeArray* captures) {
+    if (!node) return;
+    switch (node->type) {
+        case AST_NAME:
+            if (!node->value_type || names_contain(private_names, node->name.id) ||
+                scope_lookup(codegen->symbol_table->global_scope, node->name.id)) {
+                return;
+            }
+            for (size_t i = 0; i < captures->count; i++) {
+                if (strcmp(captures->items[i]->name.id, node->name.id) == 0) return;
+            }
+            node_array_push(captures, (ASTNode*)node);
+            return;
+        case AST_CALL:
+            if (node->call.func->type == AST_ATTRIBUTE) {
+                collect_captures(codegen, node->call.func->attribute.value, private_names, captures);
+            }
+            collect_block_captures(codegen, node->call.args, private_names, captures);
+            return;
+        case AST_BINOP:
+            collect_captures(codegen, node->binop.left, private_names, captures);
+            collect_captures(codegen, node->binop.right, private_names, captures);
+            return;
+        case AST_UNARYOP:
+            collect_captures(codegen, node->unaryop.operand, private_names, captures);
+            return;
+        case AST_COMPARE:
+            collect_captures(codegen, node->compare.left, private_names, captures);
+            collect_block_captures(codegen, node->compare.comparators, private_names, captures);
+            return;
+        case AST_BOOLOP:
+            collect_block_captures(codegen, node->boolop.values, private_names, captures);
+            return;
+        case AST_ATTRIBUTE:
+            collect_captures(codegen, node->attribute.value, private_names, captures);
+            return;
+        case AST_SUBSCRIPT:
+            collect_captures(codegen, node->subscript.value, private_names, captures);
+            collect_captures(codegen, node->subscript.slice, private_names, captures);
+            return;
+        case AST_TUPLE:
+            collect_block_captures(codegen, node->tuple.elts, private_names, captures);
+            return;
+        case AST_ANN_ASSIGN:
+            collect_captures(codegen, node->ann_assign.value, private_names, captures);
+            return;
+        case AST_ASSIGN:
+            collect_block_captures(codegen, node->assign.targets, private_names, captures);
+            collect_captures(codegen, node->assign.value, private_names, captures);
+            return;
+        case AST_IF:
+            collect_captures(codegen, node->if_stmt.test, private_names, captures);
+            collect_block_captures(codegen, node->if_stmt.body, private_names, captures);
+            collect_block_captures(codegen, node->if_stmt.orelse, private_names, captures);
+            return;
+        case AST_WHILE:
+            collect_captures(codegen, node->while_stmt.test, private_names, captures);
+            collect_block_captures(codegen, node->while_stmt.body, private_names, captures);
+            return;
+        case AST_FOR:
+            collect_captures(codegen, node->for_stmt.iter, private_names, captures);
+            collect_block_captures(codegen, node->for_stmt.body, private_names, captures);
+            return;
+        case AST_RETURN:
+            collect_captures(codegen, node->return_stmt.value, private_names, captures);
+            return;
+        case AST_EXPR_STMT:
+            collect_captures(codegen, node->expr_stmt.value, private_names, captures);
+            return;
+        default:
+            return;
+    }
+}
+
+static void collect_block_captures(CodeGenerator* codegen, const NodeArray* nodes,
+                                   const StringArray* private_names, NodeArray* captures) {
+    for (size_t i = 0; nodes && i < nodes->count; i++) {
+        collect_captures(codegen, nodes->items[i], private_names, captures);
+    }
+}
+
+// A captured array is passed as a pointer to its elements
+static void append_capture_type(String* output, const Type* type) {
+    if (type->kind == TYPE_ARRAY) {
+        string_appendf(output, "%s*", c_type_from_pyrinas_type(type->base));
+    } else {
+        string_append(output, c_type_from_pyrinas_type(type));
+    }
+}
+
+// A prange loop runs on the runtime's task scheduler, like parallel_for():
+// its body becomes a chunk function that pyrinas_parallel_for calls on
+// disjoint ranges of iterations. The locals the body reads are copied into
+// a context block; semantic analysis has checked that it writes no others.
+static void generate_parallel_for(CodeGenerator* codegen, ASTNode* node) {
+    const char* loop_var = node->for_stmt.target->name.id;
+    ASTNode* limit = node->for_stmt.iter->call.args->items[0];
+    char name[256];
+    snprintf(name, sizeof(name), "%s_prange_%d", codegen->current_function, codegen->parallel_loops++);
+    
+    StringArray* private_names = string_array_new();
+    string_array_push(private_names, loop_var);
+    collect_private_names(node->for_stmt.body, private_names);
+    NodeArray* captures = node_array_new();
+    collect_block_captures(codegen, node->for_stmt.body, private_names, captures);
+    
+    String* declarations = codegen->parallel_declarations;
+    if (captures->count > 0) {
+        string_appendf(declarations, "struct %s {\n", name);
+        for (size_t i = 0; i < captures->count; i++) {
+            string_append(declarations, "    ");
+            append_capture_type(declarations, captures->items[i]->value_type);
+            string_appendf(declarations, " %s;\n", captures->items[i]->name.id);
+        }
+        string_append(declarations, "};\n");
+    }
+    string_appendf(declarations, "static void %s_range(int pyrinas_begin, int pyrinas_end, void* pyrinas_data);\n\n", name);
+    
+    // The chunk is built apart: loops nested in the body add their own chunks first
+    String* chunk = string_new("");
+    string_appendf(chunk, "static void %s_range(int pyrinas_begin, int pyrinas_end, void* pyrinas_data) {\n", name);
+    if (captures->count > 0) {
+        string_appendf(chunk, "    struct %s* pyrinas_loop = pyrinas_data;\n", name);
+        for (size_t i = 0; i < captures->count; i++) {
+            string_append(chunk, "    ");
+            append_capture_type(chunk, captures->items[i]->value_type);
+            string_appendf(chunk, " %s = pyrinas_loop->%s;\n", captures->items[i]->name.id, captures->items[i]->name.id);
+        }
+    } else {
+        string_append(chunk, "    (void)pyrinas_data;\n");
+    }
+    string_appendf(chunk, "    for (int %s = pyrinas_begin; %s < pyrinas_end; %s++) {\n", loop_var, loop_var, loop_var);
+    
+    String* saved_output = codegen->current_output;
+    int saved_indent = codegen->indent_level;
+    codegen->current_output = chunk;
+    codegen->indent_level = 2;
+    for (size_t i = 0; i < node->for_stmt.body->count; i++) {
+        generate_statement(codegen, node->for_stmt.body->items[i]);
+    }
+    codegen->current_output = saved_output;
+    codegen->indent_level = saved_indent;
+    
+    string_append(chunk, "    }\n}\n\n");
+    string_append_n(codegen->parallel_definitions, chunk->data, chunk->length);
+    string_free(chunk);
+    
+    generate_indent(codegen, codegen->current_output);
+    string_append(codegen->current_output, "pyrinas_parallel_for(0, ");
+    generate_expression(codegen, limit, codegen->current_output);
+    string_appendf(codegen->current_output, ", 0, %s_range, ", name);
+    if (captures->count > 0) {
+        string_appendf(codegen->current_output, "&(struct %s){ ", name);
+        for (size_t i = 0; i < captures->count; i++) {
+            if (i > 0) string_append(codegen->current_output, ", ");
+            string_appendf(codegen->current_output, ".%s = %s", captures->items[i]->name.id, captures->items[i]->name.id);
+        }
+        string_append(codegen->current_output, " }");
+    } else {
+        string_append(codegen->current_output, "NULL");
+    }
+    string_append(codegen->current_output, ");\n");
+}
+
+void generate_for(CodeGenerator* codegen, ASTNode* node) {
+    if (!node || node->type != AST_FOR) return;
+    
+    const char* loop_var = node->for_stmt.target->name.id;
+    ASTNode* limit = node->for_stmt.iter->call.args->items[0];
+    
+    if (is_parallel_for(node)) {
+        generate_parallel_for(codegen, node);
+        return;
+    }
+    
+    generate_indent(codegen, codegen->current_output);
+    string_appendf(codegen->current_output, "for (int %s = 0; %s < ", loop_var, loop_var);
+    generate_expression(codegen, limit, codegen->current_output);
+    string_appendf(codegen->current_output, "; %s++) {\n", loop_var);
+    
+    codegen->indent_level++;
+    for (size_t i = 0; i < node->for_stmt.body->count; i++) {
+        generate_statement(codegen, node->for_stmt.body->items[i]);
+    }
+    codegen->indent_level--;
+    
+    generate_indent(codegen, codegen->current_output);
+    string_append(codegen->current_output, "}\n");
+}
+
 void generate_unaryop(CodeGenerator* codegen, ASTNode* node, String* output) { }
 void generate_compare(CodeGenerator* codegen, ASTNode* node, String* output) {
     if (!node || node->type != AST_COMPARE) return;
@@ -566,12 +1031,12 @@ void generate_compare(CodeGenerator* codegen, ASTNode* node, String* output) {
     
     // For simple comparisons, assume single operator and comparator
     if (node->compare.comparators && node->compare.comparators->count > 0) {
-        string_append(output, " ");
+        string_append_char(output, ' ');
         
         // For now, use a simple mapping - we need to check the actual structure
         string_append(output, "==");  // Default operator
         
-        string_append(output, " ");
+        string_append_char(output, ' ');
         generate_expression(codegen, node->compare.comparators->items[0], output);
     }
 }
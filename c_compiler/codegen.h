@@ -8,19 +8,38 @@ typedef struct {
     String* main_code;
     String* function_definitions;
     String* struct_definitions;
+    String* parallel_declarations;  // Context blocks and prototypes of prange chunks
+    String* parallel_definitions;   // prange chunks, after the functions they call
     String* includes;
     String* current_output;  // Points to the current target for statement generation
     SymbolTable* symbol_table;
     SemanticAnalyzer* semantic_analyzer;
     int indent_level;
+    const char* current_function;  // Names the prange chunks of its loops
+    int parallel_loops;            // prange loops generated so far
+    bool bounds_check;  // --bounds-check: check array indices not proven in range
+    bool profile;       // --profile: time every function in the runtime profiler
+    bool line_directives;     // -g: #line directives pointing back at the source
+    const char* source_file;  // Named by --profile sites and #line directives
 } CodeGenerator;
 
 // Code generator management
 CodeGenerator* codegen_new(SymbolTable* symbol_table, SemanticAnalyzer* analyzer);
 void codegen_free(CodeGenerator* codegen);
 
-// Main generation function
+// Main generation function. codegen_emit() fills the output sections;
+// codegen_write_fd()/codegen_write_file() stream them without building one
+// combined buffer, while codegen_generate() returns a malloc'd copy.
+bool codegen_emit(CodeGenerator* codegen, ASTNode* ast);
 char* codegen_generate(CodeGenerator* codegen, ASTNode* ast);
+bool codegen_write_fd(CodeGenerator* codegen, int fd);
+bool codegen_write_file(CodeGenerator* codegen, const char* filename);
+
+// Writes the JSON map from lines of c_file, as codegen_write_file wrote it,
+// to source lines: {"file": ..., "sources": [...], "mappings": [[c_line,
+// source, line], ...]}, one entry per #line directive, for the C line
+// after it. C lines without an entry belong to the entry before them.
+bool codegen_write_line_map(CodeGenerator* codegen, const char* filename, const char* c_file);
 
 // Statement generation
 void generate_statement(CodeGenerator* codegen, ASTNode* node);
@@ -48,7 +67,7 @@ void generate_subscript(CodeGenerator* codegen, ASTNode* node, String* output);
 
 // Utility functions
 void generate_indent(CodeGenerator* codegen, String* output);
-char* c_type_from_pyrinas_type(const char* pyrinas_type);
+const char* c_type_from_pyrinas_type(const Type* pyrinas_type);
 void generate_struct_definition(CodeGenerator* codegen, Symbol* struct_symbol);
 void generate_enum_definition(CodeGenerator* codegen, Symbol* enum_symbol);
 
@@ -0,0 +1,637 @@
+#include "comptime.h"
+#include "optimize.h"
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+
+// Evaluation stops with an error after this many statements
+#define COMPTIME_STEP_LIMIT 10000000
+#define COMPTIME_MAX_DEPTH 256
+
+// float and double stay apart so mixed expressions promote as in C
+typedef enum {
+    VALUE_INT,     // int and bool
+    VALUE_FLOAT,   // C float: always representable in single precision
+    VALUE_DOUBLE   // Float literals and libm results
+} ValueKind;
+
+typedef struct {
+    ValueKind kind;
+    long long i;
+    double f;
+} Value;
+
+typedef struct {
+    const char* name;
+    TypeKind type;
+    Value value;
+} Local;
+
+typedef struct {
+    Local* locals;
+    size_t count;
+    size_t capacity;
+} Frame;
+
+typedef enum {
+    FLOW_NEXT,
+    FLOW_BREAK,
+    FLOW_CONTINUE,
+    FLOW_RETURN,
+    FLOW_ERROR
+} Flow;
+
+typedef struct {
+    SemanticAnalyzer* analyzer;
+    size_t steps;
+    int depth;
+    bool failed;
+    Value result;  // Set by a return statement
+} Interpreter;
+
+static Value eval(Interpreter* interp, Frame* frame, ASTNode* node);
+static Flow exec_block(Interpreter* interp, Frame* frame, NodeArray* body);
+
+static void fail(Interpreter* interp, const char* format, ...) {
+    if (interp->failed) return;
+
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    semantic_error(interp->analyzer, message);
+    interp->failed = true;
+}
+
+static Value int_value(long long i) {
+    Value value = {VALUE_INT, i, 0.0};
+    return value;
+}
+
+static Value float_value(ValueKind kind, double f) {
+    Value value = {kind, 0, f};
+    return value;
+}
+
+static double as_double(Value value) {
+    return value.kind == VALUE_INT ? (double)value.i : value.f;
+}
+
+static bool truthy(Value value) {
+    return value.kind == VALUE_INT ? value.i != 0 : value.f != 0.0;
+}
+
+// Rounds to single precision like a store to a C float
+static Value to_float(Interpreter* interp, Value value) {
+    float f = (float)as_double(value);
+    if (isinf(f) && !isinf(as_double(value))) fail(interp, "float overflow in compile-time evaluation");
+    return float_value(VALUE_FLOAT, f);
+}
+
+// C conversion on assignment to a variable of the given type
+static Value convert(Interpreter* interp, Value value, TypeKind type) {
+    switch (type) {
+        case TYPE_FLOAT:
+            return to_float(interp, value);
+        case TYPE_BOOL:
+            return int_value(truthy(value));
+        default:
+            if (value.kind != VALUE_INT) {
+                double truncated = trunc(value.f);
+                if (!(truncated >= INT_MIN && truncated <= INT_MAX)) {
+                    fail(interp, "%g does not fit in int", value.f);
+                    return int_value(0);
+                }
+                return int_value((long long)truncated);
+            }
+            return value;
+    }
+}
+
+static bool is_scalar(const Type* type) {
+    return type && (type->kind == TYPE_INT || type->kind == TYPE_FLOAT || type->kind == TYPE_BOOL);
+}
+
+static Local* frame_lookup(Frame* frame, const char* name) {
+    for (size_t i = 0; i < frame->count; i++) {
+        if (strcmp(frame->locals[i].name, name) == 0) return &frame->locals[i];
+    }
+    return NULL;
+}
+
+static bool frame_set(Interpreter* interp, Frame* frame, const char* name, TypeKind type, Value value) {
+    Local* local = frame_lookup(frame, name);
+    if (!local) {
+        if (frame->count == frame->capacity) {
+            size_t capacity = frame->capacity ? frame->capacity * 2 : 8;
+            Local* locals = realloc(frame->locals, capacity * sizeof(Local));
+            if (!locals) {
+                fail(interp, "out of memory in compile-time evaluation");
+                return false;
+            }
+            frame->locals = locals;
+            frame->capacity = capacity;
+        }
+        local = &frame->locals[frame->count++];
+        local->name = name;
+    }
+    local->type = type;
+    local->value = convert(interp, value, type);
+    return !interp->failed;
+}
+
+// Usual arithmetic conversions: int meets float as float, any double wins
+static ValueKind promoted_kind(Value left, Value right) {
+    if (left.kind == VALUE_DOUBLE || right.kind == VALUE_DOUBLE) return VALUE_DOUBLE;
+    if (left.kind == VALUE_FLOAT || right.kind == VALUE_FLOAT) return VALUE_FLOAT;
+    return VALUE_INT;
+}
+
+static Value arithmetic(Interpreter* interp, BinOpType op, Value left, Value right) {
+    ValueKind kind = promoted_kind(left, right);
+
+    if (kind != VALUE_INT) {
+        double a = kind == VALUE_FLOAT ? (float)as_double(left) : as_double(left);
+        double b = kind == VALUE_FLOAT ? (float)as_double(right) : as_double(right);
+        double result;
+        switch (op) {
+            case BINOP_ADD: result = a + b; break;
+            case BINOP_SUB: result = a - b; break;
+            case BINOP_MULT: result = a * b; break;
+            default: {
+                if (b == 0.0) {
+                    fail(interp, "float division by zero in compile-time evaluation");
+                    return int_value(0);
+                }
+                double div, mod;
+                float_divmod(a, b, &div, &mod);
+                result = op == BINOP_DIV ? a / b : op == BINOP_MOD ? mod : div;
+                break;
+            }
+        }
+        return kind == VALUE_FLOAT ? to_float(interp, float_value(kind, result)) : float_value(kind, result);
+    }
+
+    long long a = left.i;
+    long long b = right.i;
+    long long result;
+    switch (op) {
+        case BINOP_ADD: result = a + b; break;
+        case BINOP_SUB: result = a - b; break;
+        case BINOP_MULT: result = a * b; break;
+        default:
+            if (b == 0) {
+                fail(interp, "integer division by zero in compile-time evaluation");
+                return int_value(0);
+            }
+            // int / int is emitted as C integer division, which truncates
+            if (op == BINOP_DIV) result = a / b;
+            else result = op == BINOP_MOD ? int_mod(a, b) : int_floordiv(a, b);
+            break;
+    }
+    if (result < INT_MIN || result > INT_MAX) {
+        fail(interp, "integer overflow in compile-time evaluation (%lld)", result);
+        return int_value(0);
+    }
+    return int_value(result);
+}
+
+static bool compare(CompareOpType op, Value left, Value right) {
+    ValueKind kind = promoted_kind(left, right);
+    if (kind == VALUE_INT) {
+        long long a = left.i, b = right.i;
+        switch (op) {
+            case CMP_EQ: return a == b;
+            case CMP_NOTEQ: return a != b;
+            case CMP_LT: return a < b;
+            case CMP_LTE: return a <= b;
+            case CMP_GT: return a > b;
+            case CMP_GTE: return a >= b;
+        }
+        return false;
+    }
+
+    double a = kind == VALUE_FLOAT ? (float)as_double(left) : as_double(left);
+    double b = kind == VALUE_FLOAT ? (float)as_double(right) : as_double(right);
+    switch (op) {
+        case CMP_EQ: return a == b;
+        case CMP_NOTEQ: return a != b;
+        case CMP_LT: return a < b;
+        case CMP_LTE: return a <= b;
+        case CMP_GT: return a > b;
+        case CMP_GTE: return a >= b;
+    }
+    return false;
+}
+
+// @c_function declarations the interpreter evaluates with the C library
+typedef struct {
+    const char* name;
+    double (*unary)(double);
+    double (*binary)(double, double);
+} LibmFunction;
+
+static const LibmFunction libm_functions[] = {
+    {"sqrt", sqrt, NULL}, {"sin", sin, NULL}, {"cos", cos, NULL}, {"tan", tan, NULL},
+    {"exp", exp, NULL}, {"log", log, NULL}, {"fabs", fabs, NULL}, {"floor", floor, NULL},
+    {"ceil", ceil, NULL}, {"pow", NULL, pow}, {"atan2", NULL, atan2},
+};
+
+static const LibmFunction* find_libm(const char* name) {
+    for (size_t i = 0; i < sizeof(libm_functions) / sizeof(libm_functions[0]); i++) {
+        if (strcmp(libm_functions[i].name, name) == 0) return &libm_functions[i];
+    }
+    return NULL;
+}
+
+static Value call_function(Interpreter* interp, Symbol* function, const Value* args, size_t count) {
+    ASTNode* definition = function->definition;
+    if (++interp->depth > COMPTIME_MAX_DEPTH) {
+        fail(interp, "'%s' recurses too deeply for compile-time evaluation", function->name);
+        return int_value(0);
+    }
+
+    Frame frame = {NULL, 0, 0};
+    NodeArray* params = definition->function_def.args->arguments.args;
+    for (size_t i = 0; i < count && i < params->count; i++) {
+        frame_set(interp, &frame, params->items[i]->arg.arg, function->param_types->items[i]->kind, args[i]);
+    }
+
+    Value result = int_value(0);
+    Flow flow = interp->failed ? FLOW_ERROR : exec_block(interp, &frame, definition->function_def.body);
+    if (flow == FLOW_RETURN) {
+        result = convert(interp, interp->result, function->return_type->kind);
+    } else if (flow != FLOW_ERROR) {
+        fail(interp, "'%s' reached the end of its body without returning a value", function->name);
+    }
+
+    free(frame.locals);
+    interp->depth--;
+    return result;
+}
+
+static Value eval_call(Interpreter* interp, Frame* frame, ASTNode* node) {
+    const char* name = node->call.func->name.id;
+    NodeArray* args = node->call.args;
+
+    Value values[8];
+    if (args->count > sizeof(values) / sizeof(values[0])) {
+        fail(interp, "too many arguments for compile-time evaluation of '%s'", name);
+        return int_value(0);
+    }
+    for (size_t i = 0; i < args->count; i++) {
+        values[i] = eval(interp, frame, args->items[i]);
+        if (interp->failed) return int_value(0);
+    }
+
+    Symbol* symbol = symbol_table_lookup(interp->analyzer->symbol_table, name);
+    if (symbol && symbol->is_comptime) {
+        return call_function(interp, symbol, values, args->count);
+    }
+
+    const LibmFunction* libm = find_libm(name);
+    if (!libm) {
+        fail(interp, "'%s' cannot run at compile time", name);
+        return int_value(0);
+    }
+    double result = libm->unary ? libm->unary(as_double(values[0]))
+                                : libm->binary(as_double(values[0]), as_double(values[1]));
+    if (!isfinite(result)) {
+        fail(interp, "%s() has no finite result at compile time", name);
+        return int_value(0);
+    }
+    return float_value(VALUE_DOUBLE, result);
+}
+
+static Value eval(Interpreter* interp, Frame* frame, ASTNode* node) {
+    switch (node->type) {
+        case AST_CONSTANT:
+            switch (node->constant.value.type) {
+                case CONST_INT: return int_value(node->constant.value.int_val);
+                case CONST_BOOL: return int_value(node->constant.value.bool_val);
+                case CONST_FLOAT: return float_value(VALUE_DOUBLE, node->constant.value.float_val);
+                default: break;
+            }
+            break;
+        case AST_NAME: {
+            Local* local = frame_lookup(frame, node->name.id);
+            if (local) return local->value;
+            fail(interp, "'%s' has no value at compile time", node->name.id);
+            return int_value(0);
+        }
+        case AST_BINOP: {
+            Value left = eval(interp, frame, node->binop.left);
+            Value right = eval(interp, frame, node->binop.right);
+            return interp->failed ? int_value(0) : arithmetic(interp, node->binop.op, left, right);
+        }
+        case AST_UNARYOP: {
+            Value operand = eval(interp, frame, node->unaryop.operand);
+            if (node->unaryop.op == UNARYOP_NOT) return int_value(!truthy(operand));
+            if (node->unaryop.op == UNARYOP_UADD) return operand;
+            if (operand.kind != VALUE_INT) return float_value(operand.kind, -operand.f);
+            return arithmetic(interp, BINOP_SUB, int_value(0), operand);
+        }
+        case AST_COMPARE: {
+            // Chained comparisons: a < b < c is (a < b) and (b < c)
+            Value left = eval(interp, frame, node->compare.left);
+            for (size_t i = 0; i < node->compare.comparators->count; i++) {
+                Value right = eval(interp, frame, node->compare.comparators->items[i]);
+                if (interp->failed || !compare(node->compare.ops[i], left, right)) return int_value(0);
+                left = right;
+            }
+            return int_value(1);
+        }
+        case AST_BOOLOP: {
+            // Emitted as && and ||, which yield 0 or 1
+            bool decides_on = node->boolop.op == BOOLOP_OR;
+            for (size_t i = 0; i < node->boolop.values->count; i++) {
+                Value value = eval(interp, frame, node->boolop.values->items[i]);
+                if (interp->failed) return int_value(0);
+                if (truthy(value) == decides_on) return int_value(decides_on);
+            }
+            return int_value(!decides_on);
+        }
+        case AST_CALL:
+            return eval_call(interp, frame, node);
+        default:
+            break;
+    }
+    fail(interp, "expression cannot be evaluated at compile time");
+    return int_value(0);
+}
+
+static Flow exec_statement(Interpreter* interp, Frame* frame, ASTNode* node) {
+    if (++interp->steps > COMPTIME_STEP_LIMIT) {
+        fail(interp, "compile-time evaluation did not finish within %d steps", COMPTIME_STEP_LIMIT);
+        return FLOW_ERROR;
+    }
+
+    switch (node->type) {
+        case AST_ANN_ASSIGN: {
+            Value value = node->ann_assign.value ? eval(interp, frame, node->ann_assign.value) : int_value(0);
+            if (interp->failed) return FLOW_ERROR;
+            TypeKind type = get_type_name(node->ann_assign.annotation)->kind;
+            return frame_set(interp, frame, node->ann_assign.target->name.id, type, value) ? FLOW_NEXT : FLOW_ERROR;
+        }
+        case AST_ASSIGN: {
+            ASTNode* target = node->assign.targets->items[0];
+            Value value = eval(interp, frame, node->assign.value);
+            if (interp->failed) return FLOW_ERROR;
+            // Undeclared names take the type of their first value
+            Local* local = frame_lookup(frame, target->name.id);
+            TypeKind type = local ? local->type : value.kind == VALUE_INT ? TYPE_INT : TYPE_FLOAT;
+            return frame_set(interp, frame, target->name.id, type, value) ? FLOW_NEXT : FLOW_ERROR;
+        }
+        case AST_IF: {
+            Value test = eval(interp, frame, node->if_stmt.test);
+            if (interp->failed) return FLOW_ERROR;
+            NodeArray* taken = truthy(test) ? node->if_stmt.body : node->if_stmt.orelse;
+            return taken ? exec_block(interp, frame, taken) : FLOW_NEXT;
+        }
+        case AST_WHILE:
+            for (;;) {
+                Value test = eval(interp, frame, node->while_stmt.test);
+                if (interp->failed) return FLOW_ERROR;
+                if (!truthy(test)) return FLOW_NEXT;
+
+                Flow flow = exec_block(interp, frame, node->while_stmt.body);
+                if (flow == FLOW_BREAK) return FLOW_NEXT;
+                if (flow == FLOW_RETURN || flow == FLOW_ERROR) return flow;
+                if (++interp->steps > COMPTIME_STEP_LIMIT) {
+                    fail(interp, "compile-time evaluation did not finish within %d steps", COMPTIME_STEP_LIMIT);
+                    return FLOW_ERROR;
+                }
+            }
+        case AST_FOR: {
+            Value limit = eval(interp, frame, node->for_stmt.iter->call.args->items[0]);
+            if (interp->failed) return FLOW_ERROR;
+            for (long long i = 0; i < limit.i; i++) {
+                if (!frame_set(interp, frame, node->for_stmt.target->name.id, TYPE_INT, int_value(i))) {
+                    return FLOW_ERROR;
+                }
+                Flow flow = exec_block(interp, frame, node->for_stmt.body);
+                if (flow == FLOW_BREAK) break;
+                if (flow == FLOW_RETURN || flow == FLOW_ERROR) return flow;
+            }
+            return FLOW_NEXT;
+        }
+        case AST_BREAK:
+            return FLOW_BREAK;
+        case AST_CONTINUE:
+            return FLOW_CONTINUE;
+        case AST_RETURN:
+            interp->result = eval(interp, frame, node->return_stmt.value);
+            return interp->failed ? FLOW_ERROR : FLOW_RETURN;
+        case AST_EXPR_STMT:
+        case AST_PASS:
+            // Docstrings
+            return FLOW_NEXT;
+        default:
+            fail(interp, "statement cannot be evaluated at compile time");
+            return FLOW_ERROR;
+    }
+}
+
+static Flow exec_block(Interpreter* interp, Frame* frame, NodeArray* body) {
+    for (size_t i = 0; i < body->count; i++) {
+        Flow flow = exec_statement(interp, frame, body->items[i]);
+        if (flow != FLOW_NEXT) return flow;
+    }
+    return FLOW_NEXT;
+}
+
+// Static check
+
+static bool check_expression(SemanticAnalyzer* analyzer, const char* function, ASTNode* node);
+
+static bool check_fail(SemanticAnalyzer* analyzer, const char* function, const char* problem) {
+    char message[256];
+    snprintf(message, sizeof(message), "@comptime function '%s' %s", function, problem);
+    semantic_error(analyzer, message);
+    return false;
+}
+
+static bool check_array(SemanticAnalyzer* analyzer, const char* function, NodeArray* nodes) {
+    for (size_t i = 0; nodes && i < nodes->count; i++) {
+        if (!check_expression(analyzer, function, nodes->items[i])) return false;
+    }
+    return true;
+}
+
+static bool check_expression(SemanticAnalyzer* analyzer, const char* function, ASTNode* node) {
+    switch (node->type) {
+        case AST_CONSTANT:
+            if (node->constant.value.type == CONST_STRING || node->constant.value.type == CONST_NONE) {
+                return check_fail(analyzer, function, "may only use int, float and bool values");
+            }
+            return true;
+        case AST_NAME:
+            return true;
+        case AST_BINOP:
+            return check_expression(analyzer, function, node->binop.left) &&
+                   check_expression(analyzer, function, node->binop.right);
+        case AST_UNARYOP:
+            return check_expression(analyzer, function, node->unaryop.operand);
+        case AST_COMPARE:
+            return check_expression(analyzer, function, node->compare.left) &&
+                   check_array(analyzer, function, node->compare.comparators);
+        case AST_BOOLOP:
+            return check_array(analyzer, function, node->boolop.values);
+        case AST_CALL: {
+            if (node->call.func->type != AST_NAME) break;
+            const char* callee = node->call.func->name.id;
+            Symbol* symbol = symbol_table_lookup(analyzer->symbol_table, callee);
+            const LibmFunction* libm = find_libm(callee);
+            bool callable = symbol && symbol->type == SYM_FUNCTION &&
+                            (symbol->is_comptime || (symbol->is_c_function && libm));
+            if (!callable) {
+                char problem[160];
+                snprintf(problem, sizeof(problem), "calls '%s', which cannot run at compile time", callee);
+                return check_fail(analyzer, function, problem);
+            }
+            if (libm && !symbol->is_comptime && node->call.args->count != (libm->unary ? 1u : 2u)) {
+                return check_fail(analyzer, function, "calls a libm function with the wrong number of arguments");
+            }
+            return check_array(analyzer, function, node->call.args);
+        }
+        default:
+            break;
+    }
+    return check_fail(analyzer, function, "uses an expression that cannot run at compile time");
+}
+
+static bool check_block(SemanticAnalyzer* analyzer, const char* function, NodeArray* body) {
+    for (size_t i = 0; body && i < body->count; i++) {
+        ASTNode* node = body->items[i];
+        bool ok;
+        switch (node->type) {
+            case AST_ANN_ASSIGN:
+                if (!is_scalar(get_type_name(node->ann_assign.annotation))) {
+                    return check_fail(analyzer, function, "may only declare int, float and bool locals");
+                }
+                ok = !node->ann_assign.value || check_expression(analyzer, function, node->ann_assign.value);
+                break;
+            case AST_ASSIGN:
+                if (node->assign.targets->count != 1 || node->assign.targets->items[0]->type != AST_NAME) {
+                    return check_fail(analyzer, function, "may only assign to local variables");
+                }
+                ok = check_expression(analyzer, function, node->assign.value);
+                break;
+            case AST_IF:
+                ok = check_expression(analyzer, function, node->if_stmt.test) &&
+                     check_block(analyzer, function, node->if_stmt.body) &&
+                     check_block(analyzer, function, node->if_stmt.orelse);
+                break;
+            case AST_WHILE:
+                ok = check_expression(analyzer, function, node->while_stmt.test) &&
+                     check_block(analyzer, function, node->while_stmt.body);
+                break;
+            case AST_FOR: {
+                ASTNode* iter = node->for_stmt.iter;
+                if (iter->type != AST_CALL || iter->call.func->type != AST_NAME ||
+                    strcmp(iter->call.func->name.id, "range") != 0 || iter->call.args->count != 1 ||
+                    node->for_stmt.target->type != AST_NAME) {
+                    return check_fail(analyzer, function, "may only loop over range()");
+                }
+                ok = check_expression(analyzer, function, iter->call.args->items[0]) &&
+                     check_block(analyzer, function, node->for_stmt.body);
+                break;
+            }
+            case AST_BREAK:
+            case AST_CONTINUE:
+                ok = !node->break_continue.label ||
+                     check_fail(analyzer, function, "may not use labeled break or continue");
+                break;
+            case AST_RETURN:
+                ok = node->return_stmt.value ? check_expression(analyzer, function, node->return_stmt.value)
+                                             : check_fail(analyzer, function, "must return a value");
+                break;
+            case AST_EXPR_STMT:
+                ok = node->expr_stmt.value->type == AST_CONSTANT ||
+                     check_fail(analyzer, function, "may not call functions for their effects");
+                break;
+            case AST_PASS:
+                ok = true;
+                break;
+            default:
+                return check_fail(analyzer, function, "uses a statement that cannot run at compile time");
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+bool comptime_check_function(SemanticAnalyzer* analyzer, ASTNode* function) {
+    const char* name = function->function_def.name;
+    Symbol* symbol = symbol_table_lookup(analyzer->symbol_table, name);
+
+    for (size_t i = 0; symbol->param_types && i < symbol->param_types->count; i++) {
+        if (!is_scalar(symbol->param_types->items[i])) {
+            return check_fail(analyzer, name, "may only take int, float and bool parameters");
+        }
+    }
+    if (!is_scalar(symbol->return_type)) {
+        return check_fail(analyzer, name, "must return int, float or bool");
+    }
+    return check_block(analyzer, name, function->function_def.body);
+}
+
+// Numeric literal, possibly negated
+static bool constant_argument(const ASTNode* node, Value* value) {
+    if (node->type == AST_UNARYOP && node->unaryop.op == UNARYOP_USUB) {
+        if (!constant_argument(node->unaryop.operand, value)) return false;
+        if (value->kind == VALUE_INT) value->i = -value->i;
+        else value->f = -value->f;
+        return true;
+    }
+    if (node->type != AST_CONSTANT) return false;
+
+    switch (node->constant.value.type) {
+        case CONST_INT: *value = int_value(node->constant.value.int_val); return true;
+        case CONST_BOOL: *value = int_value(node->constant.value.bool_val); return true;
+        case CONST_FLOAT: *value = float_value(VALUE_DOUBLE, node->constant.value.float_val); return true;
+        default: return false;
+    }
+}
+
+bool comptime_fold_call(SemanticAnalyzer* analyzer, ASTNode* call, Symbol* function) {
+    NodeArray* args = call->call.args;
+    Value values[8];
+    if (!function->definition || args->count > sizeof(values) / sizeof(values[0])) return true;
+
+    for (size_t i = 0; i < args->count; i++) {
+        if (!constant_argument(args->items[i], &values[i])) return true;
+    }
+
+    Interpreter interp = {analyzer, 0, 0, false, {VALUE_INT, 0, 0.0}};
+    Value result = call_function(&interp, function, values, args->count);
+    if (interp.failed) {
+        char message[384];
+        snprintf(message, sizeof(message), "Cannot evaluate %s() at compile time: %s",
+                 function->name, analyzer->error_message);
+        semantic_error(analyzer, message);
+        return false;
+    }
+    // INT_MIN has no C literal; leave the call
+    if (function->return_type->kind == TYPE_INT && result.i == INT_MIN) return true;
+
+    // The call becomes its value
+    call->type = AST_CONSTANT;
+    switch (function->return_type->kind) {
+        case TYPE_FLOAT:
+            call->constant.value.type = CONST_FLOAT;
+            call->constant.value.float_val = result.f;
+            break;
+        case TYPE_BOOL:
+            call->constant.value.type = CONST_BOOL;
+            call->constant.value.bool_val = result.i != 0;
+            break;
+        default:
+            call->constant.value.type = CONST_INT;
+            call->constant.value.int_val = (int)result.i;
+            break;
+    }
+    return true;
+}
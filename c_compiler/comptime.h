@@ -0,0 +1,23 @@
+#ifndef COMPTIME_H
+#define COMPTIME_H
+
+#include "ast.h"
+#include "semantic.h"
+#include <stdbool.h>
+
+// Compile-time evaluation of @comptime functions. Bodies are interpreted
+// over the AST with the arithmetic of the generated C: 32-bit ints with
+// truncating division, float values rounded to single precision, and
+// float literals and libm results kept in double until they are stored.
+
+// Rejects a @comptime function the interpreter cannot run: parameters,
+// locals and the result must be int, float or bool, and calls may only go
+// to other @comptime functions or a libm @c_function.
+bool comptime_check_function(SemanticAnalyzer* analyzer, ASTNode* function);
+
+// Rewrites a call to a @comptime function into a constant when every
+// argument is one. Other calls are left for run time. Returns false with
+// a semantic error if evaluation fails.
+bool comptime_fold_call(SemanticAnalyzer* analyzer, ASTNode* call, Symbol* function);
+
+#endif // COMPTIME_H
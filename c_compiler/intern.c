@@ -0,0 +1,98 @@
+#include "intern.h"
+#include "arena.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define INTERN_INITIAL_CAPACITY 1024
+
+static InternTable table = {NULL, 0, 0};
+
+// FNV-1a
+static uint32_t intern_hash(const char* str, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static InternEntry* intern_slot(InternEntry* entries, size_t capacity,
+                                const char* str, size_t length, uint32_t hash) {
+    size_t mask = capacity - 1;
+    size_t index = hash & mask;
+
+    while (entries[index].str) {
+        InternEntry* entry = &entries[index];
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(entry->str, str, length) == 0) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+    return &entries[index];
+}
+
+static bool intern_grow(void) {
+    size_t new_capacity = table.capacity ? table.capacity * 2 : INTERN_INITIAL_CAPACITY;
+    InternEntry* entries = arena_calloc(arena_current(), new_capacity, sizeof(InternEntry));
+    if (!entries) return false;
+
+    // The old entry array is left in the arena; strings are not moved
+    for (size_t i = 0; i < table.capacity; i++) {
+        InternEntry* old = &table.entries[i];
+        if (old->str) {
+            *intern_slot(entries, new_capacity, old->str, old->length, old->hash) = *old;
+        }
+    }
+
+    table.entries = entries;
+    table.capacity = new_capacity;
+    return true;
+}
+
+void intern_init(void) {
+    table.entries = NULL;
+    table.count = 0;
+    table.capacity = 0;
+    intern_grow();
+}
+
+// Interning
+char* intern_n(const char* str, size_t length) {
+    if (!str) return NULL;
+
+    // Keep the load factor under 3/4
+    if (!table.entries || (table.count + 1) * 4 > table.capacity * 3) {
+        if (!intern_grow()) return NULL;
+    }
+
+    uint32_t hash = intern_hash(str, length);
+    InternEntry* entry = intern_slot(table.entries, table.capacity, str, length, hash);
+    if (!entry->str) {
+        entry->str = arena_strndup(arena_current(), str, length);
+        if (!entry->str) return NULL;
+        entry->length = length;
+        entry->hash = hash;
+        table.count++;
+    }
+    return entry->str;
+}
+
+char* intern(const char* str) {
+    if (!str) return NULL;
+    return intern_n(str, strlen(str));
+}
+
+char* intern_find(const char* str) {
+    if (!str || !table.entries) return NULL;
+
+    size_t length = strlen(str);
+    InternEntry* entry = intern_slot(table.entries, table.capacity, str, length,
+                                     intern_hash(str, length));
+    return entry->str;
+}
+
+size_t intern_count(void) {
+    return table.count;
+}
@@ -0,0 +1,41 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Identifier interning. Every distinct spelling is stored exactly once in
+// the compilation-unit arena, so two interned names are equal if and only if
+// their pointers are equal. Interned strings must not be modified.
+typedef struct {
+    char* str;
+    size_t length;
+    uint32_t hash;
+} InternEntry;
+
+typedef struct {
+    InternEntry* entries;
+    size_t count;
+    size_t capacity;  // Always a power of two
+} InternTable;
+
+// Start a fresh table in arena_current(); call once per compilation unit
+// after arena_set_current().
+void intern_init(void);
+
+// Interning
+char* intern_n(const char* str, size_t length);
+char* intern(const char* str);
+
+// Returns the interned copy of str, or NULL if it was never interned
+char* intern_find(const char* str);
+
+// Number of distinct names interned in the current table
+size_t intern_count(void);
+
+// Hash of an interned pointer, for pointer-keyed hash tables
+static inline size_t intern_ptr_hash(const char* interned) {
+    return (size_t)(((uintptr_t)interned >> 4) * (uintptr_t)0x9E3779B97F4A7C15ULL);
+}
+
+#endif // INTERN_H
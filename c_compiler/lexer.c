@@ -1,51 +1,218 @@
 #include "lexer.h"
 
-// Keywords table
-static const struct {
-    const char* keyword;
-    TokenType type;
-} keywords[] = {
-    {"def", TOK_DEF},
-    {"class", TOK_CLASS},
-    {"if", TOK_IF},
-    {"else", TOK_ELSE},
-    {"elif", TOK_ELIF},
-    {"while", TOK_WHILE},
-    {"for", TOK_FOR},
-    {"break", TOK_BREAK},
-    {"continue", TOK_CONTINUE},
-    {"return", TOK_RETURN},
-    {"pass", TOK_PASS},
-    {"match", TOK_MATCH},
-    {"case", TOK_CASE},
-    {"in", TOK_IN},
-    {"and", TOK_AND},
-    {"or", TOK_OR},
-    {"not", TOK_NOT},
-    {"True", TOK_TRUE},
-    {"False", TOK_FALSE},
-    {"None", TOK_NONE},
-    {"import", TOK_IMPORT},
-    {"from", TOK_FROM},
-    {"as", TOK_AS},
-    {NULL, 0}
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LEXER_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define LEXER_SIMD_NEON 1
+#endif
+
+// Character classes
+enum {
+    CC_IDENT_START = 1 << 0,
+    CC_IDENT = 1 << 1,
+    CC_DIGIT = 1 << 2,
+    CC_BLANK = 1 << 3   // Space or tab
 };
 
+static unsigned char char_class[256];
+
+static void char_class_init(void) {
+    if (char_class['_']) return;
+    
+    for (int c = 0; c < 256; c++) {
+        unsigned char cls = 0;
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') cls |= CC_IDENT_START | CC_IDENT;
+        if (c >= '0' && c <= '9') cls |= CC_DIGIT | CC_IDENT;
+        if (c == ' ' || c == '\t') cls |= CC_BLANK;
+        char_class[c] = cls;
+    }
+}
+
+#define CHAR_IS(c, cls) (char_class[(unsigned char)(c)] & (cls))
+
+// Keyword recognition: dispatch on length and first character, then confirm
+// with a single memcmp
+#define KEYWORD(text, tok) \
+    if (memcmp(str, text, length) == 0) return tok
+
+static TokenType keyword_lookup(const char* str, size_t length) {
+    switch (length) {
+        case 2:
+            switch (str[0]) {
+                case 'i': KEYWORD("if", TOK_IF); KEYWORD("in", TOK_IN); break;
+                case 'o': KEYWORD("or", TOK_OR); break;
+                case 'a': KEYWORD("as", TOK_AS); break;
+            }
+            break;
+        case 3:
+            switch (str[0]) {
+                case 'd': KEYWORD("def", TOK_DEF); break;
+                case 'f': KEYWORD("for", TOK_FOR); break;
+                case 'a': KEYWORD("and", TOK_AND); break;
+                case 'n': KEYWORD("not", TOK_NOT); break;
+            }
+            break;
+        case 4:
+            switch (str[0]) {
+                case 'e': KEYWORD("else", TOK_ELSE); KEYWORD("elif", TOK_ELIF); break;
+                case 'p': KEYWORD("pass", TOK_PASS); break;
+                case 'c': KEYWORD("case", TOK_CASE); break;
+                case 'T': KEYWORD("True", TOK_TRUE); break;
+                case 'N': KEYWORD("None", TOK_NONE); break;
+                case 'f': KEYWORD("from", TOK_FROM); break;
+            }
+            break;
+        case 5:
+            switch (str[0]) {
+                case 'c': KEYWORD("class", TOK_CLASS); break;
+                case 'w': KEYWORD("while", TOK_WHILE); break;
+                case 'b': KEYWORD("break", TOK_BREAK); break;
+                case 'm': KEYWORD("match", TOK_MATCH); break;
+                case 'F': KEYWORD("False", TOK_FALSE); break;
+            }
+            break;
+        case 6:
+            switch (str[0]) {
+                case 'r': KEYWORD("return", TOK_RETURN); break;
+                case 'i': KEYWORD("import", TOK_IMPORT); break;
+            }
+            break;
+        case 8:
+            KEYWORD("continue", TOK_CONTINUE);
+            break;
+    }
+    return TOK_IDENTIFIER;
+}
+
+#undef KEYWORD
+
+// Bulk scanners. Each returns the length of the leading run of bytes that
+// need no per-character handling; full 16-byte blocks use SIMD when available.
+static size_t scan_blanks(const char* str, size_t length) {
+    size_t i = 0;
+#if defined(LEXER_SIMD_SSE2)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    while (i + 16 <= length) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab));
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(blank) & 0xFFFFu;
+        if (mask) return i + __builtin_ctz(mask);
+        i += 16;
+    }
+#elif defined(LEXER_SIMD_NEON)
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    while (i + 16 <= length) {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)(str + i));
+        uint8x16_t other = vmvnq_u8(vorrq_u8(vceqq_u8(chunk, space), vceqq_u8(chunk, tab)));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(other), 4)), 0);
+        if (mask) return i + (__builtin_ctzll(mask) >> 2);
+        i += 16;
+    }
+#endif
+    while (i < length && CHAR_IS(str[i], CC_BLANK)) i++;
+    return i;
+}
+
+// Run of string-literal bytes up to the closing quote, a backslash, a newline or a NUL
+static size_t scan_string_run(const char* str, size_t length, char quote) {
+    size_t i = 0;
+#if defined(LEXER_SIMD_SSE2)
+    const __m128i q = _mm_set1_epi8(quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 16 <= length) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, q), _mm_cmpeq_epi8(chunk, backslash)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, zero)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(stop);
+        if (mask) return i + __builtin_ctz(mask);
+        i += 16;
+    }
+#elif defined(LEXER_SIMD_NEON)
+    const uint8x16_t q = vdupq_n_u8((uint8_t)quote);
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    while (i + 16 <= length) {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)(str + i));
+        uint8x16_t stop = vorrq_u8(vorrq_u8(vceqq_u8(chunk, q), vceqq_u8(chunk, backslash)),
+                                   vorrq_u8(vceqq_u8(chunk, newline), vceqzq_u8(chunk)));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(stop), 4)), 0);
+        if (mask) return i + (__builtin_ctzll(mask) >> 2);
+        i += 16;
+    }
+#endif
+    while (i < length && str[i] != quote && str[i] != '\\' && str[i] != '\n' && str[i] != '\0') i++;
+    return i;
+}
+
 // Token management
-Token token_new(TokenType type, const char* value, int line, int column) {
+Token token_new(TokenType type, size_t offset, size_t length, int line, int column) {
     Token token;
     token.type = type;
-    token.value = value ? strdup(value) : NULL;
+    token.offset = offset;
+    token.length = length;
     token.line = line;
     token.column = column;
     return token;
 }
 
-void token_free(Token* token) {
-    if (token && token->value) {
-        free(token->value);
-        token->value = NULL;
+// Token text (views into TokenArray::source)
+const char* token_text(const TokenArray* arr, const Token* token) {
+    return arr->source + token->offset;
+}
+
+size_t token_copy(const TokenArray* arr, const Token* token, char* buf, size_t size) {
+    if (size == 0) return 0;
+    
+    size_t length = token->length < size - 1 ? token->length : size - 1;
+    memcpy(buf, token_text(arr, token), length);
+    buf[length] = '\0';
+    return length;
+}
+
+char* token_intern(const TokenArray* arr, const Token* token) {
+    return intern_n(token_text(arr, token), token->length);
+}
+
+char* token_string_value(const TokenArray* arr, const Token* token) {
+    const char* raw = token_text(arr, token);
+    size_t raw_length = token->length;
+    
+    // Most literals have no escapes and can be copied as-is
+    if (!memchr(raw, '\\', raw_length)) {
+        return arena_strndup(arena_current(), raw, raw_length);
+    }
+    
+    char* value = arena_alloc(arena_current(), raw_length * 2 + 1);
+    if (!value) return NULL;
+    
+    size_t length = 0;
+    for (size_t i = 0; i < raw_length; i++) {
+        if (raw[i] == '\\' && i + 1 < raw_length) {
+            char escape = raw[++i];
+            switch (escape) {
+                case 'n': value[length++] = '\n'; break;
+                case 't': value[length++] = '\t'; break;
+                case 'r': value[length++] = '\r'; break;
+                case '\\': value[length++] = '\\'; break;
+                case '"': value[length++] = '"'; break;
+                case '\'': value[length++] = '\''; break;
+                default:
+                    value[length++] = '\\';
+                    value[length++] = escape;
+                    break;
+            }
+        } else {
+            value[length++] = raw[i];
+        }
     }
+    value[length] = '\0';
+    return value;
 }
 
 const char* token_type_name(TokenType type) {
@@ -100,6 +267,7 @@ const char* token_type_name(TokenType type) {
         case TOK_COLON: return "COLON";
         case TOK_SEMICOLON: return "SEMICOLON";
         case TOK_DOT: return "DOT";
+        case TOK_AT: return "AT";
         case TOK_NEWLINE: return "NEWLINE";
         case TOK_INDENT: return "INDENT";
         case TOK_DEDENT: return "DEDENT";
@@ -111,17 +279,15 @@ const char* token_type_name(TokenType type) {
 
 // Token array management
 TokenArray* token_array_new(void) {
-    TokenArray* arr = malloc(sizeof(TokenArray));
+    TokenArray* arr = arena_alloc(arena_current(), sizeof(TokenArray));
     if (!arr) return NULL;
     
     arr->capacity = 64;
-    arr->items = malloc(sizeof(Token) * arr->capacity);
-    if (!arr->items) {
-        free(arr);
-        return NULL;
-    }
+    arr->items = arena_alloc(arena_current(), sizeof(Token) * arr->capacity);
+    if (!arr->items) return NULL;
     arr->count = 0;
     arr->current = 0;
+    arr->source = NULL;
     return arr;
 }
 
@@ -130,7 +296,9 @@ void token_array_push(TokenArray* arr, Token token) {
     
     if (arr->count >= arr->capacity) {
         size_t new_capacity = arr->capacity * 2;
-        Token* new_items = realloc(arr->items, sizeof(Token) * new_capacity);
+        Token* new_items = arena_grow(arena_current(), arr->items,
+                                      sizeof(Token) * arr->capacity,
+                                      sizeof(Token) * new_capacity);
         if (!new_items) return;
         arr->items = new_items;
         arr->capacity = new_capacity;
@@ -139,83 +307,49 @@ void token_array_push(TokenArray* arr, Token token) {
     arr->items[arr->count++] = token;
 }
 
-void token_array_free(TokenArray* arr) {
-    if (arr) {
-        if (arr->items) {
-            for (size_t i = 0; i < arr->count; i++) {
-                token_free(&arr->items[i]);
-            }
-            free(arr->items);
-        }
-        free(arr);
-    }
-}
-
 // Lexer functions
-Lexer* lexer_new(const char* source) {
-    Lexer* lexer = malloc(sizeof(Lexer));
+Lexer* lexer_new(const char* source, size_t length) {
+    char_class_init();
+    
+    Lexer* lexer = arena_alloc(arena_current(), sizeof(Lexer));
     if (!lexer) return NULL;
     
     lexer->source = source;
     lexer->position = 0;
-    lexer->length = strlen(source);
+    lexer->length = length;
     lexer->line = 1;
     lexer->column = 1;
     lexer->at_line_start = true;
     
     // Initialize indent stack
     lexer->indent_capacity = 16;
-    lexer->indent_stack = malloc(sizeof(int) * lexer->indent_capacity);
-    if (!lexer->indent_stack) {
-        free(lexer);
-        return NULL;
-    }
+    lexer->indent_stack = arena_alloc(arena_current(), sizeof(int) * lexer->indent_capacity);
+    if (!lexer->indent_stack) return NULL;
     lexer->indent_stack[0] = 0;  // Base indentation
     lexer->indent_count = 1;
     
     lexer->tokens = token_array_new();
-    if (!lexer->tokens) {
-        free(lexer->indent_stack);
-        free(lexer);
-        return NULL;
-    }
+    if (!lexer->tokens) return NULL;
+    lexer->tokens->source = source;
     
     return lexer;
 }
 
-void lexer_free(Lexer* lexer) {
-    if (lexer) {
-        free(lexer->indent_stack);
-        token_array_free(lexer->tokens);
-        free(lexer);
-    }
-}
-
 // Helper functions
 bool is_keyword(const char* str) {
-    for (int i = 0; keywords[i].keyword; i++) {
-        if (strcmp(str, keywords[i].keyword) == 0) {
-            return true;
-        }
-    }
-    return false;
+    return keyword_token_type(str) != TOK_IDENTIFIER;
 }
 
 TokenType keyword_token_type(const char* str) {
-    for (int i = 0; keywords[i].keyword; i++) {
-        if (strcmp(str, keywords[i].keyword) == 0) {
-            return keywords[i].type;
-        }
-    }
-    return TOK_IDENTIFIER;
+    return keyword_lookup(str, strlen(str));
 }
 
 bool is_identifier_start(char c) {
-    return isalpha(c) || c == '_';
+    return CHAR_IS(c, CC_IDENT_START);
 }
 
 bool is_identifier_char(char c) {
-    return isalnum(c) || c == '_';
+    return CHAR_IS(c, CC_IDENT);
 }
 
 // Lexer helper functions
@@ -247,18 +381,25 @@ static void lexer_advance(Lexer* lexer) {
     }
 }
 
+// Advance over `count` bytes known to contain no newline
+static void lexer_advance_run(Lexer* lexer, size_t count) {
+    if (count == 0) return;
+    lexer->position += count;
+    lexer->column += (int)count;
+    lexer->at_line_start = false;
+}
+
 static void lexer_skip_whitespace(Lexer* lexer) {
-    while (lexer_current_char(lexer) == ' ' || lexer_current_char(lexer) == '\t') {
-        lexer_advance(lexer);
-        lexer->at_line_start = false;
-    }
+    lexer_advance_run(lexer, scan_blanks(lexer->source + lexer->position,
+                                         lexer->length - lexer->position));
 }
 
 static void lexer_skip_comment(Lexer* lexer) {
     if (lexer_current_char(lexer) == '#') {
-        while (lexer_current_char(lexer) != '\n' && lexer_current_char(lexer) != '\0') {
-            lexer_advance(lexer);
-        }
+        const char* start = lexer->source + lexer->position;
+        size_t remaining = lexer->length - lexer->position;
+        const char* newline = memchr(start, '\n', remaining);
+        lexer_advance_run(lexer, newline ? (size_t)(newline - start) : remaining);
     }
 }
 
@@ -288,23 +429,25 @@ static void lexer_handle_indentation(Lexer* lexer) {
     if (indent_level > current_indent) {
         // Increase indentation
         if (lexer->indent_count >= lexer->indent_capacity) {
+            size_t old_size = sizeof(int) * lexer->indent_capacity;
             lexer->indent_capacity *= 2;
-            lexer->indent_stack = realloc(lexer->indent_stack, sizeof(int) * lexer->indent_capacity);
+            lexer->indent_stack = arena_grow(arena_current(), lexer->indent_stack, old_size,
+                                             sizeof(int) * lexer->indent_capacity);
         }
         lexer->indent_stack[lexer->indent_count++] = indent_level;
-        Token token = token_new(TOK_INDENT, NULL, lexer->line, lexer->column);
+        Token token = token_new(TOK_INDENT, lexer->position, 0, lexer->line, lexer->column);
         token_array_push(lexer->tokens, token);
     } else if (indent_level < current_indent) {
         // Decrease indentation - may need multiple DEDENTs
         while (lexer->indent_count > 1 && lexer->indent_stack[lexer->indent_count - 1] > indent_level) {
             lexer->indent_count--;
-            Token token = token_new(TOK_DEDENT, NULL, lexer->line, lexer->column);
+            Token token = token_new(TOK_DEDENT, lexer->position, 0, lexer->line, lexer->column);
             token_array_push(lexer->tokens, token);
         }
         
         // Check for indentation error
         if (lexer->indent_stack[lexer->indent_count - 1] != indent_level) {
-            Token token = token_new(TOK_ERROR, "IndentationError", lexer->line, lexer->column);
+            Token token = token_new(TOK_ERROR, lexer->position, 0, lexer->line, lexer->column);
             token_array_push(lexer->tokens, token);
         }
     }
@@ -317,7 +460,7 @@ static Token lexer_read_number(Lexer* lexer) {
     
     bool has_dot = false;
     
-    while (isdigit(lexer_current_char(lexer)) || 
+    while (CHAR_IS(lexer_current_char(lexer), CC_DIGIT) || 
            (lexer_current_char(lexer) == '.' && !has_dot)) {
         if (lexer_current_char(lexer) == '.') {
             has_dot = true;
@@ -325,61 +468,39 @@ static Token lexer_read_number(Lexer* lexer) {
         lexer_advance(lexer);
     }
     
-    size_t length = lexer->position - start;
-    char* value = malloc(length + 1);
-    strncpy(value, lexer->source + start, length);
-    value[length] = '\0';
-    
-    Token token = token_new(TOK_NUMBER, value, line, column);
-    free(value);
-    return token;
+    return token_new(TOK_NUMBER, start, lexer->position - start, line, column);
 }
 
+// String tokens span the raw contents between the quotes; escapes are
+// decoded on demand by token_string_value()
 static Token lexer_read_string(Lexer* lexer) {
     int line = lexer->line;
     int column = lexer->column;
     char quote_char = lexer_current_char(lexer);
     
     lexer_advance(lexer);  // Skip opening quote
-    
-    char* value = malloc(256);  // Initial buffer
-    size_t capacity = 256;
-    size_t length = 0;
+    size_t start = lexer->position;
     
     while (lexer_current_char(lexer) != quote_char && lexer_current_char(lexer) != '\0') {
-        if (length >= capacity - 1) {
-            capacity *= 2;
-            value = realloc(value, capacity);
-        }
+        // Skip plain characters in bulk
+        lexer_advance_run(lexer, scan_string_run(lexer->source + lexer->position,
+                                                 lexer->length - lexer->position, quote_char));
         
-        if (lexer_current_char(lexer) == '\\' && lexer_peek_char(lexer) != '\0') {
-            lexer_advance(lexer);  // Skip backslash
-            char escape = lexer_current_char(lexer);
-            switch (escape) {
-                case 'n': value[length++] = '\n'; break;
-                case 't': value[length++] = '\t'; break;
-                case 'r': value[length++] = '\r'; break;
-                case '\\': value[length++] = '\\'; break;
-                case '"': value[length++] = '"'; break;
-                case '\'': value[length++] = '\''; break;
-                default: 
-                    value[length++] = '\\';
-                    value[length++] = escape;
-                    break;
-            }
-        } else {
-            value[length++] = lexer_current_char(lexer);
+        char current = lexer_current_char(lexer);
+        if (current == quote_char || current == '\0') break;
+        
+        if (current == '\\' && lexer_peek_char(lexer) != '\0') {
+            lexer_advance(lexer);  // Skip backslash so an escaped quote does not terminate
         }
         lexer_advance(lexer);
     }
     
+    Token token = token_new(TOK_STRING, start, lexer->position - start, line, column);
+    
     if (lexer_current_char(lexer) == quote_char) {
         lexer_advance(lexer);  // Skip closing quote
     }
     
-    value[length] = '\0';
-    Token token = token_new(TOK_STRING, value, line, column);
-    free(value);
     return token;
 }
 
@@ -388,19 +509,13 @@ static Token lexer_read_identifier(Lexer* lexer) {
     int line = lexer->line;
     int column = lexer->column;
     
-    while (is_identifier_char(lexer_current_char(lexer))) {
-        lexer_advance(lexer);
-    }
-    
-    size_t length = lexer->position - start;
-    char* value = malloc(length + 1);
-    strncpy(value, lexer->source + start, length);
-    value[length] = '\0';
+    const char* source = lexer->source;
+    size_t end = start;
+    while (end < lexer->length && CHAR_IS(source[end], CC_IDENT)) end++;
+    lexer_advance_run(lexer, end - start);
     
-    TokenType type = is_keyword(value) ? keyword_token_type(value) : TOK_IDENTIFIER;
-    Token token = token_new(type, value, line, column);
-    free(value);
-    return token;
+    size_t length = end - start;
+    return token_new(keyword_lookup(source + start, length), start, length, line, column);
 }
 
 TokenArray* lexer_tokenize(Lexer* lexer) {
@@ -427,19 +542,20 @@ TokenArray* lexer_tokenize(Lexer* lexer) {
         }
         
         Token token;
+        size_t start = lexer->position;
         int line = lexer->line;
         int column = lexer->column;
         
         // Handle newlines
         if (current == '\n') {
-            token = token_new(TOK_NEWLINE, NULL, line, column);
+            token = token_new(TOK_NEWLINE, start, 1, line, column);
             lexer_advance(lexer);
             token_array_push(lexer->tokens, token);
             continue;
         }
         
         // Handle numbers
-        if (isdigit(current)) {
+        if (CHAR_IS(current, CC_DIGIT)) {
             token = lexer_read_number(lexer);
             token_array_push(lexer->tokens, token);
             continue;
@@ -462,135 +578,140 @@ TokenArray* lexer_tokenize(Lexer* lexer) {
         // Handle operators and delimiters
         switch (current) {
             case '+':
-                token = token_new(TOK_PLUS, NULL, line, column);
+                token = token_new(TOK_PLUS, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case '-':
                 if (lexer_peek_char(lexer) == '>') {
-                    token = token_new(TOK_ARROW, NULL, line, column);
+                    token = token_new(TOK_ARROW, start, 0, line, column);
                     lexer_advance(lexer);
                     lexer_advance(lexer);
                 } else {
-                    token = token_new(TOK_MINUS, NULL, line, column);
+                    token = token_new(TOK_MINUS, start, 0, line, column);
                     lexer_advance(lexer);
                 }
                 break;
             case '*':
-                token = token_new(TOK_MULTIPLY, NULL, line, column);
+                token = token_new(TOK_MULTIPLY, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case '/':
                 if (lexer_peek_char(lexer) == '/') {
-                    token = token_new(TOK_FLOORDIV, NULL, line, column);
+                    token = token_new(TOK_FLOORDIV, start, 0, line, column);
                     lexer_advance(lexer);
                     lexer_advance(lexer);
                 } else {
-                    token = token_new(TOK_DIVIDE, NULL, line, column);
+                    token = token_new(TOK_DIVIDE, start, 0, line, column);
                     lexer_advance(lexer);
                 }
                 break;
             case '%':
-                token = token_new(TOK_MODULO, NULL, line, column);
+                token = token_new(TOK_MODULO, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case '=':
                 if (lexer_peek_char(lexer) == '=') {
-                    token = token_new(TOK_EQ, NULL, line, column);
+                    token = token_new(TOK_EQ, start, 0, line, column);
                     lexer_advance(lexer);
                     lexer_advance(lexer);
                 } else {
-                    token = token_new(TOK_ASSIGN, NULL, line, column);
+                    token = token_new(TOK_ASSIGN, start, 0, line, column);
                     lexer_advance(lexer);
                 }
                 break;
             case '!':
                 if (lexer_peek_char(lexer) == '=') {
-                    token = token_new(TOK_NE, NULL, line, column);
+                    token = token_new(TOK_NE, start, 0, line, column);
                     lexer_advance(lexer);
                     lexer_advance(lexer);
                 } else {
-                    token = token_new(TOK_ERROR, "Unexpected character", line, column);
+                    token = token_new(TOK_ERROR, start, 0, line, column);
                     lexer_advance(lexer);
                 }
                 break;
             case '<':
                 if (lexer_peek_char(lexer) == '=') {
-                    token = token_new(TOK_LE, NULL, line, column);
+                    token = token_new(TOK_LE, start, 0, line, column);
                     lexer_advance(lexer);
                     lexer_advance(lexer);
                 } else {
-                    token = token_new(TOK_LT, NULL, line, column);
+                    token = token_new(TOK_LT, start, 0, line, column);
                     lexer_advance(lexer);
                 }
                 break;
             case '>':
                 if (lexer_peek_char(lexer) == '=') {
-                    token = token_new(TOK_GE, NULL, line, column);
+                    token = token_new(TOK_GE, start, 0, line, column);
                     lexer_advance(lexer);
                     lexer_advance(lexer);
                 } else {
-                    token = token_new(TOK_GT, NULL, line, column);
+                    token = token_new(TOK_GT, start, 0, line, column);
                     lexer_advance(lexer);
                 }
                 break;
             case '(':
-                token = token_new(TOK_LPAREN, NULL, line, column);
+                token = token_new(TOK_LPAREN, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case ')':
-                token = token_new(TOK_RPAREN, NULL, line, column);
+                token = token_new(TOK_RPAREN, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case '[':
-                token = token_new(TOK_LBRACKET, NULL, line, column);
+                token = token_new(TOK_LBRACKET, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case ']':
-                token = token_new(TOK_RBRACKET, NULL, line, column);
+                token = token_new(TOK_RBRACKET, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case '{':
-                token = token_new(TOK_LBRACE, NULL, line, column);
+                token = token_new(TOK_LBRACE, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case '}':
-                token = token_new(TOK_RBRACE, NULL, line, column);
+                token = token_new(TOK_RBRACE, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case ',':
-                token = token_new(TOK_COMMA, NULL, line, column);
+                token = token_new(TOK_COMMA, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case ':':
-                token = token_new(TOK_COLON, NULL, line, column);
+                token = token_new(TOK_COLON, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case ';':
-                token = token_new(TOK_SEMICOLON, NULL, line, column);
+                token = token_new(TOK_SEMICOLON, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             case '.':
-                token = token_new(TOK_DOT, NULL, line, column);
+                token = token_new(TOK_DOT, start, 0, line, column);
+                lexer_advance(lexer);
+                break;
+            case '@':
+                token = token_new(TOK_AT, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
             default:
-                token = token_new(TOK_ERROR, "Unexpected character", line, column);
+                token = token_new(TOK_ERROR, start, 0, line, column);
                 lexer_advance(lexer);
                 break;
         }
         
+        token.length = lexer->position - start;
         token_array_push(lexer->tokens, token);
     }
     
     // Add final DEDENTs if needed
     while (lexer->indent_count > 1) {
         lexer->indent_count--;
-        Token token = token_new(TOK_DEDENT, NULL, lexer->line, lexer->column);
+        Token token = token_new(TOK_DEDENT, lexer->position, 0, lexer->line, lexer->column);
         token_array_push(lexer->tokens, token);
     }
     
     // Add EOF token
-    Token eof_token = token_new(TOK_EOF, NULL, lexer->line, lexer->column);
+    Token eof_token = token_new(TOK_EOF, lexer->position, 0, lexer->line, lexer->column);
     token_array_push(lexer->tokens, eof_token);
     
     return lexer->tokens;
@@ -6,6 +6,8 @@
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include "arena.h"
+#include "intern.h"
 
 // Token types
 typedef enum {
@@ -66,6 +68,7 @@ typedef enum {
     TOK_COLON,          // :
     TOK_SEMICOLON,      // ;
     TOK_DOT,            // .
+    TOK_AT,             // @ (decorator)
     
     // Special
     TOK_NEWLINE,
@@ -75,9 +78,12 @@ typedef enum {
     TOK_ERROR
 } TokenType;
 
+// Tokens are views into the source buffer: no per-token allocation. For
+// string literals the span covers the raw contents between the quotes.
 typedef struct {
     TokenType type;
-    char* value;
+    size_t offset;
+    size_t length;
     int line;
     int column;
 } Token;
@@ -87,6 +93,7 @@ typedef struct {
     size_t count;
     size_t capacity;
     size_t current;  // Current position for parsing
+    const char* source;  // Buffer the tokens point into (not NUL-terminated)
 } TokenArray;
 
 typedef struct {
@@ -103,18 +110,23 @@ typedef struct {
 } Lexer;
 
 // Token management
-Token token_new(TokenType type, const char* value, int line, int column);
-void token_free(Token* token);
+Token token_new(TokenType type, size_t offset, size_t length, int line, int column);
 const char* token_type_name(TokenType type);
 
+// Token text. token_text() is not NUL-terminated; token_copy() writes a
+// truncated C string into buf. token_intern() and token_string_value()
+// return arena-owned strings.
+const char* token_text(const TokenArray* arr, const Token* token);
+size_t token_copy(const TokenArray* arr, const Token* token, char* buf, size_t size);
+char* token_intern(const TokenArray* arr, const Token* token);
+char* token_string_value(const TokenArray* arr, const Token* token);
+
 // Token array management
 TokenArray* token_array_new(void);
 void token_array_push(TokenArray* arr, Token token);
-void token_array_free(TokenArray* arr);
 
 // Lexer functions
-Lexer* lexer_new(const char* source);
-void lexer_free(Lexer* lexer);
+Lexer* lexer_new(const char* source, size_t length);
 TokenArray* lexer_tokenize(Lexer* lexer);
 
 // Helper functions
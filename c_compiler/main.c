@@ -1,81 +1,140 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 
 #include "lexer.h"
 #include "parser.h"
 #include "semantic.h"
+#include "optimize.h"
 #include "codegen.h"
+#include "build.h"
+#include "stats.h"
+#include "intern.h"
 
 void print_usage(const char* program_name) {
     printf("Usage: %s [options] <input_file>\n", program_name);
     printf("Options:\n");
-    printf("  -o <output>    Output executable name (default: a.out)\n");
-    printf("  -h, --help     Show this help message\n");
+    printf("  -o <output>         Output executable name (default: a.out)\n");
+    printf("  -O0 .. -O3          C backend optimization level (default: -O0)\n");
+    printf("  --release           Optimized build: -O3 with LTO\n");
+    printf("  --target-cpu <cpu>  Pass -march=<cpu> to the C compiler (e.g. native)\n");
+    printf("  --lto               Link-time optimization across program and runtime\n");
+    printf("  --cc <compiler>     C compiler to use (default: gcc)\n");
+    printf("  --bounds-check      Check array indices that are not provably in range\n");
+    printf("  -g                  Debug info, with #line directives and a <file>.c.map line map\n");
+    printf("  --profile           Time every function; the program reports at exit\n");
+    printf("  --pgo-generate[=DIR] Instrumented build that records a profile in DIR when run\n");
+    printf("  --pgo-use[=DIR]     Optimize with the profile recorded in DIR\n");
+    printf("  --pgo-train <cmd>   Build instrumented, run the shell command, then build with its profile\n");
+    printf("  --time-report       Report time and memory per compiler phase (also --stats)\n");
+    printf("  --stats-json <file> Write the same report as JSON (- for stdout)\n");
+    printf("  -h, --help          Show this help message\n");
 }
 
-char* read_file(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
-        return NULL;
-    }
-    
-    // Get file size
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+// Source buffer. Tokens reference it directly, so it must outlive the
+// front end. Regular files are mapped read-only; anything mmap refuses
+// (pipes, special files) is read into a heap buffer instead.
+typedef struct {
+    char* data;
+    size_t length;
+    bool mapped;
+} SourceFile;
+
+static bool read_source_fallback(int fd, SourceFile* source) {
+    size_t capacity = 4096;
+    source->data = malloc(capacity);
+    source->length = 0;
+    source->mapped = false;
+    if (!source->data) return false;
     
-    // Allocate buffer and read file
-    char* content = malloc(size + 1);
-    if (!content) {
-        fprintf(stderr, "Error: Memory allocation failed\n");
-        fclose(file);
-        return NULL;
+    for (;;) {
+        if (source->length == capacity) {
+            char* data = realloc(source->data, capacity * 2);
+            if (!data) {
+                free(source->data);
+                return false;
+            }
+            source->data = data;
+            capacity *= 2;
+        }
+        
+        ssize_t bytes_read = read(fd, source->data + source->length, capacity - source->length);
+        if (bytes_read < 0) {
+            if (errno == EINTR) continue;
+            free(source->data);
+            return false;
+        }
+        if (bytes_read == 0) break;
+        source->length += (size_t)bytes_read;
     }
-    
-    size_t bytes_read = fread(content, 1, size, file);
-    content[bytes_read] = '\0';
-    
-    fclose(file);
-    return content;
-}
-
-bool write_file(const char* filename, const char* content) {
-    FILE* file = fopen(filename, "w");
-    if (!file) {
-        fprintf(stderr, "Error: Cannot create file '%s'\n", filename);
-        return false;
+    // Empty input is represented as for an empty regular file
+    if (source->length == 0) {
+        free(source->data);
+        source->data = "";
     }
-    
-    fprintf(file, "%s", content);
-    fclose(file);
     return true;
 }
 
-bool compile_c_code(const char* c_file, const char* output_file) {
-    // Build gcc command
-    char command[1024];
-    snprintf(command, sizeof(command), 
-             "gcc -I ../runtime -o %s %s ../runtime/pyrinas.o -lm", 
-             output_file, c_file);
+bool read_source(const char* filename, SourceFile* source) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
+        return false;
+    }
     
-    printf("Compiling C code: %s\n", command);
+    struct stat st;
+    bool ok = false;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        source->length = (size_t)st.st_size;
+        source->mapped = false;
+        if (source->length == 0) {
+            source->data = "";
+            ok = true;
+        } else {
+            void* data = mmap(NULL, source->length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                source->data = data;
+                source->mapped = true;
+                ok = true;
+            }
+        }
+    }
     
-    int result = system(command);
-    if (result != 0) {
-        fprintf(stderr, "Error: C compilation failed\n");
-        return false;
+    if (!ok) {
+        ok = read_source_fallback(fd, source);
+        if (!ok) fprintf(stderr, "Error: Cannot read file '%s'\n", filename);
     }
     
-    return true;
+    close(fd);
+    return ok;
+}
+
+void release_source(SourceFile* source) {
+    if (source->mapped) {
+        munmap(source->data, source->length);
+    } else if (source->length > 0) {
+        free(source->data);
+    }
 }
 
 int main(int argc, char* argv[]) {
     const char* input_file = NULL;
     const char* output_file = "a.out";
+    BuildOptions build_options;
+    build_options_init(&build_options);
+    bool bounds_check = false;
+    bool profile = false;
+    const char* pgo_train = NULL;
+    bool time_report = false;
+    const char* stats_json = NULL;
+    CompilerStats stats;
+    stats_init(&stats);
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -85,6 +144,51 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
             output_file = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] == 'O' && argv[i][2] >= '0' &&
+                   argv[i][2] <= '3' && argv[i][3] == '\0') {
+            build_options.opt_level = argv[i][2] - '0';
+        } else if (strcmp(argv[i], "--release") == 0) {
+            build_options_release(&build_options);
+        } else if (strcmp(argv[i], "--bounds-check") == 0) {
+            bounds_check = true;
+        } else if (strcmp(argv[i], "-g") == 0) {
+            build_options.debug = true;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (strncmp(argv[i], "--pgo-generate", 14) == 0 && (argv[i][14] == '\0' || argv[i][14] == '=')) {
+            build_options.pgo = PGO_GENERATE;
+            if (argv[i][14] == '=') build_options.pgo_dir = argv[i] + 15;
+        } else if (strncmp(argv[i], "--pgo-use", 9) == 0 && (argv[i][9] == '\0' || argv[i][9] == '=')) {
+            build_options.pgo = PGO_USE;
+            if (argv[i][9] == '=') build_options.pgo_dir = argv[i] + 10;
+        } else if (strcmp(argv[i], "--pgo-train") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --pgo-train option requires an argument\n");
+                return 1;
+            }
+            pgo_train = argv[++i];
+        } else if (strcmp(argv[i], "--time-report") == 0 || strcmp(argv[i], "--stats") == 0) {
+            time_report = true;
+        } else if (strcmp(argv[i], "--stats-json") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --stats-json option requires an argument\n");
+                return 1;
+            }
+            stats_json = argv[++i];
+        } else if (strcmp(argv[i], "--lto") == 0) {
+            build_options.lto = true;
+        } else if (strcmp(argv[i], "--target-cpu") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --target-cpu option requires an argument\n");
+                return 1;
+            }
+            build_options.target_cpu = argv[++i];
+        } else if (strcmp(argv[i], "--cc") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --cc option requires an argument\n");
+                return 1;
+            }
+            build_options.cc = argv[++i];
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -110,27 +214,43 @@ int main(int argc, char* argv[]) {
     printf("Compiling Pyrinas file: %s\n", input_file);
     
     // Read source file
-    char* source_code = read_file(input_file);
-    if (!source_code) {
+    SourceFile source;
+    if (!read_source(input_file, &source)) {
+        return 1;
+    }
+    stats.source_bytes = source.length;
+    
+    // Everything the front end allocates lives in one arena per compilation unit
+    Arena* arena = arena_new(ARENA_DEFAULT_BLOCK_SIZE);
+    if (!arena) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        release_source(&source);
         return 1;
     }
+    arena_set_current(arena);
+    intern_init();
+    types_init();
     
     // Tokenize
     printf("Tokenizing...\n");
-    Lexer* lexer = lexer_new(source_code);
+    stats_begin(&stats, PHASE_LEX);
+    Lexer* lexer = lexer_new(source.data, source.length);
     if (!lexer) {
         fprintf(stderr, "Error: Failed to create lexer\n");
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
     
     TokenArray* tokens = lexer_tokenize(lexer);
     if (!tokens) {
         fprintf(stderr, "Error: Tokenization failed\n");
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
+    stats_end(&stats, PHASE_LEX);
+    stats.tokens = tokens->count;
     
     // Debug: Print tokens (optional)
     if (getenv("PYRINAS_DEBUG_TOKENS")) {
@@ -138,8 +258,8 @@ int main(int argc, char* argv[]) {
         for (size_t i = 0; i < tokens->count; i++) {
             Token* token = &tokens->items[i];
             printf("%s", token_type_name(token->type));
-            if (token->value) {
-                printf("('%s')", token->value);
+            if (token->type <= TOK_AS || token->type == TOK_ERROR) {
+                printf("('%.*s')", (int)token->length, token_text(tokens, token));
             }
             printf(" ");
             if ((i + 1) % 10 == 0) printf("\n");
@@ -149,11 +269,12 @@ int main(int argc, char* argv[]) {
     
     // Parse
     printf("Parsing...\n");
+    stats_begin(&stats, PHASE_PARSE);
     Parser* parser = parser_new(tokens);
     if (!parser) {
         fprintf(stderr, "Error: Failed to create parser\n");
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
     
@@ -164,11 +285,12 @@ int main(int argc, char* argv[]) {
             fprintf(stderr, ": %s", parser->error_message);
         }
         fprintf(stderr, "\n");
-        parser_free(parser);
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
+    stats_end(&stats, PHASE_PARSE);
+    stats.ast_nodes = ast_node_count();
     
     // Debug: Print AST (optional)
     if (getenv("PYRINAS_DEBUG_AST")) {
@@ -179,13 +301,12 @@ int main(int argc, char* argv[]) {
     
     // Semantic analysis
     printf("Analyzing semantics...\n");
+    stats_begin(&stats, PHASE_SEMANTIC);
     SemanticAnalyzer* analyzer = semantic_analyzer_new(input_file);
     if (!analyzer) {
         fprintf(stderr, "Error: Failed to create semantic analyzer\n");
-        ast_node_free(ast);
-        parser_free(parser);
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
     
@@ -195,39 +316,51 @@ int main(int argc, char* argv[]) {
             fprintf(stderr, ": %s", analyzer->error_message);
         }
         fprintf(stderr, "\n");
-        semantic_analyzer_free(analyzer);
-        ast_node_free(ast);
-        parser_free(parser);
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
+        return 1;
+    }
+    stats_end(&stats, PHASE_SEMANTIC);
+    stats.symbols = analyzer->symbol_table->symbol_count;
+    
+    // Optimization
+    printf("Optimizing...\n");
+    stats_begin(&stats, PHASE_OPTIMIZE);
+    Optimizer* optimizer = optimizer_new(analyzer->symbol_table);
+    if (!optimizer || !optimize_ast(optimizer, ast)) {
+        fprintf(stderr, "Error: Optimization failed\n");
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
     
+    stats_end(&stats, PHASE_OPTIMIZE);
+    
     // Code generation
     printf("Generating C code...\n");
+    stats_begin(&stats, PHASE_CODEGEN);
     CodeGenerator* codegen = codegen_new(analyzer->symbol_table, analyzer);
     if (!codegen) {
         fprintf(stderr, "Error: Failed to create code generator\n");
-        semantic_analyzer_free(analyzer);
-        ast_node_free(ast);
-        parser_free(parser);
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
+    codegen->bounds_check = bounds_check;
+    codegen->profile = profile;
+    codegen->line_directives = build_options.debug;
+    codegen->source_file = input_file;
     
-    char* c_code = codegen_generate(codegen, ast);
-    if (!c_code) {
+    if (!codegen_emit(codegen, ast)) {
         fprintf(stderr, "Error: Code generation failed\n");
         codegen_free(codegen);
-        semantic_analyzer_free(analyzer);
-        ast_node_free(ast);
-        parser_free(parser);
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
     
+    stats_end(&stats, PHASE_CODEGEN);
+    
     // Write C code to file
     char c_filename[256];
     strcpy(c_filename, input_file);
@@ -238,47 +371,86 @@ int main(int argc, char* argv[]) {
         strcat(c_filename, ".c");
     }
     
+    // Sections are streamed straight to the file, never joined in memory
     printf("Writing C code to: %s\n", c_filename);
-    if (!write_file(c_filename, c_code)) {
-        free(c_code);
+    stats_begin(&stats, PHASE_WRITE);
+    if (!codegen_write_file(codegen, c_filename)) {
         codegen_free(codegen);
-        semantic_analyzer_free(analyzer);
-        ast_node_free(ast);
-        parser_free(parser);
-        lexer_free(lexer);
-        free(source_code);
+        arena_free(arena);
+        release_source(&source);
         return 1;
     }
+    if (build_options.debug) {
+        char map_filename[260];
+        snprintf(map_filename, sizeof(map_filename), "%s.map", c_filename);
+        if (!codegen_write_line_map(codegen, map_filename, c_filename)) {
+            codegen_free(codegen);
+            arena_free(arena);
+            release_source(&source);
+            return 1;
+        }
+    }
+    stats_end(&stats, PHASE_WRITE);
+    struct stat c_stat;
+    if (stat(c_filename, &c_stat) == 0) stats.c_bytes = (size_t)c_stat.st_size;
     
     // Debug: Print generated C code (optional)
     if (getenv("PYRINAS_DEBUG_CODEGEN")) {
         printf("\nGenerated C code:\n");
-        printf("%s\n", c_code);
+        fflush(stdout);
+        codegen_write_fd(codegen, STDOUT_FILENO);
+        printf("\n");
     }
     
-    // Compile C code
+    // The C file is written; release the front end in one go
+    stats.identifiers = intern_count();
+    stats.arena_allocated = arena->bytes_allocated;
+    stats.arena_reserved = arena->bytes_reserved;
+    codegen_free(codegen);
+    arena_free(arena);
+    
+    // Compile C code, then link it with the runtime
+    char o_filename[260];
+    snprintf(o_filename, sizeof(o_filename), "%.*s.o", (int)(strlen(c_filename) - 2), c_filename);
+    // --pgo-train builds twice: instrumented, then with the training profile
     printf("Compiling to executable: %s\n", output_file);
-    if (!compile_c_code(c_filename, output_file)) {
-        free(c_code);
-        codegen_free(codegen);
-        semantic_analyzer_free(analyzer);
-        ast_node_free(ast);
-        parser_free(parser);
-        lexer_free(lexer);
-        free(source_code);
+    bool built = true;
+    for (int pass = 0; pass < (pgo_train ? 2 : 1) && built; pass++) {
+        if (pgo_train) build_options.pgo = pass == 0 ? PGO_GENERATE : PGO_USE;
+        stats_begin(&stats, PHASE_COMPILE);
+        built = build_object(&build_options, c_filename, o_filename);
+        stats_end(&stats, PHASE_COMPILE);
+        if (built) {
+            stats_begin(&stats, PHASE_LINK);
+            built = build_link(&build_options, o_filename, output_file);
+            stats_end(&stats, PHASE_LINK);
+        }
+        if (built && pgo_train && pass == 0) {
+            built = build_pgo_train(&build_options, c_filename, o_filename, pgo_train);
+        }
+    }
+    remove(o_filename);
+    if (!built) {
+        release_source(&source);
         return 1;
     }
     
     printf("Compilation successful!\n");
     
+    if (time_report) stats_print(&stats, stdout);
+    if (stats_json) {
+        FILE* out = strcmp(stats_json, "-") == 0 ? stdout : fopen(stats_json, "w");
+        if (!out) {
+            fprintf(stderr, "Error: Cannot write '%s'\n", stats_json);
+            release_source(&source);
+            return 1;
+        }
+        stats_print_json(&stats, out);
+        if (out != stdout) fclose(out);
+    }
+    
     // Cleanup
-    free(c_code);
-    codegen_free(codegen);
-    semantic_analyzer_free(analyzer);
-    ast_node_free(ast);
-    parser_free(parser);
-    lexer_free(lexer);
-    free(source_code);
+    release_source(&source);
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,565 @@
+#include "optimize.h"
+#include <limits.h>
+#include <math.h>
+
+Optimizer* optimizer_new(SymbolTable* symbol_table) {
+    Optimizer* optimizer = arena_alloc(arena_current(), sizeof(Optimizer));
+    if (!optimizer) return NULL;
+
+    optimizer->symbol_table = symbol_table;
+    optimizer->folded = 0;
+    optimizer->eliminated = 0;
+    return optimizer;
+}
+
+static void optimize_block(Optimizer* optimizer, NodeArray* body);
+static ASTNode* fold_expression(Optimizer* optimizer, ASTNode* node);
+
+// Constant inspection
+static bool is_constant(const ASTNode* node) {
+    return node && node->type == AST_CONSTANT;
+}
+
+static bool is_numeric_constant(const ASTNode* node) {
+    if (!is_constant(node)) return false;
+
+    ConstantType type = node->constant.value.type;
+    return type == CONST_INT || type == CONST_FLOAT || type == CONST_BOOL;
+}
+
+static bool is_int_constant(const ASTNode* node, int value) {
+    return is_constant(node) && node->constant.value.type == CONST_INT &&
+           node->constant.value.int_val == value;
+}
+
+// bool behaves as int in arithmetic, as in Python
+static long long constant_as_int(const ASTNode* node) {
+    if (node->constant.value.type == CONST_BOOL) return node->constant.value.bool_val;
+    return node->constant.value.int_val;
+}
+
+static double constant_as_float(const ASTNode* node) {
+    if (node->constant.value.type == CONST_FLOAT) return node->constant.value.float_val;
+    return (double)constant_as_int(node);
+}
+
+static bool constant_truthy(const ASTNode* node) {
+    const ConstantValue* value = &node->constant.value;
+    switch (value->type) {
+        case CONST_INT: return value->int_val != 0;
+        case CONST_FLOAT: return value->float_val != 0.0;
+        case CONST_STRING: return value->str_val && value->str_val[0] != '\0';
+        case CONST_BOOL: return value->bool_val;
+        case CONST_NONE: return false;
+    }
+    return false;
+}
+
+// Constant construction. Results that do not fit the C int the constant is
+// emitted as are left unfolded; INT_MIN is excluded because its literal is
+// spelled as a negation of an out-of-range value in C.
+static ASTNode* make_int(Optimizer* optimizer, const ASTNode* original, long long value) {
+    if (value <= INT_MIN || value > INT_MAX) return NULL;
+
+    ASTNode* node = ast_constant_int_new((int)value);
+    if (!node) return NULL;
+    node->line_no = original->line_no;
+    optimizer->folded++;
+    return node;
+}
+
+static ASTNode* make_float(Optimizer* optimizer, const ASTNode* original, double value) {
+    if (!isfinite(value)) return NULL;
+
+    ASTNode* node = ast_constant_float_new(value);
+    if (!node) return NULL;
+    node->line_no = original->line_no;
+    optimizer->folded++;
+    return node;
+}
+
+static ASTNode* make_bool(Optimizer* optimizer, const ASTNode* original, bool value) {
+    ASTNode* node = ast_constant_bool_new(value);
+    if (!node) return NULL;
+    node->line_no = original->line_no;
+    optimizer->folded++;
+    return node;
+}
+
+long long int_floordiv(long long a, long long b) {
+    long long quotient = a / b;
+    if (a % b != 0 && (a < 0) != (b < 0)) quotient--;
+    return quotient;
+}
+
+long long int_mod(long long a, long long b) {
+    return a - int_floordiv(a, b) * b;
+}
+
+// Mirrors CPython's float_divmod, as pyrinas_floordiv_float and
+// pyrinas_mod_float do at run time
+void float_divmod(double a, double b, double* floordiv, double* mod) {
+    double m = fmod(a, b);
+    double div = (a - m) / b;
+
+    if (m != 0.0) {
+        if ((b < 0) != (m < 0)) {
+            m += b;
+            div -= 1.0;
+        }
+    } else {
+        m = copysign(0.0, b);
+    }
+
+    if (div != 0.0) {
+        double floored = floor(div);
+        if (div - floored > 0.5) floored += 1.0;
+        div = floored;
+    } else {
+        div = copysign(0.0, a / b);
+    }
+
+    *floordiv = div;
+    *mod = m;
+}
+
+static ASTNode* fold_arithmetic(Optimizer* optimizer, ASTNode* node) {
+    ASTNode* left = node->binop.left;
+    ASTNode* right = node->binop.right;
+    if (!is_numeric_constant(left) || !is_numeric_constant(right)) return NULL;
+
+    BinOpType op = node->binop.op;
+    bool is_float = left->constant.value.type == CONST_FLOAT ||
+                    right->constant.value.type == CONST_FLOAT;
+
+    if (is_float) {
+        double a = constant_as_float(left);
+        double b = constant_as_float(right);
+        double div, mod;
+
+        switch (op) {
+            case BINOP_ADD: return make_float(optimizer, node, a + b);
+            case BINOP_SUB: return make_float(optimizer, node, a - b);
+            case BINOP_MULT: return make_float(optimizer, node, a * b);
+            case BINOP_DIV:
+                if (b == 0.0) return NULL;
+                return make_float(optimizer, node, a / b);
+            case BINOP_FLOORDIV:
+            case BINOP_MOD:
+                if (b == 0.0) return NULL;
+                float_divmod(a, b, &div, &mod);
+                return make_float(optimizer, node, op == BINOP_MOD ? mod : div);
+        }
+        return NULL;
+    }
+
+    long long a = constant_as_int(left);
+    long long b = constant_as_int(right);
+
+    switch (op) {
+        case BINOP_ADD: return make_int(optimizer, node, a + b);
+        case BINOP_SUB: return make_int(optimizer, node, a - b);
+        case BINOP_MULT: return make_int(optimizer, node, a * b);
+        case BINOP_DIV:
+            // int / int is true division in Python but is emitted as C integer
+            // division, so folding it would change what the program computes
+            return NULL;
+        case BINOP_FLOORDIV:
+            if (b == 0 || (b == -1 && a == LLONG_MIN)) return NULL;
+            return make_int(optimizer, node, int_floordiv(a, b));
+        case BINOP_MOD:
+            if (b == 0 || (b == -1 && a == LLONG_MIN)) return NULL;
+            return make_int(optimizer, node, int_mod(a, b));
+    }
+    return NULL;
+}
+
+// Identities that hold for int and float operands alike. x + 0 is not one
+// of them: -0.0 + 0 is 0.0.
+static ASTNode* simplify_binop(Optimizer* optimizer, ASTNode* node) {
+    ASTNode* left = node->binop.left;
+    ASTNode* right = node->binop.right;
+
+    switch (node->binop.op) {
+        case BINOP_MULT:
+            if (is_int_constant(right, 1)) break;
+            if (is_int_constant(left, 1)) {
+                optimizer->folded++;
+                return right;
+            }
+            return node;
+        case BINOP_SUB:
+            if (is_int_constant(right, 0)) break;
+            return node;
+        default:
+            return node;
+    }
+
+    optimizer->folded++;
+    return left;
+}
+
+static ASTNode* fold_binop(Optimizer* optimizer, ASTNode* node) {
+    node->binop.left = fold_expression(optimizer, node->binop.left);
+    node->binop.right = fold_expression(optimizer, node->binop.right);
+
+    ASTNode* folded = fold_arithmetic(optimizer, node);
+    return folded ? folded : simplify_binop(optimizer, node);
+}
+
+static ASTNode* fold_unaryop(Optimizer* optimizer, ASTNode* node) {
+    ASTNode* operand = fold_expression(optimizer, node->unaryop.operand);
+    node->unaryop.operand = operand;
+
+    if (is_constant(operand)) {
+        ASTNode* folded = NULL;
+
+        if (node->unaryop.op == UNARYOP_NOT) {
+            folded = make_bool(optimizer, node, !constant_truthy(operand));
+        } else if (operand->constant.value.type == CONST_FLOAT) {
+            double value = operand->constant.value.float_val;
+            folded = make_float(optimizer, node, node->unaryop.op == UNARYOP_USUB ? -value : value);
+        } else if (is_numeric_constant(operand)) {
+            long long value = constant_as_int(operand);
+            folded = make_int(optimizer, node, node->unaryop.op == UNARYOP_USUB ? -value : value);
+        }
+        if (folded) return folded;
+    }
+
+    // -(-x) and +x
+    if (node->unaryop.op == UNARYOP_UADD) {
+        optimizer->folded++;
+        return operand;
+    }
+    if (node->unaryop.op == UNARYOP_USUB && operand->type == AST_UNARYOP &&
+        operand->unaryop.op == UNARYOP_USUB) {
+        optimizer->folded++;
+        return operand->unaryop.operand;
+    }
+    return node;
+}
+
+static bool compare_constants(CompareOpType op, const ASTNode* left, const ASTNode* right, bool* result) {
+    if (is_numeric_constant(left) && is_numeric_constant(right)) {
+        double a = constant_as_float(left);
+        double b = constant_as_float(right);
+
+        // Compare ints exactly rather than through double
+        if (left->constant.value.type != CONST_FLOAT && right->constant.value.type != CONST_FLOAT) {
+            long long ia = constant_as_int(left);
+            long long ib = constant_as_int(right);
+            a = ia < ib ? -1.0 : ia > ib ? 1.0 : 0.0;
+            b = 0.0;
+        }
+
+        switch (op) {
+            case CMP_EQ: *result = a == b; return true;
+            case CMP_NOTEQ: *result = a != b; return true;
+            case CMP_LT: *result = a < b; return true;
+            case CMP_LTE: *result = a <= b; return true;
+            case CMP_GT: *result = a > b; return true;
+            case CMP_GTE: *result = a >= b; return true;
+        }
+        return false;
+    }
+
+    if (is_constant(left) && is_constant(right) &&
+        left->constant.value.type == CONST_STRING && right->constant.value.type == CONST_STRING &&
+        (op == CMP_EQ || op == CMP_NOTEQ)) {
+        bool equal = strcmp(left->constant.value.str_val, right->constant.value.str_val) == 0;
+        *result = op == CMP_EQ ? equal : !equal;
+        return true;
+    }
+
+    return false;
+}
+
+static ASTNode* fold_compare(Optimizer* optimizer, ASTNode* node) {
+    node->compare.left = fold_expression(optimizer, node->compare.left);
+
+    NodeArray* comparators = node->compare.comparators;
+    if (!comparators) return node;
+
+    bool all_constant = is_constant(node->compare.left);
+    for (size_t i = 0; i < comparators->count; i++) {
+        comparators->items[i] = fold_expression(optimizer, comparators->items[i]);
+        all_constant = all_constant && is_constant(comparators->items[i]);
+    }
+    if (!all_constant || !node->compare.ops || node->compare.ops_count != comparators->count) {
+        return node;
+    }
+
+    // Chained comparisons: a < b < c is (a < b) and (b < c)
+    const ASTNode* left = node->compare.left;
+    for (size_t i = 0; i < comparators->count; i++) {
+        bool result;
+        if (!compare_constants(node->compare.ops[i], left, comparators->items[i], &result)) {
+            return node;
+        }
+        if (!result) break;
+        if (i + 1 == comparators->count) {
+            ASTNode* folded = make_bool(optimizer, node, true);
+            return folded ? folded : node;
+        }
+        left = comparators->items[i];
+    }
+
+    ASTNode* folded = make_bool(optimizer, node, false);
+    return folded ? folded : node;
+}
+
+// `and`/`or` yield one of their operands. Leading constants decide the
+// result or can be dropped: `True and x` is x, `0 or x` is x.
+static ASTNode* fold_boolop(Optimizer* optimizer, ASTNode* node) {
+    NodeArray* values = node->boolop.values;
+    if (!values || values->count == 0) return node;
+
+    for (size_t i = 0; i < values->count; i++) {
+        values->items[i] = fold_expression(optimizer, values->items[i]);
+    }
+
+    bool decides_on = node->boolop.op == BOOLOP_OR;
+    size_t first = 0;
+    while (first < values->count - 1 && is_constant(values->items[first])) {
+        if (constant_truthy(values->items[first]) == decides_on) break;
+        first++;
+    }
+
+    if (first > 0) {
+        optimizer->folded++;
+        memmove(values->items, values->items + first, (values->count - first) * sizeof(ASTNode*));
+        values->count -= first;
+    }
+
+    ASTNode* head = values->items[0];
+    if (values->count == 1 || (is_constant(head) && constant_truthy(head) == decides_on)) {
+        if (values->count > 1) optimizer->folded++;
+        return head;
+    }
+    return node;
+}
+
+// Enum members resolve to their declared values
+static ASTNode* fold_attribute(Optimizer* optimizer, ASTNode* node) {
+    ASTNode* value = node->attribute.value;
+
+    if (value && value->type == AST_NAME && node->attribute.ctx == CTX_LOAD) {
+        Symbol* symbol = symbol_table_lookup(optimizer->symbol_table, value->name.id);
+        if (symbol && symbol->type == SYM_ENUM) {
+            for (size_t i = 0; i < symbol->enum_members.member_count; i++) {
+                if (strcmp(symbol->enum_members.member_names[i], node->attribute.attr) == 0) {
+                    ASTNode* folded = make_int(optimizer, node, symbol->enum_members.member_values[i]);
+                    return folded ? folded : node;
+                }
+            }
+        }
+        return node;
+    }
+
+    node->attribute.value = fold_expression(optimizer, value);
+    return node;
+}
+
+static void fold_array(Optimizer* optimizer, NodeArray* array) {
+    if (!array) return;
+
+    for (size_t i = 0; i < array->count; i++) {
+        array->items[i] = fold_expression(optimizer, array->items[i]);
+    }
+}
+
+// Returns the node to use in place of `node`
+static ASTNode* fold_expression(Optimizer* optimizer, ASTNode* node) {
+    if (!node) return NULL;
+
+    switch (node->type) {
+        case AST_BINOP:
+            return fold_binop(optimizer, node);
+        case AST_UNARYOP:
+            return fold_unaryop(optimizer, node);
+        case AST_COMPARE:
+            return fold_compare(optimizer, node);
+        case AST_BOOLOP:
+            return fold_boolop(optimizer, node);
+        case AST_ATTRIBUTE:
+            return fold_attribute(optimizer, node);
+        case AST_CALL:
+            if (node->call.func->type != AST_NAME) {
+                node->call.func = fold_expression(optimizer, node->call.func);
+            }
+            fold_array(optimizer, node->call.args);
+            return node;
+        case AST_SUBSCRIPT:
+            node->subscript.value = fold_expression(optimizer, node->subscript.value);
+            node->subscript.slice = fold_expression(optimizer, node->subscript.slice);
+            return node;
+        default:
+            return node;
+    }
+}
+
+// Assignment targets keep their shape; only their index and object
+// expressions are folded
+static void fold_target(Optimizer* optimizer, ASTNode* target) {
+    if (!target) return;
+
+    if (target->type == AST_SUBSCRIPT) {
+        target->subscript.value = fold_expression(optimizer, target->subscript.value);
+        target->subscript.slice = fold_expression(optimizer, target->subscript.slice);
+    } else if (target->type == AST_ATTRIBUTE) {
+        fold_target(optimizer, target->attribute.value);
+    }
+}
+
+// Statements
+static bool ends_block(const ASTNode* node) {
+    return node->type == AST_RETURN || node->type == AST_BREAK || node->type == AST_CONTINUE;
+}
+
+// Declarations must stay inside their C block, so a branch that declares
+// variables is not spliced into the enclosing block
+static bool block_declares(const NodeArray* body) {
+    for (size_t i = 0; i < body->count; i++) {
+        if (body->items[i]->type == AST_ANN_ASSIGN) return true;
+    }
+    return false;
+}
+
+static void emit_statements(NodeArray* out, const NodeArray* body) {
+    for (size_t i = 0; i < body->count; i++) {
+        node_array_push(out, body->items[i]);
+    }
+}
+
+// Resolves an `if` whose test folded to a constant. Pushes whatever replaces
+// it onto `out`.
+static void emit_constant_if(Optimizer* optimizer, ASTNode* node, NodeArray* out) {
+    NodeArray* taken = constant_truthy(node->if_stmt.test) ? node->if_stmt.body : node->if_stmt.orelse;
+
+    if (!taken || taken->count == 0) {
+        optimizer->eliminated++;
+        return;
+    }
+
+    if (!block_declares(taken)) {
+        optimizer->eliminated++;
+        emit_statements(out, taken);
+        return;
+    }
+
+    // Keep a block for the declarations: if (1) { taken }
+    if (taken != node->if_stmt.body) {
+        ASTNode* test = make_bool(optimizer, node->if_stmt.test, true);
+        if (!test) {
+            node_array_push(out, node);
+            return;
+        }
+        node->if_stmt.test = test;
+        node->if_stmt.body = taken;
+    }
+    node->if_stmt.orelse = NULL;
+    node_array_push(out, node);
+}
+
+static void optimize_statement(Optimizer* optimizer, ASTNode* node, NodeArray* out) {
+    switch (node->type) {
+        case AST_FUNCTION_DEF:
+            optimize_block(optimizer, node->function_def.body);
+            break;
+        case AST_CLASS_DEF:
+            optimize_block(optimizer, node->class_def.body);
+            break;
+        case AST_ASSIGN:
+            if (node->assign.targets) {
+                for (size_t i = 0; i < node->assign.targets->count; i++) {
+                    fold_target(optimizer, node->assign.targets->items[i]);
+                }
+            }
+            node->assign.value = fold_expression(optimizer, node->assign.value);
+            break;
+        case AST_ANN_ASSIGN:
+            fold_target(optimizer, node->ann_assign.target);
+            node->ann_assign.value = fold_expression(optimizer, node->ann_assign.value);
+            break;
+        case AST_IF:
+            node->if_stmt.test = fold_expression(optimizer, node->if_stmt.test);
+            optimize_block(optimizer, node->if_stmt.body);
+            optimize_block(optimizer, node->if_stmt.orelse);
+            if (is_constant(node->if_stmt.test)) {
+                emit_constant_if(optimizer, node, out);
+                return;
+            }
+            break;
+        case AST_WHILE:
+            node->while_stmt.test = fold_expression(optimizer, node->while_stmt.test);
+            if (is_constant(node->while_stmt.test) && !constant_truthy(node->while_stmt.test)) {
+                optimizer->eliminated++;
+                return;
+            }
+            optimize_block(optimizer, node->while_stmt.body);
+            break;
+        case AST_FOR:
+            node->for_stmt.iter = fold_expression(optimizer, node->for_stmt.iter);
+            optimize_block(optimizer, node->for_stmt.body);
+            break;
+        case AST_RETURN:
+            node->return_stmt.value = fold_expression(optimizer, node->return_stmt.value);
+            break;
+        case AST_EXPR_STMT:
+            node->expr_stmt.value = fold_expression(optimizer, node->expr_stmt.value);
+            if (is_constant(node->expr_stmt.value)) {
+                // Bare constants (docstrings) have no effect
+                optimizer->eliminated++;
+                return;
+            }
+            break;
+        case AST_MATCH:
+            node->match_stmt.subject = fold_expression(optimizer, node->match_stmt.subject);
+            if (node->match_stmt.cases) {
+                for (size_t i = 0; i < node->match_stmt.cases->count; i++) {
+                    optimize_block(optimizer, node->match_stmt.cases->items[i]->match_case.body);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+
+    node_array_push(out, node);
+}
+
+// Rebuilds `body` in place, dropping dead statements, splicing resolved
+// branches and discarding anything after a return, break or continue
+static void optimize_block(Optimizer* optimizer, NodeArray* body) {
+    if (!body) return;
+
+    NodeArray* out = node_array_new();
+    if (!out) return;
+
+    for (size_t i = 0; i < body->count; i++) {
+        ASTNode* node = body->items[i];
+        if (!node) continue;
+
+        optimize_statement(optimizer, node, out);
+
+        if (out->count > 0 && ends_block(out->items[out->count - 1])) {
+            optimizer->eliminated += body->count - i - 1;
+            break;
+        }
+    }
+
+    *body = *out;
+}
+
+bool optimize_ast(Optimizer* optimizer, ASTNode* node) {
+    if (!optimizer || !node) return false;
+
+    if (node->type == AST_MODULE) {
+        optimize_block(optimizer, node->module.body);
+    } else {
+        NodeArray* out = node_array_new();
+        if (!out) return false;
+        optimize_statement(optimizer, node, out);
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include "ast.h"
+#include "semantic.h"
+#include <stdbool.h>
+
+// AST optimizer. Runs after semantic analysis and rewrites the tree in
+// place: constant folding with Python semantics, algebraic identities and
+// removal of statically dead statements.
+typedef struct {
+    SymbolTable* symbol_table;  // Resolves enum members to their values
+    size_t folded;              // Expressions replaced by a simpler one
+    size_t eliminated;          // Statements removed as dead
+} Optimizer;
+
+Optimizer* optimizer_new(SymbolTable* symbol_table);
+bool optimize_ast(Optimizer* optimizer, ASTNode* node);
+
+// Python floor division and modulo: the quotient rounds toward negative
+// infinity and the remainder takes the sign of the divisor. Shared with
+// compile-time evaluation.
+long long int_floordiv(long long a, long long b);
+long long int_mod(long long a, long long b);
+void float_divmod(double a, double b, double* floordiv, double* mod);
+
+#endif // OPTIMIZE_H
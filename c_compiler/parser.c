@@ -2,7 +2,7 @@
 
 // Parser management
 Parser* parser_new(TokenArray* tokens) {
-    Parser* parser = malloc(sizeof(Parser));
+    Parser* parser = arena_alloc(arena_current(), sizeof(Parser));
     if (!parser) return NULL;
     
     parser->tokens = tokens;
@@ -13,13 +13,6 @@ Parser* parser_new(TokenArray* tokens) {
     return parser;
 }
 
-void parser_free(Parser* parser) {
-    if (parser) {
-        free(parser->error_message);
-        free(parser);
-    }
-}
-
 // Token utilities
 Token* current_token(Parser* parser) {
     if (parser->current >= parser->tokens->count) {
@@ -62,8 +55,7 @@ bool at_end(Parser* parser) {
 // Error handling
 void parser_error(Parser* parser, const char* message) {
     parser->has_error = true;
-    free(parser->error_message);
-    parser->error_message = strdup(message);
+    parser->error_message = arena_strdup(arena_current(), message);
 }
 
 // Skip newlines and comments
@@ -86,7 +78,6 @@ ASTNode* parser_parse(Parser* parser) {
         }
         
         if (parser->has_error) {
-            node_array_free(body);
             return NULL;
         }
         
@@ -106,6 +97,8 @@ ASTNode* parse_statement(Parser* parser) {
     switch (token->type) {
         case TOK_DEF:
             return parse_function_def(parser);
+        case TOK_AT:
+            return parse_decorated_definition(parser);
         case TOK_CLASS:
             return parse_class_def(parser);
         case TOK_IF:
@@ -144,12 +137,12 @@ ASTNode* parse_function_def(Parser* parser) {
         parser_error(parser, "Expected function name");
         return NULL;
     }
-    char* name = strdup(name_token->value);
+    const char* name = token_intern(parser->tokens, name_token);
+    int line = name_token->line;
     advance_token(parser);
     
     if (!consume_token(parser, TOK_LPAREN)) {
         parser_error(parser, "Expected '(' after function name");
-        free(name);
         return NULL;
     }
     
@@ -157,8 +150,6 @@ ASTNode* parse_function_def(Parser* parser) {
     
     if (!consume_token(parser, TOK_RPAREN)) {
         parser_error(parser, "Expected ')' after parameters");
-        free(name);
-        ast_node_free(args);
         return NULL;
     }
     
@@ -169,9 +160,6 @@ ASTNode* parse_function_def(Parser* parser) {
     
     if (!consume_token(parser, TOK_COLON)) {
         parser_error(parser, "Expected ':' after function signature");
-        free(name);
-        ast_node_free(args);
-        ast_node_free(returns);
         return NULL;
     }
     
@@ -179,9 +167,6 @@ ASTNode* parse_function_def(Parser* parser) {
     
     if (!consume_token(parser, TOK_INDENT)) {
         parser_error(parser, "Expected indented block after ':'");
-        free(name);
-        ast_node_free(args);
-        ast_node_free(returns);
         return NULL;
     }
     
@@ -189,15 +174,35 @@ ASTNode* parse_function_def(Parser* parser) {
     
     if (!consume_token(parser, TOK_DEDENT)) {
         parser_error(parser, "Expected dedent after function body");
-        free(name);
-        ast_node_free(args);
-        ast_node_free(returns);
-        node_array_free(body);
         return NULL;
     }
     
     ASTNode* function = ast_function_def_new(name, args, returns, body, NULL);
-    free(name);
+    function->line_no = line;
+    return function;
+}
+
+// One or more `@decorator` lines, each a name or a call, before a def
+ASTNode* parse_decorated_definition(Parser* parser) {
+    NodeArray* decorators = node_array_new();
+    
+    while (consume_token(parser, TOK_AT)) {
+        ASTNode* decorator = parse_expression(parser);
+        if (!decorator) {
+            parser_error(parser, "Expected decorator after '@'");
+            return NULL;
+        }
+        node_array_push(decorators, decorator);
+        skip_newlines(parser);
+    }
+    
+    if (!match_token(parser, TOK_DEF)) {
+        parser_error(parser, "Expected 'def' after decorators");
+        return NULL;
+    }
+    
+    ASTNode* function = parse_function_def(parser);
+    if (function) function->function_def.decorator_list = decorators;
     return function;
 }
 
@@ -212,7 +217,7 @@ ASTNode* parse_class_def(Parser* parser) {
         parser_error(parser, "Expected class name");
         return NULL;
     }
-    char* name = strdup(name_token->value);
+    const char* name = token_intern(parser->tokens, name_token);
     advance_token(parser);
     
     NodeArray* bases = node_array_new();
@@ -230,16 +235,12 @@ ASTNode* parse_class_def(Parser* parser) {
         
         if (!consume_token(parser, TOK_RPAREN)) {
             parser_error(parser, "Expected ')' after base classes");
-            free(name);
-            node_array_free(bases);
             return NULL;
         }
     }
     
     if (!consume_token(parser, TOK_COLON)) {
         parser_error(parser, "Expected ':' after class name");
-        free(name);
-        node_array_free(bases);
         return NULL;
     }
     
@@ -247,8 +248,6 @@ ASTNode* parse_class_def(Parser* parser) {
     
     if (!consume_token(parser, TOK_INDENT)) {
         parser_error(parser, "Expected indented block after ':'");
-        free(name);
-        node_array_free(bases);
         return NULL;
     }
     
@@ -256,14 +255,10 @@ ASTNode* parse_class_def(Parser* parser) {
     
     if (!consume_token(parser, TOK_DEDENT)) {
         parser_error(parser, "Expected dedent after class body");
-        free(name);
-        node_array_free(bases);
-        node_array_free(body);
         return NULL;
     }
     
     ASTNode* class_def = ast_class_def_new(name, bases, body);
-    free(name);
     return class_def;
 }
 
@@ -281,7 +276,6 @@ ASTNode* parse_if_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_COLON)) {
         parser_error(parser, "Expected ':' after if condition");
-        ast_node_free(test);
         return NULL;
     }
     
@@ -289,7 +283,6 @@ ASTNode* parse_if_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_INDENT)) {
         parser_error(parser, "Expected indented block after ':'");
-        ast_node_free(test);
         return NULL;
     }
     
@@ -297,8 +290,6 @@ ASTNode* parse_if_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_DEDENT)) {
         parser_error(parser, "Expected dedent after if body");
-        ast_node_free(test);
-        node_array_free(body);
         return NULL;
     }
     
@@ -309,9 +300,6 @@ ASTNode* parse_if_statement(Parser* parser) {
         advance_token(parser);
         if (!consume_token(parser, TOK_COLON)) {
             parser_error(parser, "Expected ':' after 'else'");
-            ast_node_free(test);
-            node_array_free(body);
-            node_array_free(orelse);
             return NULL;
         }
         
@@ -319,9 +307,6 @@ ASTNode* parse_if_statement(Parser* parser) {
         
         if (!consume_token(parser, TOK_INDENT)) {
             parser_error(parser, "Expected indented block after ':'");
-            ast_node_free(test);
-            node_array_free(body);
-            node_array_free(orelse);
             return NULL;
         }
         
@@ -329,10 +314,6 @@ ASTNode* parse_if_statement(Parser* parser) {
         
         if (!consume_token(parser, TOK_DEDENT)) {
             parser_error(parser, "Expected dedent after else body");
-            ast_node_free(test);
-            node_array_free(body);
-            node_array_free(orelse);
-            node_array_free(else_body);
             return NULL;
         }
         
@@ -340,8 +321,6 @@ ASTNode* parse_if_statement(Parser* parser) {
         for (size_t i = 0; i < else_body->count; i++) {
             node_array_push(orelse, else_body->items[i]);
         }
-        free(else_body->items);
-        free(else_body);
     }
     
     return ast_if_new(test, body, orelse);
@@ -361,7 +340,6 @@ ASTNode* parse_while_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_COLON)) {
         parser_error(parser, "Expected ':' after while condition");
-        ast_node_free(test);
         return NULL;
     }
     
@@ -369,7 +347,6 @@ ASTNode* parse_while_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_INDENT)) {
         parser_error(parser, "Expected indented block after ':'");
-        ast_node_free(test);
         return NULL;
     }
     
@@ -377,8 +354,6 @@ ASTNode* parse_while_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_DEDENT)) {
         parser_error(parser, "Expected dedent after while body");
-        ast_node_free(test);
-        node_array_free(body);
         return NULL;
     }
     
@@ -399,21 +374,17 @@ ASTNode* parse_for_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_IN)) {
         parser_error(parser, "Expected 'in' after for variable");
-        ast_node_free(target);
         return NULL;
     }
     
     ASTNode* iter = parse_expression(parser);
     if (!iter) {
         parser_error(parser, "Expected iterable after 'in'");
-        ast_node_free(target);
         return NULL;
     }
     
     if (!consume_token(parser, TOK_COLON)) {
         parser_error(parser, "Expected ':' after for clause");
-        ast_node_free(target);
-        ast_node_free(iter);
         return NULL;
     }
     
@@ -421,8 +392,6 @@ ASTNode* parse_for_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_INDENT)) {
         parser_error(parser, "Expected indented block after ':'");
-        ast_node_free(target);
-        ast_node_free(iter);
         return NULL;
     }
     
@@ -430,9 +399,6 @@ ASTNode* parse_for_statement(Parser* parser) {
     
     if (!consume_token(parser, TOK_DEDENT)) {
         parser_error(parser, "Expected dedent after for body");
-        ast_node_free(target);
-        ast_node_free(iter);
-        node_array_free(body);
         return NULL;
     }
     
@@ -570,7 +536,7 @@ ASTNode* parse_comparison(Parser* parser) {
         
         ASTNode* right = parse_arithmetic_expression(parser);
         
-        CompareOpType* ops = malloc(sizeof(CompareOpType));
+        CompareOpType* ops = arena_alloc(arena_current(), sizeof(CompareOpType));
         ops[0] = op;
         
         NodeArray* comparators = node_array_new();
@@ -645,11 +611,13 @@ ASTNode* parse_primary(Parser* parser) {
     switch (token->type) {
         case TOK_NUMBER: {
             // Determine if it's int or float
-            if (strchr(token->value, '.')) {
-                double value = atof(token->value);
+            char text[64];
+            token_copy(parser->tokens, token, text, sizeof(text));
+            if (memchr(token_text(parser->tokens, token), '.', token->length)) {
+                double value = atof(text);
                 node = ast_constant_float_new(value);
             } else {
-                int value = atoi(token->value);
+                int value = atoi(text);
                 node = ast_constant_int_new(value);
             }
             advance_token(parser);
@@ -657,7 +625,7 @@ ASTNode* parse_primary(Parser* parser) {
         }
         
         case TOK_STRING:
-            node = ast_constant_string_new(token->value);
+            node = ast_constant_string_new(token_string_value(parser->tokens, token));
             advance_token(parser);
             break;
             
@@ -677,7 +645,7 @@ ASTNode* parse_primary(Parser* parser) {
             break;
             
         case TOK_IDENTIFIER:
-            node = ast_name_new(token->value, CTX_LOAD);
+            node = ast_name_new(token_intern(parser->tokens, token), CTX_LOAD);
             advance_token(parser);
             break;
             
@@ -686,7 +654,6 @@ ASTNode* parse_primary(Parser* parser) {
             node = parse_expression(parser);
             if (!consume_token(parser, TOK_RPAREN)) {
                 parser_error(parser, "Expected ')' after expression");
-                ast_node_free(node);
                 return NULL;
             }
             break;
@@ -731,7 +698,6 @@ ASTNode* parse_call(Parser* parser, ASTNode* func) {
     
     if (!consume_token(parser, TOK_RPAREN)) {
         parser_error(parser, "Expected ')' after arguments");
-        node_array_free(args);
         return func;
     }
     
@@ -749,11 +715,10 @@ ASTNode* parse_attribute(Parser* parser, ASTNode* value) {
         return value;
     }
     
-    char* attr = strdup(attr_token->value);
+    const char* attr = token_intern(parser->tokens, attr_token);
     advance_token(parser);
     
     ASTNode* result = ast_attribute_new(value, attr, CTX_LOAD);
-    free(attr);
     return result;
 }
 
@@ -770,7 +735,6 @@ ASTNode* parse_subscript(Parser* parser, ASTNode* value) {
     
     if (!consume_token(parser, TOK_RBRACKET)) {
         parser_error(parser, "Expected ']' after subscript");
-        ast_node_free(slice);
         return value;
     }
     
@@ -786,11 +750,10 @@ ASTNode* parse_arguments(Parser* parser) {
             Token* name_token = current_token(parser);
             if (!match_token(parser, TOK_IDENTIFIER)) {
                 parser_error(parser, "Expected parameter name");
-                node_array_free(args);
                 return NULL;
             }
             
-            char* arg_name = strdup(name_token->value);
+            const char* arg_name = token_intern(parser->tokens, name_token);
             advance_token(parser);
             
             ASTNode* annotation = NULL;
@@ -800,7 +763,6 @@ ASTNode* parse_arguments(Parser* parser) {
             
             ASTNode* arg = ast_arg_new(arg_name, annotation);
             node_array_push(args, arg);
-            free(arg_name);
             
         } while (consume_token(parser, TOK_COMMA));
     }
@@ -827,8 +789,10 @@ NodeArray* parse_statement_list(Parser* parser) {
     NodeArray* statements = node_array_new();
     
     while (!match_token(parser, TOK_DEDENT) && !at_end(parser)) {
+        int line = current_token(parser)->line;
         ASTNode* stmt = parse_statement(parser);
         if (stmt) {
+            if (!stmt->line_no) stmt->line_no = line;
             node_array_push(statements, stmt);
         }
         
@@ -847,62 +811,46 @@ ASTNode* parse_type_annotation(Parser* parser) {
     if (!token) return NULL;
     
     if (match_token(parser, TOK_IDENTIFIER)) {
-        ASTNode* name = ast_name_new(token->value, CTX_LOAD);
+        ASTNode* name = ast_name_new(token_intern(parser->tokens, token), CTX_LOAD);
         advance_token(parser);
         
-        // Check for subscript-style types like array[int, 5]
-        if (match_token(parser, TOK_LBRACKET)) {
-            advance_token(parser); // consume '['
-            
-            // Parse the slice - for array[int, 5], we need to handle the comma
-            // For now, let's create a simple comma-separated list
-            ASTNode* slice = NULL;
-            Token* token = current_token(parser);
-            if (token && token->type == TOK_IDENTIFIER) {
-                // First element (type name)
-                slice = ast_name_new(token->value, CTX_LOAD);
+        // Subscript-style types: ptr[int], array[int, 5], Result[int, str]
+        if (!consume_token(parser, TOK_LBRACKET)) {
+            return name;
+        }
+        
+        NodeArray* elts = node_array_new();
+        do {
+            Token* elt_token = current_token(parser);
+            ASTNode* elt;
+            if (elt_token && elt_token->type == TOK_NUMBER) {
+                // Array length
+                char text[64];
+                token_copy(parser->tokens, elt_token, text, sizeof(text));
+                elt = ast_constant_int_new(atoi(text));
                 advance_token(parser);
-                
-                // Check for comma and second element (size)
-                if (match_token(parser, TOK_COMMA)) {
-                    advance_token(parser); // consume comma
-                    token = current_token(parser);
-                    if (token && token->type == TOK_NUMBER) {
-                        // For now, just ignore the size - we have the type
-                        advance_token(parser);
-                    }
-                }
             } else {
-                // Fallback to expression parsing
-                slice = parse_expression(parser);
-            }
-            
-            if (!slice) {
-                ast_node_free(name);
-                return NULL;
-            }
-            
-            if (!match_token(parser, TOK_RBRACKET)) {
-                ast_node_free(name);
-                ast_node_free(slice);
-                return NULL;
+                elt = parse_type_annotation(parser);
             }
-            advance_token(parser); // consume ']'
             
-            // Create subscript node  
-            ASTNode* subscript = ast_subscript_new(name, slice, CTX_LOAD);
-            if (!subscript) {
-                ast_node_free(name);
-                ast_node_free(slice);
+            if (!elt) {
+                parser_error(parser, "Expected type argument");
                 return NULL;
             }
-            
-            return subscript;
+            node_array_push(elts, elt);
+        } while (consume_token(parser, TOK_COMMA));
+        
+        if (!consume_token(parser, TOK_RBRACKET)) {
+            parser_error(parser, "Expected ']' after type arguments");
+            return NULL;
         }
         
-        return name;
-    } else if (match_token(parser, TOK_STRING)) {
-        ASTNode* str = ast_constant_string_new(token->value);
+        ASTNode* slice = elts->count == 1 ? elts->items[0] : ast_tuple_new(elts);
+        return ast_subscript_new(name, slice, CTX_LOAD);
+    }
+    
+    if (match_token(parser, TOK_STRING)) {
+        ASTNode* str = ast_constant_string_new(token_string_value(parser->tokens, token));
         advance_token(parser);
         return str;
     }
@@ -13,7 +13,6 @@ typedef struct {
 
 // Parser management
 Parser* parser_new(TokenArray* tokens);
-void parser_free(Parser* parser);
 
 // Main parsing function
 ASTNode* parser_parse(Parser* parser);
@@ -21,6 +20,7 @@ ASTNode* parser_parse(Parser* parser);
 // Statement parsing
 ASTNode* parse_statement(Parser* parser);
 ASTNode* parse_function_def(Parser* parser);
+ASTNode* parse_decorated_definition(Parser* parser);
 ASTNode* parse_class_def(Parser* parser);
 ASTNode* parse_if_statement(Parser* parser);
 ASTNode* parse_while_statement(Parser* parser);
@@ -1,16 +1,17 @@
 #include "semantic.h"
+#include "comptime.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
 // Symbol management
-Symbol* symbol_new(const char* name, SymbolType type, const char* value_type) {
-    Symbol* symbol = malloc(sizeof(Symbol));
+Symbol* symbol_new(const char* name, SymbolType type, const Type* value_type) {
+    Symbol* symbol = arena_alloc(arena_current(), sizeof(Symbol));
     if (!symbol) return NULL;
     
-    symbol->name = name ? strdup(name) : NULL;
+    symbol->name = intern(name);
     symbol->type = type;
-    symbol->value_type = value_type ? strdup(value_type) : NULL;
+    symbol->value_type = value_type;
     
     // Initialize function-specific fields
     symbol->param_types = NULL;
@@ -34,6 +35,10 @@ Symbol* symbol_new(const char* name, SymbolType type, const char* value_type) {
     // Initialize flags
     symbol->immutable = false;
     symbol->is_c_function = false;
+    symbol->is_comptime = false;
+    symbol->is_inline = false;
+    symbol->definition = NULL;
+    symbol->loop_bound = 0;
     symbol->c_library = NULL;
     symbol->implements = NULL;
     symbol->exports = NULL;
@@ -41,186 +46,150 @@ Symbol* symbol_new(const char* name, SymbolType type, const char* value_type) {
     return symbol;
 }
 
-void symbol_free(Symbol* symbol) {
-    if (!symbol) return;
-    
-    free(symbol->name);
-    free(symbol->value_type);
-    free(symbol->return_type);
-    free(symbol->c_library);
-    
-    if (symbol->param_types) {
-        string_array_free(symbol->param_types);
-    }
-    
-    // Free struct fields
-    for (size_t i = 0; i < symbol->fields.field_count; i++) {
-        free(symbol->fields.field_names[i]);
-        free(symbol->fields.field_types[i]);
-    }
-    free(symbol->fields.field_names);
-    free(symbol->fields.field_types);
-    
-    // Free methods
-    for (size_t i = 0; i < symbol->methods.method_count; i++) {
-        free(symbol->methods.method_names[i]);
-        string_array_free(symbol->methods.method_param_types[i]);
-        free(symbol->methods.method_return_types[i]);
-    }
-    free(symbol->methods.method_names);
-    free(symbol->methods.method_param_types);
-    free(symbol->methods.method_return_types);
-    
-    // Free enum members
-    for (size_t i = 0; i < symbol->enum_members.member_count; i++) {
-        free(symbol->enum_members.member_names[i]);
-    }
-    free(symbol->enum_members.member_names);
-    free(symbol->enum_members.member_values);
-    
-    if (symbol->implements) {
-        string_array_free(symbol->implements);
-    }
-    
-    if (symbol->exports) {
-        symbol_table_free(symbol->exports);
-    }
-    
-    free(symbol);
-}
-
-void symbol_add_field(Symbol* symbol, const char* field_name, const char* field_type) {
+void symbol_add_field(Symbol* symbol, const char* field_name, const Type* field_type) {
     if (!symbol || !field_name || !field_type) return;
     
-    // Reallocate arrays
-    symbol->fields.field_names = realloc(symbol->fields.field_names, 
-                                        sizeof(char*) * (symbol->fields.field_count + 1));
-    symbol->fields.field_types = realloc(symbol->fields.field_types, 
-                                        sizeof(char*) * (symbol->fields.field_count + 1));
+    // Grow arrays
+    size_t count = symbol->fields.field_count;
+    symbol->fields.field_names = arena_grow(arena_current(), symbol->fields.field_names,
+                                            sizeof(char*) * count, sizeof(char*) * (count + 1));
+    symbol->fields.field_types = arena_grow(arena_current(), symbol->fields.field_types,
+                                            sizeof(Type*) * count, sizeof(Type*) * (count + 1));
     
     if (!symbol->fields.field_names || !symbol->fields.field_types) return;
     
-    symbol->fields.field_names[symbol->fields.field_count] = strdup(field_name);
-    symbol->fields.field_types[symbol->fields.field_count] = strdup(field_type);
+    symbol->fields.field_names[count] = arena_strdup(arena_current(), field_name);
+    symbol->fields.field_types[count] = field_type;
     symbol->fields.field_count++;
 }
 
-void symbol_add_method(Symbol* symbol, const char* method_name, StringArray* param_types, const char* return_type) {
+void symbol_add_method(Symbol* symbol, const char* method_name, TypeList* param_types, const Type* return_type) {
     if (!symbol || !method_name) return;
     
-    // Reallocate arrays
-    symbol->methods.method_names = realloc(symbol->methods.method_names, 
-                                          sizeof(char*) * (symbol->methods.method_count + 1));
-    symbol->methods.method_param_types = realloc(symbol->methods.method_param_types, 
-                                                 sizeof(StringArray*) * (symbol->methods.method_count + 1));
-    symbol->methods.method_return_types = realloc(symbol->methods.method_return_types, 
-                                                  sizeof(char*) * (symbol->methods.method_count + 1));
+    // Grow arrays
+    size_t count = symbol->methods.method_count;
+    symbol->methods.method_names = arena_grow(arena_current(), symbol->methods.method_names,
+                                              sizeof(char*) * count, sizeof(char*) * (count + 1));
+    symbol->methods.method_param_types = arena_grow(arena_current(), symbol->methods.method_param_types,
+                                                    sizeof(TypeList*) * count,
+                                                    sizeof(TypeList*) * (count + 1));
+    symbol->methods.method_return_types = arena_grow(arena_current(), symbol->methods.method_return_types,
+                                                     sizeof(Type*) * count, sizeof(Type*) * (count + 1));
     
     if (!symbol->methods.method_names || !symbol->methods.method_param_types || 
         !symbol->methods.method_return_types) return;
     
-    symbol->methods.method_names[symbol->methods.method_count] = strdup(method_name);
-    symbol->methods.method_param_types[symbol->methods.method_count] = param_types;
-    symbol->methods.method_return_types[symbol->methods.method_count] = return_type ? strdup(return_type) : NULL;
+    symbol->methods.method_names[count] = arena_strdup(arena_current(), method_name);
+    symbol->methods.method_param_types[count] = param_types;
+    symbol->methods.method_return_types[count] = return_type;
     symbol->methods.method_count++;
 }
 
 void symbol_add_enum_member(Symbol* symbol, const char* member_name, int value) {
     if (!symbol || !member_name) return;
     
-    // Reallocate arrays
-    symbol->enum_members.member_names = realloc(symbol->enum_members.member_names, 
-                                               sizeof(char*) * (symbol->enum_members.member_count + 1));
-    symbol->enum_members.member_values = realloc(symbol->enum_members.member_values, 
-                                                 sizeof(int) * (symbol->enum_members.member_count + 1));
+    // Grow arrays
+    size_t count = symbol->enum_members.member_count;
+    symbol->enum_members.member_names = arena_grow(arena_current(), symbol->enum_members.member_names,
+                                                   sizeof(char*) * count, sizeof(char*) * (count + 1));
+    symbol->enum_members.member_values = arena_grow(arena_current(), symbol->enum_members.member_values,
+                                                    sizeof(int) * count, sizeof(int) * (count + 1));
     
     if (!symbol->enum_members.member_names || !symbol->enum_members.member_values) return;
     
-    symbol->enum_members.member_names[symbol->enum_members.member_count] = strdup(member_name);
-    symbol->enum_members.member_values[symbol->enum_members.member_count] = value;
+    symbol->enum_members.member_names[count] = arena_strdup(arena_current(), member_name);
+    symbol->enum_members.member_values[count] = value;
     symbol->enum_members.member_count++;
 }
 
 // Scope management
 Scope* scope_new(Scope* parent) {
-    Scope* scope = malloc(sizeof(Scope));
+    Scope* scope = arena_alloc(arena_current(), sizeof(Scope));
     if (!scope) return NULL;
     
     scope->capacity = 16;
-    scope->symbols = malloc(sizeof(Symbol*) * scope->capacity);
-    if (!scope->symbols) {
-        free(scope);
-        return NULL;
-    }
+    scope->symbols = arena_alloc(arena_current(), sizeof(Symbol*) * scope->capacity);
+    if (!scope->symbols) return NULL;
     scope->count = 0;
+    
+    scope->slot_capacity = 32;
+    scope->slots = arena_calloc(arena_current(), scope->slot_capacity, sizeof(Symbol*));
+    if (!scope->slots) return NULL;
     scope->parent = parent;
     
     return scope;
 }
 
-void scope_free(Scope* scope) {
-    if (!scope) return;
+// Find the slot holding the interned name, or the empty slot where it belongs
+static Symbol** scope_slot(Symbol** slots, size_t slot_capacity, const char* name) {
+    size_t mask = slot_capacity - 1;
+    size_t index = intern_ptr_hash(name) & mask;
     
-    for (size_t i = 0; i < scope->count; i++) {
-        symbol_free(scope->symbols[i]);
+    while (slots[index] && slots[index]->name != name) {
+        index = (index + 1) & mask;
+    }
+    return &slots[index];
+}
+
+static bool scope_grow_slots(Scope* scope) {
+    size_t new_capacity = scope->slot_capacity * 2;
+    Symbol** slots = arena_calloc(arena_current(), new_capacity, sizeof(Symbol*));
+    if (!slots) return false;
+    
+    for (size_t i = 0; i < scope->slot_capacity; i++) {
+        if (scope->slots[i]) {
+            *scope_slot(slots, new_capacity, scope->slots[i]->name) = scope->slots[i];
+        }
     }
-    free(scope->symbols);
-    free(scope);
+    
+    scope->slots = slots;
+    scope->slot_capacity = new_capacity;
+    return true;
 }
 
 void scope_insert(Scope* scope, Symbol* symbol) {
     if (!scope || !symbol) return;
     
     if (scope->count >= scope->capacity) {
+        size_t old_size = sizeof(Symbol*) * scope->capacity;
         scope->capacity *= 2;
-        scope->symbols = realloc(scope->symbols, sizeof(Symbol*) * scope->capacity);
+        scope->symbols = arena_grow(arena_current(), scope->symbols, old_size,
+                                    sizeof(Symbol*) * scope->capacity);
         if (!scope->symbols) return;
     }
     
     scope->symbols[scope->count++] = symbol;
+    
+    if (!symbol->name) return;
+    
+    // Keep the index load factor under 1/2
+    if (scope->count * 2 > scope->slot_capacity && !scope_grow_slots(scope)) return;
+    
+    // The first declaration of a name wins, as with the old linear scan
+    Symbol** slot = scope_slot(scope->slots, scope->slot_capacity, symbol->name);
+    if (!*slot) {
+        *slot = symbol;
+    }
 }
 
 Symbol* scope_lookup(Scope* scope, const char* name) {
     if (!scope || !name) return NULL;
-    
-    for (size_t i = 0; i < scope->count; i++) {
-        if (strcmp(scope->symbols[i]->name, name) == 0) {
-            return scope->symbols[i];
-        }
-    }
-    
-    return NULL;
+    return *scope_slot(scope->slots, scope->slot_capacity, name);
 }
 
 // Symbol table management
 SymbolTable* symbol_table_new(void) {
-    SymbolTable* table = malloc(sizeof(SymbolTable));
+    SymbolTable* table = arena_alloc(arena_current(), sizeof(SymbolTable));
     if (!table) return NULL;
     
     table->global_scope = scope_new(NULL);
-    if (!table->global_scope) {
-        free(table);
-        return NULL;
-    }
+    if (!table->global_scope) return NULL;
     table->current_scope = table->global_scope;
+    table->symbol_count = 0;
     
     return table;
 }
 
-void symbol_table_free(SymbolTable* table) {
-    if (!table) return;
-    
-    // Free all scopes starting from global
-    Scope* current = table->global_scope;
-    while (current) {
-        Scope* next = current->parent;
-        scope_free(current);
-        current = next;
-    }
-    
-    free(table);
-}
-
 void symbol_table_push_scope(SymbolTable* table) {
     if (!table) return;
     
@@ -233,14 +202,14 @@ void symbol_table_push_scope(SymbolTable* table) {
 void symbol_table_pop_scope(SymbolTable* table) {
     if (!table || !table->current_scope || table->current_scope == table->global_scope) return;
     
-    Scope* old_scope = table->current_scope;
-    table->current_scope = old_scope->parent;
-    scope_free(old_scope);
+    // The popped scope stays in the arena until the compilation unit ends
+    table->current_scope = table->current_scope->parent;
 }
 
 void symbol_table_insert(SymbolTable* table, Symbol* symbol) {
     if (!table || !symbol) return;
     scope_insert(table->current_scope, symbol);
+    table->symbol_count++;
 }
 
 Symbol* symbol_table_lookup(SymbolTable* table, const char* name) {
@@ -256,6 +225,16 @@ Symbol* symbol_table_lookup(SymbolTable* table, const char* name) {
     return NULL;
 }
 
+Symbol* symbol_table_lookup_str(SymbolTable* table, const char* str) {
+    if (!table || !str) return NULL;
+    
+    // A name that was never interned cannot be declared anywhere
+    const char* interned = intern_find(str);
+    if (!interned) return NULL;
+    
+    return symbol_table_lookup(table, interned);
+}
+
 Symbol* symbol_table_lookup_current_scope(SymbolTable* table, const char* name) {
     if (!table || !name) return NULL;
     return scope_lookup(table->current_scope, name);
@@ -263,14 +242,11 @@ Symbol* symbol_table_lookup_current_scope(SymbolTable* table, const char* name)
 
 // Semantic analyzer
 SemanticAnalyzer* semantic_analyzer_new(const char* current_file) {
-    SemanticAnalyzer* analyzer = malloc(sizeof(SemanticAnalyzer));
+    SemanticAnalyzer* analyzer = arena_alloc(arena_current(), sizeof(SemanticAnalyzer));
     if (!analyzer) return NULL;
     
     analyzer->symbol_table = symbol_table_new();
-    if (!analyzer->symbol_table) {
-        free(analyzer);
-        return NULL;
-    }
+    if (!analyzer->symbol_table) return NULL;
     
     analyzer->current_function_return_type = NULL;
     analyzer->loop_depth = 0;
@@ -278,7 +254,7 @@ SemanticAnalyzer* semantic_analyzer_new(const char* current_file) {
     analyzer->c_includes = string_array_new();
     analyzer->c_functions = symbol_table_new();
     analyzer->c_libraries = string_array_new();
-    analyzer->current_file = current_file ? strdup(current_file) : NULL;
+    analyzer->current_file = arena_strdup(arena_current(), current_file);
     analyzer->imported_modules = symbol_table_new();
     analyzer->has_error = false;
     analyzer->error_message = NULL;
@@ -286,141 +262,84 @@ SemanticAnalyzer* semantic_analyzer_new(const char* current_file) {
     return analyzer;
 }
 
-void semantic_analyzer_free(SemanticAnalyzer* analyzer) {
-    if (!analyzer) return;
-    
-    symbol_table_free(analyzer->symbol_table);
-    free(analyzer->current_function_return_type);
-    string_array_free(analyzer->loop_labels);
-    string_array_free(analyzer->c_includes);
-    symbol_table_free(analyzer->c_functions);
-    string_array_free(analyzer->c_libraries);
-    free(analyzer->current_file);
-    symbol_table_free(analyzer->imported_modules);
-    free(analyzer->error_message);
-    free(analyzer);
-}
-
 // Error handling
 void semantic_error(SemanticAnalyzer* analyzer, const char* message) {
     if (!analyzer) return;
     
     analyzer->has_error = true;
-    free(analyzer->error_message);
-    analyzer->error_message = strdup(message);
+    analyzer->error_message = arena_strdup(arena_current(), message);
 }
 
 // Type utilities
-char* get_type_name(ASTNode* annotation) {
-    if (!annotation) return NULL;
-    
+static const Type* resolve_annotation(ASTNode* annotation) {
     switch (annotation->type) {
         case AST_NAME:
-            return strdup(annotation->name.id);
+            return type_named(annotation->name.id);
         case AST_CONSTANT:
             if (annotation->constant.value.type == CONST_STRING) {
-                return strdup(annotation->constant.value.str_val);
+                return type_from_spelling(annotation->constant.value.str_val);
             }
-            break;
-        // TODO: Handle subscript types like ptr[int], array[int, 5], etc.
+            return NULL;
+        case AST_SUBSCRIPT: {
+            ASTNode* head = annotation->subscript.value;
+            ASTNode* slice = annotation->subscript.slice;
+            if (!head || head->type != AST_NAME || !slice) return NULL;
+            
+            NodeArray* elts = slice->type == AST_TUPLE ? slice->tuple.elts : NULL;
+            ASTNode* first = elts ? (elts->count > 0 ? elts->items[0] : NULL) : slice;
+            ASTNode* second = elts && elts->count > 1 ? elts->items[1] : NULL;
+            if (!first || (elts && elts->count > 2)) return NULL;
+            
+            const char* kind = head->name.id;
+            if (strcmp(kind, "ptr") == 0 && !second) {
+                return type_pointer(get_type_name(first));
+            }
+            if (strcmp(kind, "array") == 0) {
+                int size = 0;
+                if (second) {
+                    if (second->type != AST_CONSTANT || second->constant.value.type != CONST_INT) return NULL;
+                    size = second->constant.value.int_val;
+                }
+                return type_array(get_type_name(first), size);
+            }
+            if (strcmp(kind, "Result") == 0 && second) {
+                return type_result(get_type_name(first), get_type_name(second));
+            }
+            if (strcmp(kind, "Final") == 0 && !second) {
+                return get_type_name(first);
+            }
+            return NULL;
+        }
         default:
-            break;
+            return NULL;
     }
+}
+
+// Resolve an annotation to its unique Type; the result is cached on the node
+const Type* get_type_name(ASTNode* annotation) {
+    if (!annotation) return NULL;
     
-    return NULL;
+    if (!annotation->resolved_type) {
+        annotation->resolved_type = resolve_annotation(annotation);
+    }
+    return annotation->resolved_type;
 }
 
-bool types_compatible(const char* type1, const char* type2) {
+bool types_compatible(const Type* type1, const Type* type2) {
     if (!type1 || !type2) return false;
     
     // Exact match
-    if (strcmp(type1, type2) == 0) return true;
+    if (type1 == type2) return true;
     
     // bool can be assigned from int
-    if (strcmp(type1, "bool") == 0 && strcmp(type2, "int") == 0) return true;
+    if (type1->kind == TYPE_BOOL && type2->kind == TYPE_INT) return true;
     
     // ptr[void] can be assigned to any pointer type
-    if (strstr(type1, "ptr[") && strcmp(type2, "ptr[void]") == 0) return true;
+    if (type1->kind == TYPE_PTR && type2 == type_pointer(type_primitive(TYPE_VOID))) return true;
     
     return false;
 }
 
-bool is_pointer_type(const char* type) {
-    return type && strstr(type, "ptr[") == type;
-}
-
-bool is_array_type(const char* type) {
-    return type && strstr(type, "array[") == type;
-}
-
-bool is_result_type(const char* type) {
-    return type && strstr(type, "Result[") == type;
-}
-
-char* extract_pointer_base_type(const char* pointer_type) {
-    if (!is_pointer_type(pointer_type)) return NULL;
-    
-    const char* start = pointer_type + 4;  // Skip "ptr["
-    const char* end = strrchr(pointer_type, ']');
-    if (!end) return NULL;
-    
-    size_t len = end - start;
-    char* base_type = malloc(len + 1);
-    strncpy(base_type, start, len);
-    base_type[len] = '\0';
-    
-    return base_type;
-}
-
-void parse_array_type(const char* array_type, char** base_type, int* size) {
-    if (!is_array_type(array_type)) return;
-    
-    const char* start = array_type + 6;  // Skip "array["
-    const char* comma = strchr(start, ',');
-    const char* end = strrchr(array_type, ']');
-    
-    if (!comma || !end) return;
-    
-    // Extract base type
-    if (base_type) {
-        size_t type_len = comma - start;
-        *base_type = malloc(type_len + 1);
-        strncpy(*base_type, start, type_len);
-        (*base_type)[type_len] = '\0';
-    }
-    
-    // Extract size
-    if (size) {
-        *size = atoi(comma + 1);
-    }
-}
-
-void parse_result_type(const char* result_type, char** success_type, char** error_type) {
-    if (!is_result_type(result_type)) return;
-    
-    const char* start = result_type + 7;  // Skip "Result["
-    const char* comma = strchr(start, ',');
-    const char* end = strrchr(result_type, ']');
-    
-    if (!comma || !end) return;
-    
-    // Extract success type
-    if (success_type) {
-        size_t type_len = comma - start;
-        *success_type = malloc(type_len + 1);
-        strncpy(*success_type, start, type_len);
-        (*success_type)[type_len] = '\0';
-    }
-    
-    // Extract error type
-    if (error_type) {
-        size_t type_len = end - comma - 1;
-        *error_type = malloc(type_len + 1);
-        strncpy(*error_type, comma + 1, type_len);
-        (*error_type)[type_len] = '\0';
-    }
-}
-
 // Analysis functions
 bool analyze_ast(SemanticAnalyzer* analyzer, ASTNode* node) {
     if (!analyzer || !node) return false;
@@ -446,9 +365,8 @@ bool analyze_ast(SemanticAnalyzer* analyzer, ASTNode* node) {
             return analyze_return(analyzer, node);
         case AST_EXPR_STMT:
             {
-                char* result_type = NULL;
+                const Type* result_type = NULL;
                 bool success = analyze_expression(analyzer, node->expr_stmt.value, &result_type);
-                free(result_type);
                 return success;
             }
         case AST_BREAK:
@@ -462,14 +380,58 @@ bool analyze_ast(SemanticAnalyzer* analyzer, ASTNode* node) {
             return true;
         default:
             {
-                char* result_type = NULL;
+                const Type* result_type = NULL;
                 bool success = analyze_expression(analyzer, node, &result_type);
-                free(result_type);
                 return success;
             }
     }
 }
 
+// @c_function, @c_function("lib"), @c_include("header"), @comptime (or @const)
+// and @inline
+static bool process_decorators(SemanticAnalyzer* analyzer, ASTNode* function, Symbol* symbol) {
+    NodeArray* decorators = function->function_def.decorator_list;
+    
+    for (size_t i = 0; decorators && i < decorators->count; i++) {
+        ASTNode* decorator = decorators->items[i];
+        NodeArray* args = NULL;
+        if (decorator->type == AST_CALL) {
+            args = decorator->call.args;
+            decorator = decorator->call.func;
+        }
+        if (decorator->type != AST_NAME) continue;
+        
+        const char* name = decorator->name.id;
+        const char* argument = args && args->count > 0 && args->items[0]->type == AST_CONSTANT &&
+                               args->items[0]->constant.value.type == CONST_STRING
+                                   ? args->items[0]->constant.value.str_val : NULL;
+        if (strcmp(name, "c_function") == 0) {
+            symbol->is_c_function = true;
+            if (argument) {
+                symbol->c_library = arena_strdup(arena_current(), argument);
+                string_array_push(analyzer->c_libraries, argument);
+            }
+        } else if (strcmp(name, "c_include") == 0 && argument) {
+            string_array_push(analyzer->c_includes, argument);
+        } else if (strcmp(name, "comptime") == 0 || strcmp(name, "const") == 0) {
+            symbol->is_comptime = true;
+            symbol->definition = function;
+        } else if (strcmp(name, "inline") == 0) {
+            symbol->is_inline = true;
+        }
+    }
+    
+    if (symbol->is_comptime && symbol->is_c_function) {
+        semantic_error(analyzer, "A @c_function cannot be @comptime");
+        return false;
+    }
+    if (symbol->is_inline && symbol->is_c_function) {
+        semantic_error(analyzer, "A @c_function cannot be @inline");
+        return false;
+    }
+    return true;
+}
+
 bool analyze_module(SemanticAnalyzer* analyzer, ASTNode* node) {
     if (!analyzer || !node || node->type != AST_MODULE) return false;
     
@@ -480,7 +442,7 @@ bool analyze_module(SemanticAnalyzer* analyzer, ASTNode* node) {
         if (item->type == AST_FUNCTION_DEF) {
             // Register function signature
             char* name = item->function_def.name;
-            char* return_type = NULL;
+            const Type* return_type = NULL;
             
             if (item->function_def.returns) {
                 return_type = get_type_name(item->function_def.returns);
@@ -491,19 +453,17 @@ bool analyze_module(SemanticAnalyzer* analyzer, ASTNode* node) {
             
             // Extract parameter types
             if (item->function_def.args && item->function_def.args->type == AST_ARGUMENTS) {
-                func_symbol->param_types = string_array_new();
+                func_symbol->param_types = type_list_new();
                 NodeArray* args = item->function_def.args->arguments.args;
                 
                 for (size_t j = 0; j < args->count; j++) {
                     ASTNode* arg = args->items[j];
                     if (arg->type == AST_ARG) {
-                        char* param_type = get_type_name(arg->arg.annotation);
+                        const Type* param_type = get_type_name(arg->arg.annotation);
                         if (param_type) {
-                            string_array_push(func_symbol->param_types, param_type);
-                            free(param_type);
+                            type_list_push(func_symbol->param_types, param_type);
                         } else {
                             semantic_error(analyzer, "Parameter must have type annotation");
-                            symbol_free(func_symbol);
                             return false;
                         }
                     }
@@ -513,10 +473,12 @@ bool analyze_module(SemanticAnalyzer* analyzer, ASTNode* node) {
             // Check for duplicate function
             if (symbol_table_lookup_current_scope(analyzer->symbol_table, name)) {
                 semantic_error(analyzer, "Function already defined");
-                symbol_free(func_symbol);
                 return false;
             }
             
+            if (!process_decorators(analyzer, item, func_symbol)) {
+                return false;
+            }
             symbol_table_insert(analyzer->symbol_table, func_symbol);
         }
         else if (item->type == AST_CLASS_DEF) {
@@ -528,7 +490,7 @@ bool analyze_module(SemanticAnalyzer* analyzer, ASTNode* node) {
     }
     
     // Check for main function
-    Symbol* main_symbol = symbol_table_lookup(analyzer->symbol_table, "main");
+    Symbol* main_symbol = symbol_table_lookup_str(analyzer->symbol_table, "main");
     if (!main_symbol || main_symbol->type != SYM_FUNCTION) {
         // Allow library modules to not have main
         if (!analyzer->current_file || 
@@ -539,6 +501,17 @@ bool analyze_module(SemanticAnalyzer* analyzer, ASTNode* node) {
         }
     }
     
+    // @comptime bodies must be interpretable before any call is evaluated
+    for (size_t i = 0; i < node->module.body->count; i++) {
+        ASTNode* item = node->module.body->items[i];
+        if (item->type != AST_FUNCTION_DEF) continue;
+        
+        Symbol* symbol = symbol_table_lookup(analyzer->symbol_table, item->function_def.name);
+        if (symbol->is_comptime && !comptime_check_function(analyzer, item)) {
+            return false;
+        }
+    }
+    
     // Second pass: analyze function bodies
     for (size_t i = 0; i < node->module.body->count; i++) {
         ASTNode* item = node->module.body->items[i];
@@ -561,7 +534,7 @@ bool analyze_module(SemanticAnalyzer* analyzer, ASTNode* node) {
 bool analyze_function_def(SemanticAnalyzer* analyzer, ASTNode* node) {
     if (!analyzer || !node || node->type != AST_FUNCTION_DEF) return false;
     
-    char* old_return_type = analyzer->current_function_return_type;
+    const Type* old_return_type = analyzer->current_function_return_type;
     
     if (node->function_def.returns) {
         analyzer->current_function_return_type = get_type_name(node->function_def.returns);
@@ -580,19 +553,17 @@ bool analyze_function_def(SemanticAnalyzer* analyzer, ASTNode* node) {
             ASTNode* arg = args->items[i];
             if (arg->type == AST_ARG) {
                 char* param_name = arg->arg.arg;
-                char* param_type = get_type_name(arg->arg.annotation);
+                const Type* param_type = get_type_name(arg->arg.annotation);
                 
                 if (!param_type) {
                     semantic_error(analyzer, "Parameter must have type annotation");
                     symbol_table_pop_scope(analyzer->symbol_table);
-                    free(analyzer->current_function_return_type);
                     analyzer->current_function_return_type = old_return_type;
                     return false;
                 }
                 
                 Symbol* param_symbol = symbol_new(param_name, SYM_VARIABLE, param_type);
                 symbol_table_insert(analyzer->symbol_table, param_symbol);
-                free(param_type);
             }
         }
     }
@@ -609,7 +580,6 @@ bool analyze_function_def(SemanticAnalyzer* analyzer, ASTNode* node) {
     // Pop function scope
     symbol_table_pop_scope(analyzer->symbol_table);
     
-    free(analyzer->current_function_return_type);
     analyzer->current_function_return_type = old_return_type;
     
     return success;
@@ -653,21 +623,18 @@ bool analyze_class_def(SemanticAnalyzer* analyzer, ASTNode* node) {
                 // Enum member assignment
                 if (stmt->assign.targets->count != 1) {
                     semantic_error(analyzer, "Invalid enum member assignment");
-                    symbol_free(class_symbol);
                     return false;
                 }
                 
                 ASTNode* target = stmt->assign.targets->items[0];
                 if (target->type != AST_NAME) {
                     semantic_error(analyzer, "Invalid enum member assignment");
-                    symbol_free(class_symbol);
                     return false;
                 }
                 
                 if (stmt->assign.value->type != AST_CONSTANT || 
                     stmt->assign.value->constant.value.type != CONST_INT) {
                     semantic_error(analyzer, "Enum member must have integer value");
-                    symbol_free(class_symbol);
                     return false;
                 }
                 
@@ -678,7 +645,6 @@ bool analyze_class_def(SemanticAnalyzer* analyzer, ASTNode* node) {
             }
             else if (stmt->type != AST_PASS) {
                 semantic_error(analyzer, "Enum can only contain member assignments");
-                symbol_free(class_symbol);
                 return false;
             }
         }
@@ -711,16 +677,14 @@ bool analyze_class_def(SemanticAnalyzer* analyzer, ASTNode* node) {
                 
                 if (stmt->type == AST_ANN_ASSIGN) {
                     char* field_name = stmt->ann_assign.target->name.id;
-                    char* field_type = get_type_name(stmt->ann_assign.annotation);
+                    const Type* field_type = get_type_name(stmt->ann_assign.annotation);
                     
                     if (!field_type) {
                         semantic_error(analyzer, "Field must have type annotation");
-                        symbol_free(class_symbol);
                         return false;
                     }
                     
                     symbol_add_field(class_symbol, field_name, field_type);
-                    free(field_type);
                 }
             }
             
@@ -730,13 +694,13 @@ bool analyze_class_def(SemanticAnalyzer* analyzer, ASTNode* node) {
                 
                 if (stmt->type == AST_FUNCTION_DEF) {
                     char* method_name = stmt->function_def.name;
-                    char* return_type = NULL;
+                    const Type* return_type = NULL;
                     
                     if (stmt->function_def.returns) {
                         return_type = get_type_name(stmt->function_def.returns);
                     }
                     
-                    StringArray* param_types = string_array_new();
+                    TypeList* param_types = type_list_new();
                     
                     // Skip 'self' parameter
                     if (stmt->function_def.args && stmt->function_def.args->type == AST_ARGUMENTS) {
@@ -745,17 +709,15 @@ bool analyze_class_def(SemanticAnalyzer* analyzer, ASTNode* node) {
                         for (size_t j = 1; j < args->count; j++) {  // Skip self
                             ASTNode* arg = args->items[j];
                             if (arg->type == AST_ARG) {
-                                char* param_type = get_type_name(arg->arg.annotation);
+                                const Type* param_type = get_type_name(arg->arg.annotation);
                                 if (param_type) {
-                                    string_array_push(param_types, param_type);
-                                    free(param_type);
+                                    type_list_push(param_types, param_type);
                                 }
                             }
                         }
                     }
                     
                     symbol_add_method(class_symbol, method_name, param_types, return_type);
-                    free(return_type);
                 }
             }
         }
@@ -769,13 +731,13 @@ bool analyze_class_def(SemanticAnalyzer* analyzer, ASTNode* node) {
                 
                 if (stmt->type == AST_FUNCTION_DEF) {
                     char* method_name = stmt->function_def.name;
-                    char* return_type = NULL;
+                    const Type* return_type = NULL;
                     
                     if (stmt->function_def.returns) {
                         return_type = get_type_name(stmt->function_def.returns);
                     }
                     
-                    StringArray* param_types = string_array_new();
+                    TypeList* param_types = type_list_new();
                     
                     // Skip 'self' parameter
                     if (stmt->function_def.args && stmt->function_def.args->type == AST_ARGUMENTS) {
@@ -784,17 +746,15 @@ bool analyze_class_def(SemanticAnalyzer* analyzer, ASTNode* node) {
                         for (size_t j = 1; j < args->count; j++) {  // Skip self
                             ASTNode* arg = args->items[j];
                             if (arg->type == AST_ARG) {
-                                char* param_type = get_type_name(arg->arg.annotation);
+                                const Type* param_type = get_type_name(arg->arg.annotation);
                                 if (param_type) {
-                                    string_array_push(param_types, param_type);
-                                    free(param_type);
+                                    type_list_push(param_types, param_type);
                                 }
                             }
                         }
                     }
                     
                     symbol_add_method(class_symbol, method_name, param_types, return_type);
-                    free(return_type);
                 }
             }
         }
@@ -816,7 +776,7 @@ bool analyze_ann_assign(SemanticAnalyzer* analyzer, ASTNode* node) {
     }
     
     char* var_name = node->ann_assign.target->name.id;
-    char* type_name = get_type_name(node->ann_assign.annotation);
+    const Type* type_name = get_type_name(node->ann_assign.annotation);
     
     if (!type_name) {
         semantic_error(analyzer, "Variable must have type annotation");
@@ -826,7 +786,6 @@ bool analyze_ann_assign(SemanticAnalyzer* analyzer, ASTNode* node) {
     // Check for duplicate variable in current scope
     if (symbol_table_lookup_current_scope(analyzer->symbol_table, var_name)) {
         semantic_error(analyzer, "Variable already declared in this scope");
-        free(type_name);
         return false;
     }
     
@@ -836,58 +795,67 @@ bool analyze_ann_assign(SemanticAnalyzer* analyzer, ASTNode* node) {
     // TODO: Handle Final[type] annotation parsing
     
     if (node->ann_assign.value) {
-        char* value_type = NULL;
+        const Type* value_type = NULL;
         if (!analyze_expression(analyzer, node->ann_assign.value, &value_type)) {
-            symbol_free(var_symbol);
-            free(type_name);
             return false;
         }
         
         if (!types_compatible(type_name, value_type)) {
             semantic_error(analyzer, "Type mismatch in assignment");
-            symbol_free(var_symbol);
-            free(type_name);
-            free(value_type);
             return false;
         }
         
-        free(value_type);
     }
     
     symbol_table_insert(analyzer->symbol_table, var_symbol);
-    free(type_name);
     return true;
 }
 
-bool analyze_expression(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) {
+// Analyzes the expression and records its type on the node for codegen
+bool analyze_expression(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
     if (!analyzer || !node) return false;
     
+    const Type* type = NULL;
+    bool ok;
     switch (node->type) {
         case AST_NAME:
-            return analyze_name(analyzer, node, result_type);
+            ok = analyze_name(analyzer, node, &type);
+            break;
         case AST_CONSTANT:
-            return analyze_constant(analyzer, node, result_type);
+            ok = analyze_constant(analyzer, node, &type);
+            break;
         case AST_BINOP:
-            return analyze_binop(analyzer, node, result_type);
+            ok = analyze_binop(analyzer, node, &type);
+            break;
         case AST_UNARYOP:
-            return analyze_unaryop(analyzer, node, result_type);
+            ok = analyze_unaryop(analyzer, node, &type);
+            break;
         case AST_COMPARE:
-            return analyze_compare(analyzer, node, result_type);
+            ok = analyze_compare(analyzer, node, &type);
+            break;
         case AST_BOOLOP:
-            return analyze_boolop(analyzer, node, result_type);
+            ok = analyze_boolop(analyzer, node, &type);
+            break;
         case AST_CALL:
-            return analyze_call(analyzer, node, result_type);
+            ok = analyze_call(analyzer, node, &type);
+            break;
         case AST_ATTRIBUTE:
-            return analyze_attribute(analyzer, node, result_type);
+            ok = analyze_attribute(analyzer, node, &type);
+            break;
         case AST_SUBSCRIPT:
-            return analyze_subscript(analyzer, node, result_type);
+            ok = analyze_subscript(analyzer, node, &type);
+            break;
         default:
             semantic_error(analyzer, "Unsupported expression type");
             return false;
     }
+    
+    if (ok) node->value_type = type;
+    if (result_type) *result_type = type;
+    return ok;
 }
 
-bool analyze_name(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) {
+bool analyze_name(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
     if (!analyzer || !node || node->type != AST_NAME) return false;
     
     Symbol* symbol = symbol_table_lookup(analyzer->symbol_table, node->name.id);
@@ -897,31 +865,31 @@ bool analyze_name(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type)
     }
     
     if (result_type) {
-        *result_type = symbol->value_type ? strdup(symbol->value_type) : NULL;
+        *result_type = symbol->value_type;
     }
     
     return true;
 }
 
-bool analyze_constant(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) {
+bool analyze_constant(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
     if (!analyzer || !node || node->type != AST_CONSTANT) return false;
     
     if (result_type) {
         switch (node->constant.value.type) {
             case CONST_INT:
-                *result_type = strdup("int");
+                *result_type = type_primitive(TYPE_INT);
                 break;
             case CONST_FLOAT:
-                *result_type = strdup("float");
+                *result_type = type_primitive(TYPE_FLOAT);
                 break;
             case CONST_STRING:
-                *result_type = strdup("str");
+                *result_type = type_primitive(TYPE_STR);
                 break;
             case CONST_BOOL:
-                *result_type = strdup("bool");
+                *result_type = type_primitive(TYPE_BOOL);
                 break;
             case CONST_NONE:
-                *result_type = strdup("None");
+                *result_type = type_primitive(TYPE_NONE);
                 break;
             default:
                 *result_type = NULL;
@@ -932,7 +900,7 @@ bool analyze_constant(SemanticAnalyzer* analyzer, ASTNode* node, char** result_t
     return true;
 }
 
-bool analyze_call(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) {
+bool analyze_call(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
     if (!analyzer || !node || node->type != AST_CALL) return false;
     
     if (node->call.func->type == AST_NAME) {
@@ -940,37 +908,68 @@ bool analyze_call(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type)
         
         // Handle built-in functions
         if (strcmp(func_name, "print") == 0) {
-            // print() can take any argument, just validate it exists
-            if (node->call.args->count != 1) {
-                semantic_error(analyzer, "print() expects exactly one argument");
-                return false;
+            // print() takes any number of arguments of any type
+            for (size_t i = 0; i < node->call.args->count; i++) {
+                if (!analyze_expression(analyzer, node->call.args->items[i], NULL)) {
+                    return false;
+                }
             }
-            char* arg_type = NULL;
-            if (!analyze_expression(analyzer, node->call.args->items[0], &arg_type)) {
+            if (result_type) *result_type = NULL;  // print returns nothing
+            return true;
+        }
+        
+        if (strcmp(func_name, "flush") == 0) {
+            if (node->call.args->count != 0) {
+                semantic_error(analyzer, "flush() takes no arguments");
                 return false;
             }
-            free(arg_type);
-            if (result_type) *result_type = NULL;  // print returns nothing
+            if (result_type) *result_type = type_primitive(TYPE_NONE);
             return true;
         }
         
-        // Handle range() function
-        if (strcmp(func_name, "range") == 0) {
+        // Handle range() and prange() functions
+        if (strcmp(func_name, "range") == 0 || strcmp(func_name, "prange") == 0) {
             if (node->call.args->count != 1) {
                 semantic_error(analyzer, "range() expects exactly one argument");
                 return false;
             }
-            char* arg_type = NULL;
+            const Type* arg_type = NULL;
             if (!analyze_expression(analyzer, node->call.args->items[0], &arg_type)) {
                 return false;
             }
-            if (arg_type && strcmp(arg_type, "int") != 0) {
+            if (arg_type && arg_type->kind != TYPE_INT) {
                 semantic_error(analyzer, "range() expects integer argument");
-                free(arg_type);
                 return false;
             }
-            free(arg_type);
-            if (result_type) *result_type = strdup("range_object");
+            if (result_type) *result_type = type_primitive(TYPE_RANGE);
+            return true;
+        }
+        
+        // parallel_for(n, body) calls body(i) for i in [0, n) on the runtime's task scheduler
+        if (strcmp(func_name, "parallel_for") == 0) {
+            if (node->call.args->count != 2) {
+                semantic_error(analyzer, "parallel_for() expects a count and a function");
+                return false;
+            }
+            const Type* count_type = NULL;
+            if (!analyze_expression(analyzer, node->call.args->items[0], &count_type)) {
+                return false;
+            }
+            if (count_type && count_type->kind != TYPE_INT) {
+                semantic_error(analyzer, "parallel_for() count must be an int");
+                return false;
+            }
+            ASTNode* body = node->call.args->items[1];
+            Symbol* body_symbol = body->type == AST_NAME ? symbol_table_lookup(analyzer->symbol_table, body->name.id) : NULL;
+            if (!body_symbol || body_symbol->type != SYM_FUNCTION || body_symbol->is_c_function ||
+                !body_symbol->param_types || body_symbol->param_types->count != 1 ||
+                body_symbol->param_types->items[0]->kind != TYPE_INT ||
+                (body_symbol->return_type && body_symbol->return_type->kind != TYPE_NONE &&
+                 body_symbol->return_type->kind != TYPE_VOID)) {
+                semantic_error(analyzer, "parallel_for() body must be a function taking (i: int) and returning None");
+                return false;
+            }
+            if (result_type) *result_type = NULL;
             return true;
         }
         
@@ -990,25 +989,26 @@ bool analyze_call(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type)
         
         // Check argument types
         for (size_t i = 0; i < node->call.args->count; i++) {
-            char* arg_type = NULL;
+            const Type* arg_type = NULL;
             if (!analyze_expression(analyzer, node->call.args->items[i], &arg_type)) {
                 return false;
             }
             
             if (func_symbol->param_types && i < func_symbol->param_types->count) {
-                char* expected_type = func_symbol->param_types->items[i];
+                const Type* expected_type = func_symbol->param_types->items[i];
                 if (arg_type && !types_compatible(expected_type, arg_type)) {
                     semantic_error(analyzer, "Function argument type mismatch");
-                    free(arg_type);
                     return false;
                 }
             }
-            free(arg_type);
         }
         
         // Return the function's return type
         if (result_type) {
-            *result_type = func_symbol->return_type ? strdup(func_symbol->return_type) : NULL;
+            *result_type = func_symbol->return_type;
+        }
+        if (func_symbol->is_comptime) {
+            return comptime_fold_call(analyzer, node, func_symbol);
         }
         return true;
     }
@@ -1017,41 +1017,37 @@ bool analyze_call(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type)
     return false;
 }
 
-bool analyze_binop(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) {
+bool analyze_binop(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
     if (!analyzer || !node || node->type != AST_BINOP) return false;
     
-    char* left_type = NULL;
-    char* right_type = NULL;
+    const Type* left_type = NULL;
+    const Type* right_type = NULL;
     
     if (!analyze_expression(analyzer, node->binop.left, &left_type) ||
         !analyze_expression(analyzer, node->binop.right, &right_type)) {
-        free(left_type);
-        free(right_type);
         return false;
     }
     
     // Simple type promotion rules
     if (result_type) {
-        if ((left_type && strcmp(left_type, "float") == 0) || 
-            (right_type && strcmp(right_type, "float") == 0)) {
-            *result_type = strdup("float");
-        } else if ((left_type && strcmp(left_type, "int") == 0) && 
-                   (right_type && strcmp(right_type, "int") == 0)) {
-            *result_type = strdup("int");
+        if ((left_type && left_type->kind == TYPE_FLOAT) || 
+            (right_type && right_type->kind == TYPE_FLOAT)) {
+            *result_type = type_primitive(TYPE_FLOAT);
+        } else if ((left_type && left_type->kind == TYPE_INT) && 
+                   (right_type && right_type->kind == TYPE_INT)) {
+            *result_type = type_primitive(TYPE_INT);
         } else {
-            *result_type = strdup("int");  // Default fallback
+            *result_type = type_primitive(TYPE_INT);  // Default fallback
         }
     }
     
-    free(left_type);
-    free(right_type);
     return true;
 }
 
-bool analyze_attribute(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) {
+bool analyze_attribute(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
     if (!analyzer || !node || node->type != AST_ATTRIBUTE) return false;
     
-    char* obj_type = NULL;
+    const Type* obj_type = NULL;
     if (!analyze_expression(analyzer, node->attribute.value, &obj_type)) {
         return false;
     }
@@ -1062,10 +1058,10 @@ bool analyze_attribute(SemanticAnalyzer* analyzer, ASTNode* node, char** result_
     }
     
     // Look up the struct type
-    Symbol* struct_symbol = symbol_table_lookup(analyzer->symbol_table, obj_type);
+    Symbol* struct_symbol = obj_type->kind == TYPE_NAMED
+        ? symbol_table_lookup(analyzer->symbol_table, obj_type->name) : NULL;
     if (!struct_symbol || struct_symbol->type != SYM_STRUCT) {
         semantic_error(analyzer, "Cannot access attribute on non-struct type");
-        free(obj_type);
         return false;
     }
     
@@ -1074,15 +1070,13 @@ bool analyze_attribute(SemanticAnalyzer* analyzer, ASTNode* node, char** result_
     for (size_t i = 0; i < struct_symbol->fields.field_count; i++) {
         if (strcmp(struct_symbol->fields.field_names[i], field_name) == 0) {
             if (result_type) {
-                *result_type = strdup(struct_symbol->fields.field_types[i]);
+                *result_type = struct_symbol->fields.field_types[i];
             }
-            free(obj_type);
             return true;
         }
     }
     
     semantic_error(analyzer, "Struct field not found");
-    free(obj_type);
     return false;
 }
 
@@ -1090,7 +1084,7 @@ bool analyze_assign(SemanticAnalyzer* analyzer, ASTNode* node) {
     if (!analyzer || !node || node->type != AST_ASSIGN) return false;
     
     // Analyze the value expression first
-    char* value_type = NULL;
+    const Type* value_type = NULL;
     if (!analyze_expression(analyzer, node->assign.value, &value_type)) {
         return false;
     }
@@ -1103,52 +1097,204 @@ bool analyze_assign(SemanticAnalyzer* analyzer, ASTNode* node) {
             Symbol* symbol = symbol_table_lookup(analyzer->symbol_table, target->name.id);
             if (!symbol) {
                 semantic_error(analyzer, "Variable not declared");
-                free(value_type);
                 return false;
             }
             
             // Check type compatibility
             if (symbol->value_type && value_type && !types_compatible(symbol->value_type, value_type)) {
                 semantic_error(analyzer, "Type mismatch in assignment");
-                free(value_type);
                 return false;
             }
         } else if (target->type == AST_SUBSCRIPT) {
             // Array/subscript assignment - analyze the target
-            char* target_type = NULL;
+            const Type* target_type = NULL;
             if (!analyze_expression(analyzer, target, &target_type)) {
-                free(value_type);
                 return false;
             }
             
             // For array assignments, we should check element type compatibility
             // For now, just accept it
-            free(target_type);
         }
     }
     
-    free(value_type);
     return true;
 }
 bool analyze_if(SemanticAnalyzer* analyzer, ASTNode* node) { return true; }
 bool analyze_while(SemanticAnalyzer* analyzer, ASTNode* node) { return true; }
-bool analyze_for(SemanticAnalyzer* analyzer, ASTNode* node) { return true; }
+
+bool is_parallel_for(const ASTNode* node) {
+    const ASTNode* iter = node->for_stmt.iter;
+    return iter && iter->type == AST_CALL && iter->call.func->type == AST_NAME &&
+           strcmp(iter->call.func->name.id, "prange") == 0;
+}
+
+static bool string_array_contains(const StringArray* arr, const char* str) {
+    for (size_t i = 0; i < arr->count; i++) {
+        if (strcmp(arr->items[i], str) == 0) return true;
+    }
+    return false;
+}
+
+// Whether any statement in body (including nested blocks) assigns name
+static bool is_assigned_in(NodeArray* body, const char* name) {
+    for (size_t i = 0; i < body->count; i++) {
+        ASTNode* stmt = body->items[i];
+        if (stmt->type == AST_ASSIGN) {
+            for (size_t j = 0; j < stmt->assign.targets->count; j++) {
+                ASTNode* target = stmt->assign.targets->items[j];
+                if (target->type == AST_NAME && strcmp(target->name.id, name) == 0) return true;
+            }
+        } else if (stmt->type == AST_IF) {
+            if (is_assigned_in(stmt->if_stmt.body, name)) return true;
+            if (stmt->if_stmt.orelse && is_assigned_in(stmt->if_stmt.orelse, name)) return true;
+        } else if (stmt->type == AST_WHILE) {
+            if (is_assigned_in(stmt->while_stmt.body, name)) return true;
+        } else if (stmt->type == AST_FOR) {
+            if (is_assigned_in(stmt->for_stmt.body, name)) return true;
+        }
+    }
+    return false;
+}
+
+// Variables declared inside a prange body are private to each iteration
+void collect_private_names(NodeArray* body, StringArray* names) {
+    for (size_t i = 0; i < body->count; i++) {
+        ASTNode* stmt = body->items[i];
+        if (stmt->type == AST_ANN_ASSIGN && stmt->ann_assign.target->type == AST_NAME) {
+            string_array_push(names, stmt->ann_assign.target->name.id);
+        } else if (stmt->type == AST_IF) {
+            collect_private_names(stmt->if_stmt.body, names);
+            if (stmt->if_stmt.orelse) collect_private_names(stmt->if_stmt.orelse, names);
+        } else if (stmt->type == AST_WHILE) {
+            collect_private_names(stmt->while_stmt.body, names);
+        } else if (stmt->type == AST_FOR) {
+            if (stmt->for_stmt.target->type == AST_NAME) {
+                string_array_push(names, stmt->for_stmt.target->name.id);
+            }
+            collect_private_names(stmt->for_stmt.body, names);
+        }
+    }
+}
+
+// Iterations of a prange loop must be independent: they may only write
+// private variables and array elements indexed by the loop variable.
+// Reductions are not supported by this backend.
+static bool check_parallel_body(SemanticAnalyzer* analyzer, NodeArray* body, const char* loop_var,
+                                const StringArray* private_names, int loop_nesting) {
+    for (size_t i = 0; i < body->count; i++) {
+        ASTNode* stmt = body->items[i];
+        switch (stmt->type) {
+            case AST_ASSIGN:
+                for (size_t t = 0; t < stmt->assign.targets->count; t++) {
+                    ASTNode* target = stmt->assign.targets->items[t];
+                    if (target->type == AST_NAME && !string_array_contains(private_names, target->name.id)) {
+                        semantic_error(analyzer, "prange loop writes an outer variable");
+                        return false;
+                    }
+                    if (target->type == AST_SUBSCRIPT) {
+                        ASTNode* index = target->subscript.slice;
+                        if (index->type != AST_NAME || strcmp(index->name.id, loop_var) != 0) {
+                            semantic_error(analyzer, "prange loop may only write array elements indexed by the loop variable");
+                            return false;
+                        }
+                    }
+                    if (target->type == AST_ATTRIBUTE) {
+                        semantic_error(analyzer, "prange loop may not write struct fields");
+                        return false;
+                    }
+                }
+                break;
+            case AST_RETURN:
+                semantic_error(analyzer, "return is not allowed inside a prange loop");
+                return false;
+            case AST_BREAK:
+                if (loop_nesting == 0) {
+                    semantic_error(analyzer, "break is not allowed inside a prange loop");
+                    return false;
+                }
+                break;
+            case AST_IF:
+                if (!check_parallel_body(analyzer, stmt->if_stmt.body, loop_var, private_names, loop_nesting)) return false;
+                if (stmt->if_stmt.orelse &&
+                    !check_parallel_body(analyzer, stmt->if_stmt.orelse, loop_var, private_names, loop_nesting)) {
+                    return false;
+                }
+                break;
+            case AST_WHILE:
+                if (!check_parallel_body(analyzer, stmt->while_stmt.body, loop_var, private_names, loop_nesting + 1)) return false;
+                break;
+            case AST_FOR:
+                if (!check_parallel_body(analyzer, stmt->for_stmt.body, loop_var, private_names, loop_nesting + 1)) return false;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool analyze_for(SemanticAnalyzer* analyzer, ASTNode* node) {
+    if (!analyzer || !node || node->type != AST_FOR) return false;
+    
+    if (node->for_stmt.target->type != AST_NAME) {
+        semantic_error(analyzer, "for loop target must be a variable");
+        return false;
+    }
+    
+    const Type* iter_type = NULL;
+    if (!analyze_expression(analyzer, node->for_stmt.iter, &iter_type)) {
+        return false;
+    }
+    if (!iter_type || iter_type->kind != TYPE_RANGE) {
+        semantic_error(analyzer, "for loops iterate over range() or prange()");
+        return false;
+    }
+    
+    // The loop variable is scoped to the loop body
+    symbol_table_push_scope(analyzer->symbol_table);
+    const char* loop_var = node->for_stmt.target->name.id;
+    Symbol* loop_symbol = symbol_new(loop_var, SYM_VARIABLE, type_primitive(TYPE_INT));
+    symbol_table_insert(analyzer->symbol_table, loop_symbol);
+    
+    // The loop variable stays in [0, n) for a constant n unless the body assigns it
+    ASTNode* limit = node->for_stmt.iter->call.args->items[0];
+    if (limit->type == AST_CONSTANT && limit->constant.value.type == CONST_INT &&
+        !is_assigned_in(node->for_stmt.body, loop_var)) {
+        loop_symbol->loop_bound = limit->constant.value.int_val;
+    }
+    
+    bool ok = true;
+    analyzer->loop_depth++;
+    for (size_t i = 0; ok && i < node->for_stmt.body->count; i++) {
+        ok = analyze_ast(analyzer, node->for_stmt.body->items[i]);
+    }
+    analyzer->loop_depth--;
+    
+    if (ok && is_parallel_for(node)) {
+        StringArray* private_names = string_array_new();
+        string_array_push(private_names, loop_var);
+        collect_private_names(node->for_stmt.body, private_names);
+        ok = check_parallel_body(analyzer, node->for_stmt.body, loop_var, private_names, 0);
+    }
+    
+    symbol_table_pop_scope(analyzer->symbol_table);
+    return ok;
+}
 bool analyze_return(SemanticAnalyzer* analyzer, ASTNode* node) { return true; }
-bool analyze_unaryop(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) { return true; }
-bool analyze_compare(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) {
+bool analyze_unaryop(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) { return true; }
+bool analyze_compare(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
     if (!analyzer || !node || node->type != AST_COMPARE) return false;
     
     // Analyze left operand
-    char* left_type = NULL;
+    const Type* left_type = NULL;
     if (!analyze_expression(analyzer, node->compare.left, &left_type)) {
         return false;
     }
     
     // Analyze comparators (right operands)
     for (size_t i = 0; i < node->compare.comparators->count; i++) {
-        char* right_type = NULL;
+        const Type* right_type = NULL;
         if (!analyze_expression(analyzer, node->compare.comparators->items[i], &right_type)) {
-            free(left_type);
             return false;
         }
         
@@ -1156,27 +1302,59 @@ bool analyze_compare(SemanticAnalyzer* analyzer, ASTNode* node, char** result_ty
         if (left_type && right_type && !types_compatible(left_type, right_type) &&
             !types_compatible(right_type, left_type)) {
             // Allow numeric type comparisons
-            bool left_numeric = (strcmp(left_type, "int") == 0 || strcmp(left_type, "float") == 0);
-            bool right_numeric = (strcmp(right_type, "int") == 0 || strcmp(right_type, "float") == 0);
-            if (!left_numeric || !right_numeric) {
+            if (!type_is_numeric(left_type) || !type_is_numeric(right_type)) {
                 semantic_error(analyzer, "Cannot compare incompatible types");
-                free(left_type);
-                free(right_type);
                 return false;
             }
         }
         
-        free(right_type);
     }
     
-    free(left_type);
     
     // Comparison always returns bool
     if (result_type) {
-        *result_type = strdup("bool");
+        *result_type = type_primitive(TYPE_BOOL);
     }
     
     return true;
 }
-bool analyze_boolop(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) { return true; }
-bool analyze_subscript(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type) { return true; }
\ No newline at end of file
+bool analyze_boolop(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) { return true; }
+// An index is marked in bounds when it is a constant inside the array or a
+// loop variable whose range() limit fits the array; --bounds-check skips those.
+bool analyze_subscript(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type) {
+    if (!analyzer || !node || node->type != AST_SUBSCRIPT) return false;
+    
+    const Type* value_type = NULL;
+    const Type* index_type = NULL;
+    if (!analyze_expression(analyzer, node->subscript.value, &value_type) ||
+        !analyze_expression(analyzer, node->subscript.slice, &index_type)) {
+        return false;
+    }
+    if (value_type && value_type->kind != TYPE_ARRAY && value_type->kind != TYPE_PTR) {
+        semantic_error(analyzer, "Only arrays and pointers can be subscripted");
+        return false;
+    }
+    if (index_type && index_type->kind != TYPE_INT) {
+        semantic_error(analyzer, "Array index must be an integer");
+        return false;
+    }
+    
+    const ASTNode* index = node->subscript.slice;
+    if (value_type && value_type->kind == TYPE_ARRAY && value_type->size > 0) {
+        int size = value_type->size;
+        if (index->type == AST_CONSTANT && index->constant.value.type == CONST_INT) {
+            int value = index->constant.value.int_val;
+            if (value < 0 || value >= size) {
+                semantic_error(analyzer, "Array index out of bounds");
+                return false;
+            }
+            node->subscript.in_bounds = true;
+        } else if (index->type == AST_NAME) {
+            Symbol* symbol = symbol_table_lookup(analyzer->symbol_table, index->name.id);
+            node->subscript.in_bounds = symbol && symbol->loop_bound > 0 && symbol->loop_bound <= size;
+        }
+    }
+    
+    if (result_type) *result_type = value_type ? value_type->base : NULL;
+    return true;
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define SEMANTIC_H
 
 #include "ast.h"
+#include "types.h"
 #include <stdbool.h>
 
 // Symbol types
@@ -23,23 +24,23 @@ typedef struct SemanticAnalyzer SemanticAnalyzer;
 struct Symbol {
     char* name;
     SymbolType type;
-    char* value_type;  // Type of the symbol (int, float, etc.)
+    const Type* value_type;  // Type of the symbol (int, float, etc.)
     
     // Function-specific
-    StringArray* param_types;
-    char* return_type;
+    TypeList* param_types;
+    const Type* return_type;
     
     // Struct/Interface-specific
     struct {
         char** field_names;
-        char** field_types;
+        const Type** field_types;
         size_t field_count;
     } fields;
     
     struct {
         char** method_names;
-        StringArray** method_param_types;
-        char** method_return_types;
+        TypeList** method_param_types;
+        const Type** method_return_types;
         size_t method_count;
     } methods;
     
@@ -54,6 +55,10 @@ struct Symbol {
     bool immutable;
     bool is_c_function;
     char* c_library;
+    bool is_comptime;     // @comptime: calls with constant arguments are evaluated
+    bool is_inline;       // @inline: emitted static inline whatever its size
+    ASTNode* definition;  // FunctionDef of a @comptime function
+    int loop_bound;  // n for a loop variable over range(n) that the body never assigns, else 0
     
     // Interface implementation
     StringArray* implements;
@@ -62,11 +67,14 @@ struct Symbol {
     SymbolTable* exports;
 };
 
-// Symbol table scope
+// Symbol table scope. `symbols` keeps declaration order for codegen;
+// `slots` is an open-addressing index keyed by interned name pointer.
 typedef struct Scope {
     Symbol** symbols;
     size_t count;
     size_t capacity;
+    Symbol** slots;
+    size_t slot_capacity;  // Always a power of two
     struct Scope* parent;
 } Scope;
 
@@ -74,12 +82,13 @@ typedef struct Scope {
 struct SymbolTable {
     Scope* current_scope;
     Scope* global_scope;
+    size_t symbol_count;  // Symbols inserted in any scope
 };
 
 // Semantic analyzer
 struct SemanticAnalyzer {
     SymbolTable* symbol_table;
-    char* current_function_return_type;
+    const Type* current_function_return_type;
     int loop_depth;
     StringArray* loop_labels;
     
@@ -98,30 +107,29 @@ struct SemanticAnalyzer {
 };
 
 // Symbol management
-Symbol* symbol_new(const char* name, SymbolType type, const char* value_type);
-void symbol_free(Symbol* symbol);
-void symbol_add_field(Symbol* symbol, const char* field_name, const char* field_type);
-void symbol_add_method(Symbol* symbol, const char* method_name, StringArray* param_types, const char* return_type);
+Symbol* symbol_new(const char* name, SymbolType type, const Type* value_type);
+void symbol_add_field(Symbol* symbol, const char* field_name, const Type* field_type);
+void symbol_add_method(Symbol* symbol, const char* method_name, TypeList* param_types, const Type* return_type);
 void symbol_add_enum_member(Symbol* symbol, const char* member_name, int value);
 
 // Scope management
 Scope* scope_new(Scope* parent);
-void scope_free(Scope* scope);
 void scope_insert(Scope* scope, Symbol* symbol);
+// Lookups take interned names (AST identifiers and type names already are)
 Symbol* scope_lookup(Scope* scope, const char* name);
 
 // Symbol table management
 SymbolTable* symbol_table_new(void);
-void symbol_table_free(SymbolTable* table);
 void symbol_table_push_scope(SymbolTable* table);
 void symbol_table_pop_scope(SymbolTable* table);
 void symbol_table_insert(SymbolTable* table, Symbol* symbol);
 Symbol* symbol_table_lookup(SymbolTable* table, const char* name);
 Symbol* symbol_table_lookup_current_scope(SymbolTable* table, const char* name);
+// For un-interned strings such as built-in names
+Symbol* symbol_table_lookup_str(SymbolTable* table, const char* str);
 
 // Semantic analyzer
 SemanticAnalyzer* semantic_analyzer_new(const char* current_file);
-void semantic_analyzer_free(SemanticAnalyzer* analyzer);
 
 // Analysis functions
 bool analyze_ast(SemanticAnalyzer* analyzer, ASTNode* node);
@@ -133,27 +141,24 @@ bool analyze_ann_assign(SemanticAnalyzer* analyzer, ASTNode* node);
 bool analyze_if(SemanticAnalyzer* analyzer, ASTNode* node);
 bool analyze_while(SemanticAnalyzer* analyzer, ASTNode* node);
 bool analyze_for(SemanticAnalyzer* analyzer, ASTNode* node);
+bool is_parallel_for(const ASTNode* node);  // for ... in prange(n)
+// Pushes the names a prange body declares, including nested loop variables
+void collect_private_names(NodeArray* body, StringArray* names);
 bool analyze_return(SemanticAnalyzer* analyzer, ASTNode* node);
-bool analyze_expression(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_name(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_constant(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_binop(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_unaryop(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_compare(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_boolop(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_call(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_attribute(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
-bool analyze_subscript(SemanticAnalyzer* analyzer, ASTNode* node, char** result_type);
+bool analyze_expression(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_name(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_constant(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_binop(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_unaryop(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_compare(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_boolop(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_call(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_attribute(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
+bool analyze_subscript(SemanticAnalyzer* analyzer, ASTNode* node, const Type** result_type);
 
 // Type utilities
-char* get_type_name(ASTNode* annotation);
-bool types_compatible(const char* type1, const char* type2);
-bool is_pointer_type(const char* type);
-bool is_array_type(const char* type);
-bool is_result_type(const char* type);
-char* extract_pointer_base_type(const char* pointer_type);
-void parse_array_type(const char* array_type, char** base_type, int* size);
-void parse_result_type(const char* result_type, char** success_type, char** error_type);
+const Type* get_type_name(ASTNode* annotation);
+bool types_compatible(const Type* type1, const Type* type2);
 
 // Error handling
 void semantic_error(SemanticAnalyzer* analyzer, const char* message);
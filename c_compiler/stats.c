@@ -0,0 +1,88 @@
+// clock_gettime and getrusage are POSIX, outside -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+static const char* phase_names[PHASE_COUNT] = {
+    "lex", "parse", "semantic", "optimize", "codegen", "write", "compile", "link"
+};
+
+static double wall_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double timeval_seconds(struct timeval tv) {
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+}
+
+// User and system time of this process and its waited-for children
+static double cpu_now(void) {
+    struct rusage self, children;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+    return timeval_seconds(self.ru_utime) + timeval_seconds(self.ru_stime) +
+           timeval_seconds(children.ru_utime) + timeval_seconds(children.ru_stime);
+}
+
+void stats_init(CompilerStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+void stats_begin(CompilerStats* stats, CompilerPhase phase) {
+    stats->phases[phase].start_wall = wall_now();
+    stats->phases[phase].start_cpu = cpu_now();
+}
+
+void stats_end(CompilerStats* stats, CompilerPhase phase) {
+    PhaseTime* time = &stats->phases[phase];
+    time->wall_seconds += wall_now() - time->start_wall;
+    time->cpu_seconds += cpu_now() - time->start_cpu;
+}
+
+static void record_peak_rss(CompilerStats* stats) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) stats->peak_rss_kb = usage.ru_maxrss;
+}
+
+void stats_print(CompilerStats* stats, FILE* out) {
+    record_peak_rss(stats);
+    double total_wall = 0, total_cpu = 0;
+
+    fprintf(out, "\nPhase         Wall (ms)   CPU (ms)\n");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseTime* time = &stats->phases[i];
+        fprintf(out, "%-12s %10.3f %10.3f\n", phase_names[i], time->wall_seconds * 1e3, time->cpu_seconds * 1e3);
+        total_wall += time->wall_seconds;
+        total_cpu += time->cpu_seconds;
+    }
+    fprintf(out, "%-12s %10.3f %10.3f\n\n", "total", total_wall * 1e3, total_cpu * 1e3);
+
+    fprintf(out, "Source bytes:     %zu\n", stats->source_bytes);
+    fprintf(out, "Tokens:           %zu\n", stats->tokens);
+    fprintf(out, "AST nodes:        %zu\n", stats->ast_nodes);
+    fprintf(out, "Symbols:          %zu\n", stats->symbols);
+    fprintf(out, "Identifiers:      %zu\n", stats->identifiers);
+    fprintf(out, "Arena allocated:  %zu bytes (%zu reserved)\n", stats->arena_allocated, stats->arena_reserved);
+    fprintf(out, "Generated C:      %zu bytes\n", stats->c_bytes);
+    fprintf(out, "Peak RSS:         %ld KB\n", stats->peak_rss_kb);
+}
+
+void stats_print_json(CompilerStats* stats, FILE* out) {
+    record_peak_rss(stats);
+
+    fprintf(out, "{\"phases\": {");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        fprintf(out, "%s\"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}", i ? ", " : "", phase_names[i],
+                stats->phases[i].wall_seconds * 1e3, stats->phases[i].cpu_seconds * 1e3);
+    }
+    fprintf(out, "}, \"source_bytes\": %zu, \"tokens\": %zu, \"ast_nodes\": %zu, \"symbols\": %zu, "
+                 "\"identifiers\": %zu, \"arena_allocated\": %zu, \"arena_reserved\": %zu, "
+                 "\"c_bytes\": %zu, \"peak_rss_kb\": %ld}\n",
+            stats->source_bytes, stats->tokens, stats->ast_nodes, stats->symbols, stats->identifiers,
+            stats->arena_allocated, stats->arena_reserved, stats->c_bytes, stats->peak_rss_kb);
+}
@@ -0,0 +1,52 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Compiler phase timing and memory statistics for --time-report and
+// --stats-json. CPU time includes child processes, so the compile and
+// link phases report the C compiler's time.
+typedef enum {
+    PHASE_LEX,
+    PHASE_PARSE,
+    PHASE_SEMANTIC,
+    PHASE_OPTIMIZE,
+    PHASE_CODEGEN,
+    PHASE_WRITE,
+    PHASE_COMPILE,
+    PHASE_LINK,
+    PHASE_COUNT
+} CompilerPhase;
+
+typedef struct {
+    double wall_seconds;
+    double cpu_seconds;
+    double start_wall;
+    double start_cpu;
+} PhaseTime;
+
+typedef struct {
+    PhaseTime phases[PHASE_COUNT];
+    size_t source_bytes;
+    size_t tokens;
+    size_t ast_nodes;
+    size_t symbols;
+    size_t identifiers;      // Distinct interned names
+    size_t arena_allocated;  // Bytes handed out by the front-end arena
+    size_t arena_reserved;   // Bytes the arena obtained from malloc
+    size_t c_bytes;          // Size of the generated C file
+    long peak_rss_kb;
+} CompilerStats;
+
+void stats_init(CompilerStats* stats);
+void stats_begin(CompilerStats* stats, CompilerPhase phase);
+void stats_end(CompilerStats* stats, CompilerPhase phase);
+
+// Human-readable table, and one JSON object for CI. Both record peak RSS
+// at the time they are called.
+void stats_print(CompilerStats* stats, FILE* out);
+void stats_print_json(CompilerStats* stats, FILE* out);
+
+#endif // STATS_H
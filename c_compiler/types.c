@@ -0,0 +1,287 @@
+#include "types.h"
+#include "arena.h"
+#include "intern.h"
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TYPE_TABLE_INITIAL_CAPACITY 64
+
+typedef struct {
+    const Type** slots;
+    size_t count;
+    size_t capacity;  // Always a power of two
+    const Type* primitives[TYPE_NAMED];
+} TypeTable;
+
+static TypeTable table;
+
+static const struct {
+    TypeKind kind;
+    const char* spelling;
+    const char* c_spelling;
+} primitive_info[] = {
+    {TYPE_INT, "int", "int"},
+    {TYPE_FLOAT, "float", "float"},
+    {TYPE_BOOL, "bool", "int"},
+    {TYPE_STR, "str", "PyrStr"},
+    {TYPE_VOID, "void", "void"},
+    {TYPE_NONE, "None", "void"},
+    {TYPE_RANGE, "range_object", "int"},
+};
+
+static size_t type_hash(TypeKind kind, const Type* base, const Type* error, int size, const char* name) {
+    size_t hash = (size_t)kind * 31u + (size_t)size;
+    hash = hash * 31u + ((uintptr_t)base >> 4);
+    hash = hash * 31u + ((uintptr_t)error >> 4);
+    hash = hash * 31u + ((uintptr_t)name >> 4);
+    return hash * (size_t)0x9E3779B97F4A7C15ULL;
+}
+
+static bool type_matches(const Type* type, TypeKind kind, const Type* base, const Type* error,
+                         int size, const char* name) {
+    return type->kind == kind && type->base == base && type->error == error &&
+           type->size == size && type->name == name;
+}
+
+static const Type** type_slot(const Type** slots, size_t capacity, TypeKind kind, const Type* base,
+                              const Type* error, int size, const char* name) {
+    size_t mask = capacity - 1;
+    size_t index = type_hash(kind, base, error, size, name) & mask;
+
+    while (slots[index] && !type_matches(slots[index], kind, base, error, size, name)) {
+        index = (index + 1) & mask;
+    }
+    return &slots[index];
+}
+
+static bool type_table_grow(void) {
+    size_t new_capacity = table.capacity ? table.capacity * 2 : TYPE_TABLE_INITIAL_CAPACITY;
+    const Type** slots = arena_calloc(arena_current(), new_capacity, sizeof(Type*));
+    if (!slots) return false;
+
+    for (size_t i = 0; i < table.capacity; i++) {
+        const Type* type = table.slots[i];
+        if (type) {
+            *type_slot(slots, new_capacity, type->kind, type->base, type->error,
+                       type->size, type->name) = type;
+        }
+    }
+
+    table.slots = slots;
+    table.capacity = new_capacity;
+    return true;
+}
+
+static char* concat3(const char* a, const char* b, const char* c) {
+    size_t length = strlen(a) + strlen(b) + strlen(c);
+    char* result = arena_alloc(arena_current(), length + 1);
+    if (result) {
+        snprintf(result, length + 1, "%s%s%s", a, b, c);
+    }
+    return result;
+}
+
+// Build both spellings once, when the type is first created
+static void type_spell(Type* type) {
+    char size_buf[32];
+
+    switch (type->kind) {
+        case TYPE_PTR:
+            type->spelling = concat3("ptr[", type->base->spelling, "]");
+            type->c_spelling = concat3(type->base->c_spelling, "*", "");
+            break;
+        case TYPE_ARRAY:
+            if (type->size > 0) {
+                snprintf(size_buf, sizeof(size_buf), ", %d]", type->size);
+                type->spelling = concat3("array[", type->base->spelling, size_buf);
+            } else {
+                type->spelling = concat3("array[", type->base->spelling, "]");
+            }
+            type->c_spelling = concat3(type->base->c_spelling, "*", "");  // Arrays become pointers in function params
+            break;
+        case TYPE_RESULT: {
+            char* head = concat3("Result[", type->base->spelling, ", ");
+            type->spelling = concat3(head, type->error->spelling, "]");
+            type->c_spelling = "Result";
+            break;
+        }
+        case TYPE_NAMED:
+            type->spelling = type->name;
+            type->c_spelling = concat3("struct ", type->name, "");
+            break;
+        default:
+            break;
+    }
+}
+
+static const Type* type_get(TypeKind kind, const Type* base, const Type* error, int size, const char* name) {
+    // Keep the load factor under 1/2
+    if (table.count * 2 >= table.capacity && !type_table_grow()) return NULL;
+
+    const Type** slot = type_slot(table.slots, table.capacity, kind, base, error, size, name);
+    if (*slot) return *slot;
+
+    Type* type = arena_alloc(arena_current(), sizeof(Type));
+    if (!type) return NULL;
+
+    type->kind = kind;
+    type->base = base;
+    type->error = error;
+    type->size = size;
+    type->name = name;
+    type->spelling = NULL;
+    type->c_spelling = NULL;
+    type_spell(type);
+
+    *slot = type;
+    table.count++;
+    return type;
+}
+
+void types_init(void) {
+    table.slots = NULL;
+    table.count = 0;
+    table.capacity = 0;
+    type_table_grow();
+
+    for (size_t i = 0; i < sizeof(primitive_info) / sizeof(primitive_info[0]); i++) {
+        Type* type = arena_alloc(arena_current(), sizeof(Type));
+        if (!type) return;
+
+        type->kind = primitive_info[i].kind;
+        type->base = NULL;
+        type->error = NULL;
+        type->size = 0;
+        type->name = NULL;
+        type->spelling = primitive_info[i].spelling;
+        type->c_spelling = primitive_info[i].c_spelling;
+        table.primitives[type->kind] = type;
+    }
+}
+
+// Type constructors
+const Type* type_primitive(TypeKind kind) {
+    if (kind >= TYPE_NAMED) return NULL;
+    return table.primitives[kind];
+}
+
+const Type* type_named(const char* name) {
+    if (!name) return NULL;
+
+    for (size_t i = 0; i < sizeof(primitive_info) / sizeof(primitive_info[0]); i++) {
+        if (strcmp(name, primitive_info[i].spelling) == 0) {
+            return table.primitives[primitive_info[i].kind];
+        }
+    }
+
+    return type_get(TYPE_NAMED, NULL, NULL, 0, intern(name));
+}
+
+const Type* type_pointer(const Type* base) {
+    if (!base) return NULL;
+    return type_get(TYPE_PTR, base, NULL, 0, NULL);
+}
+
+const Type* type_array(const Type* base, int size) {
+    if (!base) return NULL;
+    return type_get(TYPE_ARRAY, base, NULL, size, NULL);
+}
+
+const Type* type_result(const Type* success, const Type* error) {
+    if (!success || !error) return NULL;
+    return type_get(TYPE_RESULT, success, error, 0, NULL);
+}
+
+// Spelling parser
+static void skip_spaces(const char** cursor) {
+    while (**cursor == ' ') (*cursor)++;
+}
+
+static bool expect_char(const char** cursor, char c) {
+    skip_spaces(cursor);
+    if (**cursor != c) return false;
+    (*cursor)++;
+    return true;
+}
+
+static const Type* parse_spelling(const char** cursor) {
+    skip_spaces(cursor);
+
+    const char* start = *cursor;
+    while (isalnum((unsigned char)**cursor) || **cursor == '_') (*cursor)++;
+    size_t length = *cursor - start;
+    if (length == 0) return NULL;
+
+    char* name = intern_n(start, length);
+    skip_spaces(cursor);
+    if (**cursor != '[') return type_named(name);
+    (*cursor)++;
+
+    const Type* result = NULL;
+    if (strcmp(name, "ptr") == 0) {
+        result = type_pointer(parse_spelling(cursor));
+    } else if (strcmp(name, "array") == 0) {
+        const Type* base = parse_spelling(cursor);
+        int size = 0;
+        if (expect_char(cursor, ',')) {
+            skip_spaces(cursor);
+            size = atoi(*cursor);
+            while (isdigit((unsigned char)**cursor)) (*cursor)++;
+        }
+        result = type_array(base, size);
+    } else if (strcmp(name, "Result") == 0) {
+        const Type* success = parse_spelling(cursor);
+        if (!expect_char(cursor, ',')) return NULL;
+        result = type_result(success, parse_spelling(cursor));
+    } else if (strcmp(name, "Final") == 0) {
+        result = parse_spelling(cursor);
+    }
+
+    if (!expect_char(cursor, ']')) return NULL;
+    return result;
+}
+
+const Type* type_from_spelling(const char* spelling) {
+    if (!spelling) return NULL;
+
+    const char* cursor = spelling;
+    const Type* type = parse_spelling(&cursor);
+    skip_spaces(&cursor);
+    return *cursor == '\0' ? type : NULL;
+}
+
+// Type queries
+bool type_is_numeric(const Type* type) {
+    return type && (type->kind == TYPE_INT || type->kind == TYPE_FLOAT);
+}
+
+// Type list management
+TypeList* type_list_new(void) {
+    TypeList* list = arena_alloc(arena_current(), sizeof(TypeList));
+    if (!list) return NULL;
+
+    list->capacity = 4;
+    list->items = arena_alloc(arena_current(), sizeof(Type*) * list->capacity);
+    if (!list->items) return NULL;
+    list->count = 0;
+    return list;
+}
+
+void type_list_push(TypeList* list, const Type* type) {
+    if (!list || !type) return;
+
+    if (list->count >= list->capacity) {
+        size_t new_capacity = list->capacity * 2;
+        const Type** new_items = arena_grow(arena_current(), list->items,
+                                            sizeof(Type*) * list->capacity,
+                                            sizeof(Type*) * new_capacity);
+        if (!new_items) return;
+        list->items = new_items;
+        list->capacity = new_capacity;
+    }
+
+    list->items[list->count++] = type;
+}
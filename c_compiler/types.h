@@ -0,0 +1,64 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Type kinds
+typedef enum {
+    TYPE_INT,
+    TYPE_FLOAT,
+    TYPE_BOOL,
+    TYPE_STR,
+    TYPE_VOID,
+    TYPE_NONE,
+    TYPE_RANGE,     // Value produced by range()
+    TYPE_PTR,       // ptr[base]
+    TYPE_ARRAY,     // array[base, size]
+    TYPE_RESULT,    // Result[base, error]
+    TYPE_NAMED      // User-defined struct/enum/interface
+} TypeKind;
+
+// Types are hash-consed: structurally equal types are the same object, so
+// type equality is pointer equality. All types live in the compilation-unit
+// arena and are immutable once built.
+typedef struct Type {
+    TypeKind kind;
+    const struct Type* base;    // Pointee, element or success type
+    const struct Type* error;   // Result error type
+    int size;                   // Array length (0 if unspecified)
+    const char* name;           // Interned name for TYPE_NAMED
+    const char* spelling;       // Pyrinas spelling, e.g. "ptr[int]"
+    const char* c_spelling;     // Cached C spelling, e.g. "int*"
+} Type;
+
+// Ordered list of types (parameter lists)
+typedef struct {
+    const Type** items;
+    size_t count;
+    size_t capacity;
+} TypeList;
+
+// Start a fresh type table in arena_current(); call once per compilation
+// unit after intern_init().
+void types_init(void);
+
+// Type constructors (return the unique instance). type_named() maps
+// builtin names such as "int" to their primitive type.
+const Type* type_primitive(TypeKind kind);
+const Type* type_named(const char* name);
+const Type* type_pointer(const Type* base);
+const Type* type_array(const Type* base, int size);
+const Type* type_result(const Type* success, const Type* error);
+
+// Parse a textual type such as "ptr[array[int, 5]]"; NULL if malformed
+const Type* type_from_spelling(const char* spelling);
+
+// Type queries
+bool type_is_numeric(const Type* type);
+
+// Type list management
+TypeList* type_list_new(void);
+void type_list_push(TypeList* list, const Type* type);
+
+#endif // TYPES_H
@@ -0,0 +1,132 @@
+"""
+Incremental Build Cache for Pyrinas Modules
+
+Each imported module is analyzed and compiled to its own object file once,
+then reused until its source, the compiler or the build options change.
+Entries live under <cache_dir>/modules/<key>/:
+
+- summary.pickle: the module's exports and C interop needs
+- module.h: its struct layouts and prototypes, for the files that import it
+- module.c, module.o: the module compiled on its own
+
+The directory key hashes the source, the module's name prefix, the compiler
+and the options. The full key also hashes the full keys of the modules it
+imports, and an entry is only used if its full key matches, so a change
+propagates to every module that depends on it. The full key also holds
+the variant, for builds that compile the same code differently into the
+same entry, i.e. with and without a PGO profile.
+"""
+
+import hashlib
+import os
+import pickle
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from pyrinas.semantic import SymbolTable
+
+PACKAGE_DIR = Path(__file__).resolve().parent
+RUNTIME_HEADER = PACKAGE_DIR.parent / 'runtime' / 'pyrinas.h'
+
+_fingerprint = None
+
+# Summaries already read or written by this process, by directory key, so
+# a long-running compile server does not unpickle them again
+_resident: Dict[str, dict] = {}
+
+def compiler_fingerprint() -> str:
+    """Hash of the compiler's own sources and the runtime header."""
+    global _fingerprint
+    if _fingerprint is None:
+        digest = hashlib.sha256()
+        sources = sorted(PACKAGE_DIR.glob('*.py'))
+        if RUNTIME_HEADER.exists():
+            sources.append(RUNTIME_HEADER)
+        for path in sources:
+            digest.update(path.name.encode())
+            digest.update(path.read_bytes())
+        _fingerprint = digest.hexdigest()
+    return _fingerprint
+
+
+class ModuleSummary:
+    """
+    Stands in for the SemanticAnalyzer of a module once it has been loaded.
+    Only the global symbols the module exports are kept. summary is what is
+    stored in the cache: the module's name prefix, exports, C interop needs
+    and full key.
+    """
+    def __init__(self, current_file: str, summary: dict, entry: Path, source_key: str,
+                 imported_modules: Dict[str, 'ModuleSummary'], compiled: bool):
+        self.current_file = current_file
+        self.summary = summary
+        self.module_prefix = summary['module_prefix']
+        self.symbol_table = SymbolTable()
+        for symbol in summary['exports'].values():
+            self.symbol_table.insert(symbol)
+        self.c_includes = set(summary['c_includes'])
+        self.c_libraries = set(summary['c_libraries'])
+        self.imported_modules = imported_modules
+        self.source_key = source_key
+        self.cache_key = summary['cache_key']
+        self.header_file = str(entry / 'module.h')
+        self.object_file = str(entry / 'module.o')
+        self.compiled = compiled
+
+
+class ModuleCache:
+    """
+    Content-addressed store of module summaries and objects. options_key
+    identifies everything about the build that changes the generated code
+    or the object, e.g. the C compiler and its flags; variant only changes
+    the object, and keeps its directory.
+    """
+    def __init__(self, cache_dir: Path, options_key: str, variant: str = ''):
+        self.root = Path(cache_dir) / 'modules'
+        self.root.mkdir(parents=True, exist_ok=True)
+        self.options_key = options_key
+        self.variant = variant
+
+    def source_key(self, source: str, module_prefix: str) -> str:
+        """Directory key: the source, the names it is compiled under, the compiler and the options."""
+        digest = hashlib.sha256()
+        for part in (compiler_fingerprint(), self.options_key, module_prefix, source):
+            digest.update(part.encode())
+            digest.update(b'\0')
+        return digest.hexdigest()[:32]
+
+    def module_key(self, source_key: str, dependency_keys: List[str]) -> str:
+        """Full key: the directory key, the variant and the keys of every imported module."""
+        digest = hashlib.sha256((source_key + self.variant).encode())
+        for key in dependency_keys:
+            digest.update(key.encode())
+        return digest.hexdigest()[:32]
+
+    def entry_dir(self, source_key: str) -> Path:
+        return self.root / source_key
+
+    def load(self, source_key: str, cache_key: str) -> Optional[dict]:
+        """The stored summary for this source and these imports, or None if there is no complete one."""
+        entry = self.entry_dir(source_key)
+        summary = _resident.get(source_key)
+        if summary is None:
+            try:
+                with open(entry / 'summary.pickle', 'rb') as f:
+                    summary = pickle.load(f)
+            except (OSError, pickle.UnpicklingError, EOFError, AttributeError):
+                return None
+            _resident[source_key] = summary
+        if summary.get('cache_key') != cache_key:
+            return None
+        if not all((entry / name).exists() for name in ('module.h', 'module.o')):
+            return None
+        return summary
+
+    def store(self, source_key: str, summary: dict):
+        """Writes the summary last, so an entry is only complete once its header and object exist."""
+        entry = self.entry_dir(source_key)
+        tmp = entry / f'summary.pickle.{os.getpid()}'
+        with open(tmp, 'wb') as f:
+            pickle.dump(summary, f)
+        os.replace(tmp, entry / 'summary.pickle')
+        _resident[source_key] = summary
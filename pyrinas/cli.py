@@ -1,76 +1,334 @@
 import argparse
 import os
 import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+from contextlib import contextmanager
 from pyrinas.parser import get_ast
 from pyrinas.semantic import SemanticAnalyzer, ParentageVisitor
-from pyrinas.codegen import CCodeGenerator
+from pyrinas.codegen import CCodeGenerator, write_line_map
 from pyrinas.module_resolver import ModuleResolver
+from pyrinas import daemon, pgo
 
-def compile_file(input_file, output_file_c, output_executable):
+RUNTIME_DIR = 'runtime'
+
+class BuildOptions:
+    """
+    C backend settings. Every profile other than the default gets its own
+    runtime object under runtime/build/<profile>/, so the runtime is always
+    compiled with the same flags (and LTO mode) as the program.
+    """
+    def __init__(self, cc='gcc', opt_level=0, target_cpu=None, lto=False, bounds_check=False, simd=False,
+                 module_cache=True, jobs=None, profile=False, debug=False, pgo_mode=None, pgo_dir=None):
+        self.cc = cc
+        self.opt_level = opt_level
+        self.target_cpu = target_cpu
+        self.lto = lto
+        # Code generation only; these do not affect the runtime build
+        self.bounds_check = bounds_check
+        self.simd = simd
+        self.profile = profile
+        # -g: debug info, and #line directives back to the .pyr source
+        self.debug = debug
+        # Compile imported modules separately and reuse them across builds
+        self.module_cache = module_cache
+        self.jobs = jobs or os.cpu_count() or 1
+        # 'generate' or 'use': build with -fprofile-generate or -fprofile-use
+        # (see pgo.py); pgo_units collects the profile directories used
+        self.pgo = pgo_mode
+        self.pgo_dir = pgo_dir or pgo.DEFAULT_DIR
+        self.pgo_units = set()
+
+    def is_default(self):
+        return self.cc == 'gcc' and self.opt_level == 0 and not self.target_cpu and not self.lto and not self.pgo
+
+    def flags(self):
+        """Flags shared by the runtime and the program."""
+        flags = [f'-O{self.opt_level}']
+        if self.target_cpu:
+            flags.append(f'-march={self.target_cpu}')
+        if self.lto:
+            flags.append('-flto')
+        return flags
+
+    def cache_key(self):
+        """Everything that changes a separately compiled module."""
+        return ' '.join([self.cc] + self.flags() + [f'bounds_check={self.bounds_check}', f'simd={self.simd}',
+                                                     f'profile={self.profile}', f'debug={self.debug}'])
+
+    def pgo_key(self):
+        """Variant of a cached module's object: which PGO build, and for -fprofile-use, which profile."""
+        if self.pgo == 'use':
+            return f'pgo=use {pgo.profile_key(self.pgo_dir)}'
+        return f'pgo={self.pgo}' if self.pgo else ''
+
+    def profile_name(self):
+        """Directory-safe profile name, e.g. 'gcc-O3-native-lto'."""
+        name = f'{os.path.basename(self.cc)}-O{self.opt_level}'
+        if self.target_cpu:
+            name += f'-{self.target_cpu}'
+        if self.lto:
+            name += '-lto'
+        if self.pgo:
+            name += f'-pgo-{self.pgo}'
+        return ''.join(c if c.isalnum() or c in '-_.' else '_' for c in name)
+
+def runtime_object(options):
+    """
+    Returns the runtime object for this profile, compiling it if it is
+    missing or older than the runtime sources.
     """
-    Compiles a single Pyrinas file.
+    # The default profile uses the object built by the top-level Makefile
+    if options.is_default():
+        return os.path.join(RUNTIME_DIR, 'pyrinas.o')
+
+    build_dir = os.path.join(RUNTIME_DIR, 'build', options.profile_name())
+    obj = os.path.join(build_dir, 'pyrinas.o')
+    sources = [os.path.join(RUNTIME_DIR, name) for name in ('pyrinas.c', 'pyrinas.h')]
+    # An object built with a profile is stale once the profile is recorded again
+    inputs = sources + ([pgo.profile_file(options, sources[0], obj, sources[1:])] if options.pgo == 'use' else [])
+
+    if os.path.exists(obj) and all(os.path.getmtime(src) <= os.path.getmtime(obj) for src in inputs if os.path.exists(src)):
+        return obj
+
+    os.makedirs(build_dir, exist_ok=True)
+    cmd = ([options.cc, '-c', '-I', RUNTIME_DIR] + options.flags() + pgo.compile_flags(options, sources[0], obj, sources[1:])
+           + ['-o', obj, sources[0]])
+    code = run_c_compiler(cmd)
+    if code != 0:
+        print(f"Error during runtime compilation: {subprocess.CalledProcessError(code, cmd)}")
+        exit(1)
+    return obj
+
+def run_c_compiler(cmd):
+    """
+    Runs the C compiler and returns its exit status. Its output goes through
+    sys.stdout and sys.stderr, so a compile server can send it to the client.
+    """
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    sys.stdout.write(result.stdout)
+    sys.stderr.write(result.stderr)
+    return result.returncode
+
+@contextmanager
+def _phase(timings, name):
+    """Adds the wall time of the block to timings[name], if timings is given."""
+    start = time.perf_counter()
+    try:
+        yield
+    finally:
+        if timings is not None:
+            timings[name] = timings.get(name, 0.0) + time.perf_counter() - start
+
+def compile_file(input_file, output_file_c, output_executable, options=None, timings=None):
+    """
+    Compiles a single Pyrinas file. Returns the source files the program
+    was built from, the file itself and the modules it imports. If timings
+    is a dict, the seconds spent in each phase are added to it.
     """
     with open(input_file, 'r') as f:
         code = f.read()
     
-    tree = get_ast(code)
+    with _phase(timings, 'parse'):
+        tree = get_ast(code)
     import ast
     print("AST DUMP:")
     print(ast.dump(tree, indent=4))
     
-    ParentageVisitor().visit(tree)
+    with _phase(timings, 'parse'):
+        ParentageVisitor().visit(tree)
     
     # Create module resolver and semantic analyzer
+    options = options or BuildOptions()
     base_path = os.path.dirname(os.path.abspath(input_file))
-    module_resolver = ModuleResolver(base_path)
-    analyzer = SemanticAnalyzer(current_file=input_file, module_resolver=module_resolver)
-    analyzer.visit(tree)
+    with _phase(timings, 'modules'):
+        module_resolver = ModuleResolver(base_path, options if options.module_cache else None)
+        module_resolver.load_imports(code, input_file)
+    with _phase(timings, 'semantic'):
+        analyzer = SemanticAnalyzer(current_file=input_file, module_resolver=module_resolver)
+        analyzer.visit(tree)
     
-    generator = CCodeGenerator(analyzer.symbol_table, analyzer)
-    c_code = generator.generate(tree)
+    with _phase(timings, 'compile'):
+        modules = build_modules(module_resolver, options)
+    with _phase(timings, 'codegen'):
+        generator = CCodeGenerator(analyzer.symbol_table, analyzer, bounds_check=options.bounds_check, simd=options.simd,
+                                   profile=options.profile, line_directives=options.debug)
+        c_code = generator.generate(tree)
     
-    with open(output_file_c, 'w', encoding='utf-8') as f:
-        f.write(c_code)
+    with _phase(timings, 'write'):
+        with open(output_file_c, 'w', encoding='utf-8') as f:
+            f.write(c_code)
+        if options.debug:
+            write_line_map(c_code, output_file_c)
     print(f"Generated C code in {output_file_c}")
 
     # Compile the generated C code
     c_libraries = list(analyzer.c_libraries) if hasattr(analyzer, 'c_libraries') else []
-    compile_c_code(output_file_c, output_executable, c_libraries)
+    for module in modules:
+        c_libraries.extend(lib for lib in sorted(module.c_libraries) if lib not in c_libraries)
+    with _phase(timings, 'compile'):
+        compile_c_code(output_file_c, output_executable, c_libraries, options,
+                       objects=[module.object_file for module in modules])
     print(f"Compiled executable to {output_executable}")
+    return [os.path.abspath(input_file)] + sorted(module_resolver.loaded_modules)
+
+def build_modules(module_resolver, options):
+    """
+    Compiles every imported module whose object was not found in the module
+    cache, in parallel, and returns all the modules that are linked. Their
+    headers and sources were written when they were analyzed. Without the
+    cache, modules are compiled into the program instead and none are
+    returned.
+    """
+    if not module_resolver.module_cache:
+        return []
+    modules = module_resolver.build_order()
+    stale = [module for module in modules if not module.compiled]
+    compile_c_objects([(os.path.splitext(module.object_file)[0] + '.c', module.object_file)
+                       for module in stale], options)
+    for module in stale:
+        module.compiled = True
+        module_resolver.store_module(module)
+        print(f"Compiled module {module.current_file}")
+    return modules
+
+def c_compile_flags(options):
+    """Flags for compiling generated C, shared by modules and the program."""
+    flags = ['-I', RUNTIME_DIR]
+    if not options.is_default():
+        flags.extend(options.flags())
+    if options.opt_level > 0:
+        # Use the static inline Result helpers from pyrinas.h
+        flags.append('-DPYRINAS_INLINE_RUNTIME')
+    if options.debug:
+        flags.append('-g')
+    return flags
+
+def compile_c_objects(units, options):
+    """
+    Compiles (C file, object file) units, running up to
+    options.jobs C compilers at once.
+    """
+    def compile_unit(unit):
+        c_file, object_file = unit
+        cmd = ([options.cc, '-c'] + c_compile_flags(options) + pgo.compile_flags(options, c_file, object_file)
+               + ['-o', object_file, c_file])
+        return run_c_compiler(cmd)
+    
+    with ThreadPoolExecutor(max_workers=options.jobs) as pool:
+        failed = [unit[0] for unit, code in zip(units, pool.map(compile_unit, units)) if code != 0]
+    if failed:
+        print(f"Error during C compilation of {', '.join(failed)}")
+        exit(1)
 
-def compile_c_code(input_file, output_file, c_libraries=None):
+def compile_c_code(input_file, output_file, c_libraries=None, options=None, objects=None):
     """
-    Compiles a C file into an executable.
+    Compiles a C file into an executable, linking any separately compiled
+    module objects.
     """
     if c_libraries is None:
         c_libraries = []
+    if options is None:
+        options = BuildOptions()
     
-    # Build gcc command
-    gcc_cmd = ['gcc', '-I', 'runtime', '-o', output_file, input_file, 'runtime/pyrinas.o']
+    # With PGO the program is compiled on its own first, so its profile is
+    # named after its object
+    program = [input_file]
+    if options.pgo:
+        program = [os.path.splitext(input_file)[0] + '.o']
+        compile_c_objects([(input_file, program[0])], options)
     
-    # Add math library by default for math functions
-    gcc_cmd.append('-lm')
+    # Build compiler command
+    gcc_cmd = [options.cc] + c_compile_flags(options) + pgo.link_flags(options)
+    gcc_cmd.extend(['-o', output_file] + program + list(objects or []) + [runtime_object(options)])
+    
+    # Add math library by default for math functions; the runtime's task
+    # scheduler needs pthreads
+    gcc_cmd.extend(['-lm', '-pthread'])
     
     # Add additional C libraries
     for lib in c_libraries:
         gcc_cmd.append(f'-l{lib}')
     
-    try:
-        subprocess.run(gcc_cmd, check=True)
-    except subprocess.CalledProcessError as e:
-        print(f"Error during C compilation: {e}")
+    code = run_c_compiler(gcc_cmd)
+    if code != 0:
+        print(f"Error during C compilation: {subprocess.CalledProcessError(code, gcc_cmd)}")
         exit(1)
+    if options.pgo:
+        os.remove(program[0])
 
-def main():
+def build_parser():
     parser = argparse.ArgumentParser(description='Pyrinas Compiler')
-    parser.add_argument('input_file', help='The Pyrinas source file to compile.')
+    parser.add_argument('input_file', nargs='?', help='The Pyrinas source file to compile.')
     parser.add_argument('-o', '--output', help='The output file name for the executable.', default='a.out')
-    args = parser.parse_args()
+    parser.add_argument('-O', dest='opt_level', type=int, choices=range(4), default=0,
+                        help='C backend optimization level, -O0 to -O3 (default: 0).')
+    parser.add_argument('--release', action='store_true', help='Optimized build: -O3 with LTO.')
+    parser.add_argument('--target-cpu', help='Pass -march=<cpu> to the C compiler (e.g. native).')
+    parser.add_argument('--lto', action='store_true', help='Link-time optimization across program and runtime.')
+    parser.add_argument('--cc', default='gcc', help='C compiler to use (default: gcc).')
+    parser.add_argument('--bounds-check', action='store_true',
+                        help='Check array indices that are not provably in range.')
+    parser.add_argument('--simd', action='store_true',
+                        help='Mark loops with independent iterations "#pragma GCC ivdep" for vectorization.')
+    parser.add_argument('-g', dest='debug', action='store_true',
+                        help='Debug info, with #line directives and a <file>.c.map line map back to the source.')
+    parser.add_argument('--profile', action='store_true',
+                        help='Time every function; the program prints a profile when it exits.')
+    pgo_group = parser.add_mutually_exclusive_group()
+    pgo_group.add_argument('--pgo-generate', nargs='?', const=pgo.DEFAULT_DIR, metavar='DIR',
+                           help='Instrumented build that records a profile in DIR when run.')
+    pgo_group.add_argument('--pgo-use', nargs='?', const=pgo.DEFAULT_DIR, metavar='DIR',
+                           help='Optimize with the profile recorded in DIR.')
+    parser.add_argument('--pgo-train', metavar='CMD',
+                        help='Build instrumented, run the shell command CMD, then build with its profile '
+                             '(kept in the --pgo-use DIR, if given).')
+    parser.add_argument('--no-cache', action='store_true',
+                        help='Compile imported modules into the program instead of reusing cached objects.')
+    parser.add_argument('-j', '--jobs', type=int, help='Modules to analyze and compile in parallel (default: one per core).')
+    parser.add_argument('--serve', metavar='SOCKET', help='Run a compile server listening on a Unix socket.')
+    parser.add_argument('--connect', metavar='SOCKET', help='Compile through the server listening on SOCKET.')
+    parser.add_argument('--watch', action='store_true', help='Recompile whenever the program or a module it imports changes.')
+    return parser
 
+def run(args):
+    """Compiles the program named by parsed arguments; returns its source files."""
     input_file = args.input_file
     output_file_c = os.path.splitext(input_file)[0] + '.c'
+
+    options = BuildOptions(cc=args.cc, opt_level=args.opt_level, target_cpu=args.target_cpu, lto=args.lto,
+                           bounds_check=args.bounds_check, simd=args.simd, module_cache=not args.no_cache, jobs=args.jobs,
+                           profile=args.profile, debug=args.debug,
+                           pgo_mode='generate' if args.pgo_generate else 'use' if args.pgo_use else None,
+                           pgo_dir=args.pgo_generate or args.pgo_use)
+    if args.release:
+        options.opt_level = 3
+        options.lto = True
     
-    compile_file(input_file, output_file_c, args.output)
+    if args.pgo_train:
+        return pgo.train(lambda o: compile_file(input_file, output_file_c, args.output, o), options, args.pgo_train)
+    return compile_file(input_file, output_file_c, args.output, options)
+
+def main():
+    parser = build_parser()
+    args = parser.parse_args()
+    if args.serve:
+        daemon.serve(args.serve)
+        return
+    if not args.input_file:
+        parser.error('the following arguments are required: input_file')
+
+    if args.connect:
+        # Forward everything but --connect itself
+        argv = sys.argv[1:]
+        index = argv.index('--connect') if '--connect' in argv else None
+        argv = argv[:index] + argv[index + 2:] if index is not None else [a for a in argv if not a.startswith('--connect=')]
+        exit(daemon.request(args.connect, argv))
+    if args.watch:
+        daemon.watch(args)
+        return
+    run(args)
 
 if __name__ == '__main__':
     main()
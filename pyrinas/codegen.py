@@ -1,8 +1,19 @@
 import ast
+import json
+import math
+import os
 import re
 
+from pyrinas.comptime import to_f32
+from pyrinas.semantic import c_parameter, parallel_reductions, result_type_args, type_name_of
+
+# Functions and methods of at most this many statements, nested ones
+# included, are emitted static inline
+INLINE_MAX_STATEMENTS = 4
+
 class CCodeGenerator(ast.NodeVisitor):
-    def __init__(self, symbol_table, semantic_analyzer=None):
+    def __init__(self, symbol_table, semantic_analyzer=None, bounds_check=False, simd=False, profile=False,
+                 line_directives=False):
         self.main_code = []
         self.function_definitions = []
         self.struct_definitions = []
@@ -12,10 +23,45 @@ class CCodeGenerator(ast.NodeVisitor):
         self.current_code_list = None
         self.local_vars = {}  # Track variable types as we encounter them
         self.loop_labels = []
+        self.match_counter = 0
+        self.c_call_counter = 0
+        self.result_types = {}  # Result[T,E] spelling -> specialized C struct name
+        self.current_result_type = None  # Result type of the function being generated
+        self.spawned_functions = set()  # Functions passed to spawn()
+        self.joined_types = set()  # Result types read back by join()
+        self.parallel_bodies = set()  # Functions passed to parallel_for() with shared data
+        self.parallel_loops = []  # (declarations, definition) of each prange loop's chunk function
+        self.const_arrays = set()  # Local arrays declared const (Final or computed by the compiler)
+        self.current_function = None  # C name of the function being generated
+        self.bounds_check = bounds_check  # Check array indices not proven in range
+        self.simd = simd  # Mark loops semantic analysis found independent with ivdep
+        self.profile = profile  # Time every function in the runtime profiler
+        self.line_directives = line_directives  # -g: #line directives pointing back at the source
+        self.module_unit = False  # Generating a module's own header and C file
+        self.inline_definitions = []  # Its inline functions, which go in the header
+        self.uses_unit_statics = False  # The current function uses statics of this C file
 
     def _indent(self):
         return "    " * self.indent_level
 
+    def _line_directive(self, node):
+        source_file = getattr(self.semantic_analyzer, 'current_file', None) or ''
+        return f'#line {node.lineno} {self._c_string_literal(source_file)}'
+
+    def visit(self, node):
+        # -g: each statement in a function body is preceded by the line it
+        # came from, unless it emits nothing
+        if (self.line_directives and self.indent_level > 0 and isinstance(node, ast.stmt)
+                and not isinstance(node, (ast.FunctionDef, ast.ClassDef))):
+            code = self.current_code_list
+            mark = len(code)
+            code.append(self._line_directive(node))
+            result = super().visit(node)
+            if len(code) == mark + 1 and code is self.current_code_list:
+                del code[mark]
+            return result
+        return super().visit(node)
+
     def visit_Module(self, node):
         # First, generate code for all struct definitions
         for item in node.body:
@@ -44,36 +90,86 @@ class CCodeGenerator(ast.NodeVisitor):
         # Skip import helper functions
         if node.name.startswith('_import_'):
             return
+
+        # Array-returning @comptime functions only run in the compiler
+        if getattr(func_symbol, 'is_comptime', False) and (func_symbol.return_type or '').startswith('array['):
+            return
         
+        self.current_function = 'main' if node.name == 'main' else self._c_name(node.name)
         if node.name == 'main':
             self.current_code_list = self.main_code
+            if self.line_directives:
+                self.main_code.append(self._line_directive(node))
             self.main_code.append('int main() {')
         else:
-            self.current_code_list = []
+            self.current_code_list = [self._line_directive(node)] if self.line_directives else []
             return_type_str = func_symbol.return_type
             
             # Handle functions without return types
             if return_type_str is None:
                 return_type = 'void'
             # Handle Result return types
-            elif return_type_str.startswith('Result['):
-                return_type = 'Result'
             else:
                 return_type = self._c_type_from_pyrinas_type(return_type_str)
+            if return_type_str and return_type_str.startswith('Result['):
+                self.current_result_type = return_type_str
                 
-            params = [f'{self._c_type_from_pyrinas_type(func_symbol.param_types[i])} {arg.arg}' for i, arg in enumerate(node.args.args)]
+            restrict = getattr(node, 'restrict_params', set())
+            params = [f'{self._c_type_from_pyrinas_type(func_symbol.param_types[i])}{" restrict" if i in restrict else ""} {arg.arg}'
+                      for i, arg in enumerate(node.args.args)]
+            for i, arg in enumerate(node.args.args):
+                self.local_vars[arg.arg] = func_symbol.param_types[i]
             param_str = ', '.join(params)
-            self.current_code_list.append(f'{return_type} {node.name}({param_str}) {{')
+            inline = 'static inline ' if self._is_inline(node) else ''
+            self.current_code_list.append(f'{inline}{return_type} {self._c_name(node.name)}({param_str}) {{')
 
+        self.uses_unit_statics = False
         self.indent_level += 1
+        if self.profile:
+            source_file = getattr(self.semantic_analyzer, 'current_file', None) or ''
+            self.current_code_list.append(f'{self._indent()}PYRINAS_PROFILE_FUNCTION({self._c_string_literal(node.name)}, '
+                                          f'{self._c_string_literal(source_file)}, {node.lineno});')
         for statement in node.body:
             self.visit(statement)
         self.indent_level -= 1
         self.current_code_list.append('}')
+        self.current_result_type = None
 
         if node.name != 'main':
+            self._export_inline(self.current_code_list, 0)
             self.function_definitions.extend(self.current_code_list)
 
+    def _is_inline(self, node, method=False):
+        """
+        @inline functions, and small ones that do not call themselves, are
+        emitted static inline, so calls to them can be inlined even from
+        other modules compiled on their own.
+        """
+        if any(getattr(decorator, 'id', None) == 'inline' for decorator in node.decorator_list):
+            return True
+        body = node.body[1:] if ast.get_docstring(node) is not None else node.body
+        if sum(isinstance(child, ast.stmt) for stmt in body for child in ast.walk(stmt)) > INLINE_MAX_STATEMENTS:
+            return False
+        callee = 'attr' if method else 'id'
+        return not any(isinstance(child, ast.Call) and getattr(child.func, callee, None) == node.name
+                       for child in ast.walk(node))
+
+    def _export_inline(self, lines, start):
+        """
+        In a module compiled on its own, moves the function in lines[start:],
+        if inline, to the header so other modules can inline it too. If it
+        uses statics of the module's C file (vtables, task helpers), it
+        becomes an ordinary function instead.
+        """
+        signature = next((i for i in range(start, len(lines)) if lines[i].startswith('static inline ')), None)
+        if not self.module_unit or signature is None:
+            return
+        if self.uses_unit_statics:
+            lines[signature] = lines[signature][len('static inline '):]
+        else:
+            self.inline_definitions.extend(lines[start:])
+            del lines[start:]
+
     def visit_ClassDef(self, node):
         class_name = node.name
         
@@ -155,11 +251,75 @@ class CCodeGenerator(ast.NodeVisitor):
         self.struct_definitions.append('')  # Empty line for readability
 
     def _generate_interface_vtable(self, interface_name, methods):
-        """Generate C vtable typedef for an interface"""
-        # For simplicity, we won't generate vtables for now
-        # Instead, we'll use direct method calls
-        # This is a future enhancement for full polymorphism
-        pass
+        """
+        Generate the vtable for an interface and the fat pointer that carries it.
+        An interface value borrows the struct it was made from, which is passed
+        to every entry as a void* receiver.
+        """
+        interface_symbol = self.symbol_table.lookup(interface_name)
+        if interface_symbol and interface_symbol.methods:
+            methods = interface_symbol.methods
+        if not methods:
+            return
+        
+        self.struct_definitions.append(f'struct {interface_name}_vtable {{')
+        for method_name, (param_types, return_type) in methods.items():
+            params = ', '.join(['void* self'] + [self._c_type_from_pyrinas_type(t) for t in param_types])
+            self.struct_definitions.append(f'    {self._c_return_type(return_type)} (*{method_name})({params});')
+        self.struct_definitions.append('};')
+        self.struct_definitions.append('')
+        
+        self.struct_definitions.append(f'struct {interface_name} {{')
+        self.struct_definitions.append('    void* self;')
+        self.struct_definitions.append(f'    const struct {interface_name}_vtable* vtable;')
+        self.struct_definitions.append('};')
+        self.struct_definitions.append('')
+
+    def _generate_vtable_instance(self, struct_name, interface_name):
+        """Generate Struct_Interface_vtable, with thunks adapting the void* receiver."""
+        interface_symbol = self.symbol_table.lookup(interface_name)
+        if not interface_symbol or not interface_symbol.methods:
+            return
+        
+        entries = []
+        for method_name, (param_types, return_type) in interface_symbol.methods.items():
+            thunk_name = f'{struct_name}_{interface_name}_{method_name}'
+            c_return_type = self._c_return_type(return_type)
+            params = ['void* self'] + [f'{self._c_type_from_pyrinas_type(t)} arg{i}' for i, t in enumerate(param_types)]
+            call_args = [f'(struct {struct_name}*)self'] + [f'arg{i}' for i in range(len(param_types))]
+            call = f'{struct_name}_{method_name}({", ".join(call_args)})'
+            
+            self.function_definitions.append(f'static {c_return_type} {thunk_name}({", ".join(params)}) {{')
+            self.function_definitions.append(f'    {call};' if c_return_type == 'void' else f'    return {call};')
+            self.function_definitions.append('}')
+            self.function_definitions.append('')
+            entries.append(f'    .{method_name} = {thunk_name},')
+        
+        self.function_definitions.append(f'static const struct {interface_name}_vtable {struct_name}_{interface_name}_vtable = {{')
+        self.function_definitions.extend(entries)
+        self.function_definitions.append('};')
+        self.function_definitions.append('')
+
+    def _c_return_type(self, return_type):
+        if return_type is None or return_type == 'None':
+            return 'void'
+        return self._c_type_from_pyrinas_type(return_type)
+
+    def _interface_value(self, value_node, target_type, value_code):
+        """
+        Wraps a struct in the fat pointer when it is used where an interface is
+        expected, e.g. (struct Drawable){ &rect, &Rectangle_Drawable_vtable }.
+        """
+        target_symbol = self.symbol_table.lookup(target_type) if isinstance(target_type, str) else None
+        if not target_symbol or target_symbol.type != 'interface':
+            return value_code
+        value_type = self._static_type_of(value_node)
+        if value_type == target_type:
+            return value_code
+        if not isinstance(value_node, (ast.Name, ast.Attribute)) or value_type is None:
+            raise TypeError(f"A '{target_type}' value must be made from a struct variable or field.")
+        self.uses_unit_statics = True
+        return f'(struct {target_type}){{ &{value_code}, &{value_type}_{target_type}_vtable }}'
 
     def _generate_struct_with_methods(self, node, struct_name, methods, has_implementations):
         """Generate C struct definition with method implementations"""
@@ -186,6 +346,11 @@ class CCodeGenerator(ast.NodeVisitor):
         # Generate method implementations if this struct has them
         if has_implementations:
             self._generate_method_implementations(node, struct_name, methods)
+        
+        # One vtable per implemented interface
+        struct_symbol = self.symbol_table.lookup(struct_name)
+        for interface_name in getattr(struct_symbol, 'implements', None) or []:
+            self._generate_vtable_instance(struct_name, interface_name)
 
     def _generate_method_implementations(self, node, struct_name, methods):
         """Generate C function implementations for struct methods"""
@@ -215,7 +380,14 @@ class CCodeGenerator(ast.NodeVisitor):
                 
                 # Generate function header
                 func_name = f'{struct_name}_{method_name}'
-                self.function_definitions.append(f'{return_type} {func_name}({params_str}) {{')
+                self.current_function = func_name
+                self.local_vars['self'] = f'ptr[{struct_name}]'
+                for arg in stmt.args.args[1:]:
+                    self.local_vars[arg.arg] = getattr(arg.annotation, 'id', None) or getattr(arg.annotation, 'value', 'int')
+                start = len(self.function_definitions)
+                inline = 'static inline ' if self._is_inline(stmt, method=True) else ''
+                self.function_definitions.append(f'{inline}{return_type} {func_name}({params_str}) {{')
+                self.uses_unit_statics = False
                 
                 # Generate function body
                 old_indent = self.indent_level
@@ -231,6 +403,7 @@ class CCodeGenerator(ast.NodeVisitor):
                 
                 self.function_definitions.append('}')
                 self.function_definitions.append('')
+                self._export_inline(self.function_definitions, start)
 
     def visit_AnnAssign(self, node):
         var_name = node.target.id
@@ -265,11 +438,16 @@ class CCodeGenerator(ast.NodeVisitor):
                 type_name = f'array[{base_type},{size}]'
             elif annotation_name == 'Result':
                 # Handle Result[success_type, error_type] annotations
-                success_type_node = node.annotation.slice.elts[0]
-                error_type_node = node.annotation.slice.elts[1]
-                success_type = getattr(success_type_node, 'id', None)
-                error_type = getattr(error_type_node, 'id', None)
-                type_name = f'Result[{success_type},{error_type}]'
+                type_name = type_name_of(node.annotation)
+                if type_name is None:
+                    raise TypeError("Result annotation requires a success type and an error type.")
+            elif annotation_name == 'Pool':
+                slice_node = node.annotation.slice
+                elem_type = slice_node.id if isinstance(slice_node, ast.Name) else slice_node.value
+                type_name = f'Pool[{elem_type}]'
+            elif annotation_name == 'task':
+                result_type = getattr(node.annotation.slice, 'id', None) or 'None'
+                type_name = f'task[{result_type}]'
             else:
                 raise TypeError(f"Unsupported subscript annotation: {annotation_name}")
         else:
@@ -280,8 +458,17 @@ class CCodeGenerator(ast.NodeVisitor):
             match = re.match(r'array\[(\w+),\s*(\d+)\]', type_name)
             base_type, size = match.groups()
             c_base_type = self._c_type_from_pyrinas_type(base_type)
+            table = getattr(node.value, 'comptime_value', None)
+            if isinstance(table, list):
+                # Computed by the compiler; no code runs to fill it
+                values = ', '.join(self._comptime_literal(v) for v in table)
+                self.current_code_list.append(f'{self._indent()}static {self._array_alignment(base_type, int(size))}const {c_base_type} {var_name}[{size}] = {{{values}}};')
+                self.local_vars[var_name] = type_name
+                self.const_arrays.add(var_name)
+                return
             const_prefix = 'const ' if is_immutable else ''
-            self.current_code_list.append(f'{self._indent()}{const_prefix}{c_base_type} {var_name}[{size}];')
+            (self.const_arrays.add if is_immutable else self.const_arrays.discard)(var_name)
+            self.current_code_list.append(f'{self._indent()}{self._array_alignment(base_type, int(size))}{const_prefix}{c_base_type} {var_name}[{size}];')
             self.local_vars[var_name] = type_name
             return
 
@@ -292,13 +479,16 @@ class CCodeGenerator(ast.NodeVisitor):
         self.local_vars[var_name] = type_name
         
         if node.value:
-            self.current_code_list.append(f'{self._indent()}{const_prefix}{c_type} {var_name} = {self.visit(node.value)};')
+            value = self._interface_value(node.value, type_name, self.visit(node.value))
+            self.current_code_list.append(f'{self._indent()}{const_prefix}{c_type} {var_name} = {value};')
         else:
             self.current_code_list.append(f'{self._indent()}{const_prefix}{c_type} {var_name};')
 
     def visit_Assign(self, node):
         target = self.visit(node.targets[0])
         value = self.visit(node.value)
+        if isinstance(node.targets[0], ast.Name):
+            value = self._interface_value(node.value, self.local_vars.get(node.targets[0].id), value)
         self.current_code_list.append(f'{self._indent()}{target} = {value};')
 
     def visit_Attribute(self, node):
@@ -310,9 +500,9 @@ class CCodeGenerator(ast.NodeVisitor):
             if self.semantic_analyzer:
                 symbol = self.symbol_table.lookup(name)
                 if symbol and symbol.type == 'module':
-                    # This is module access - return the member name directly
+                    # This is module access - return the member's C name
                     # The semantic analyzer has already validated this exists
-                    return node.attr
+                    return getattr(symbol.exports.get(node.attr), 'c_name', None) or node.attr
             
             # Check if this is enum member access (EnumName.MEMBER)
             # Check if this is an enum type (we can't easily access semantic info here,
@@ -333,8 +523,17 @@ class CCodeGenerator(ast.NodeVisitor):
             return f'{var}.{attr}'
 
     def visit_Subscript(self, node):
+        if isinstance(node.slice, ast.Slice):
+            lower = self.visit(node.slice.lower) if node.slice.lower else '0'
+            upper = self.visit(node.slice.upper) if node.slice.upper else 'LLONG_MAX'
+            return f'pyrinas_str_slice({self.visit(node.value)}, {lower}, {upper})'
         var = self.visit(node.value)
         idx = self.visit(node.slice)
+        if self.bounds_check and not getattr(node, 'index_in_bounds', False):
+            array_type = getattr(node.value, 'pyr_type', None) or self._static_type_of(node.value) or ''
+            match = re.match(r'array\[\w+,\s*(\d+)\]', array_type)
+            if match:
+                idx = f'pyrinas_check_index({idx}, {match.group(1)})'
         return f'{var}[{idx}]'
     
     def visit_Expr(self, node):
@@ -347,15 +546,20 @@ class CCodeGenerator(ast.NodeVisitor):
                 self.current_code_list.append(f'{self._indent()}{expr_result};')
 
     def visit_Match(self, node):
-        subject = self.visit(node.subject)
-        self.current_code_list.append(f'{self._indent()}if ({subject}.type == OK) {{')
+        # Evaluate the subject once; Ok is the expected path
+        subject = f'_match_result_{self.match_counter}'
+        self.match_counter += 1
+        result_type = self._result_type_of(node.subject, 'match')
+        success_type, error_type = result_type_args(result_type)
+        self.current_code_list.append(f'{self._indent()}{self._c_type_from_pyrinas_type(result_type)} {subject} = {self.visit(node.subject)};')
+        self.current_code_list.append(f'{self._indent()}if (PYRINAS_LIKELY({subject}.is_ok)) {{')
         self.indent_level += 1
         
         # Handle the Ok case
         ok_case = node.cases[0]
         ok_var_name = ok_case.pattern.name
-        # This is a simplification; we need to know the type of the value
-        self.current_code_list.append(f'{self._indent()}int {ok_var_name} = {subject}.value.int_val;')
+        self.local_vars[ok_var_name] = success_type
+        self.current_code_list.append(f'{self._indent()}{self._c_type_from_pyrinas_type(success_type)} {ok_var_name} = {subject}.value.ok;')
         for stmt in ok_case.body:
             self.visit(stmt)
         
@@ -366,8 +570,8 @@ class CCodeGenerator(ast.NodeVisitor):
         # Handle the Err case
         err_case = node.cases[1]
         err_var_name = err_case.pattern.name
-        # This is a simplification; we need to know the type of the value
-        self.current_code_list.append(f'{self._indent()}char* {err_var_name} = {subject}.value.str_val;')
+        self.local_vars[err_var_name] = error_type
+        self.current_code_list.append(f'{self._indent()}{self._c_type_from_pyrinas_type(error_type)} {err_var_name} = {subject}.value.err;')
         for stmt in err_case.body:
             self.visit(stmt)
 
@@ -375,19 +579,46 @@ class CCodeGenerator(ast.NodeVisitor):
         self.current_code_list.append(f'{self._indent()}}}')
 
     def visit_Name(self, node):
-        return node.id
+        if node.id in self.local_vars:
+            return node.id
+        return self._c_name(node.id)
+
+    def _c_name(self, name):
+        """C spelling of a global; imported modules prefix their functions and constants."""
+        return getattr(self.symbol_table.lookup(name), 'c_name', None) or name
         
     def visit_Constant(self, node):
         if isinstance(node.value, str):
-            return f'"{node.value}"'
+            return f'PYRINAS_STR({self._c_string_literal(node.value)})'
         return str(node.value) if not isinstance(node.value, bool) else ('1' if node.value else '0')
 
+    def _c_string_literal(self, value):
+        """C literal for the UTF-8 bytes of value."""
+        escapes = {'\\': '\\\\', '"': '\\"', '\n': '\\n', '\t': '\\t', '\r': '\\r'}
+        body = ''.join(escapes.get(chr(b), chr(b)) if 32 <= b < 127 or chr(b) in escapes else f'\\{b:03o}'
+                       for b in value.encode('utf-8'))
+        return f'"{body}"'
+
     def visit_BinOp(self, node):
-        op_map = {ast.Add: '+', ast.Sub: '-', ast.Mult: '*', ast.Div: '/', ast.Mod: '%', ast.FloorDiv: '/'}
+        if getattr(node, 'pyr_type', None) == 'str':
+            return f'pyrinas_str_concat({self.visit(node.left)}, {self.visit(node.right)})'
+        if isinstance(node.op, (ast.FloorDiv, ast.Mod)):
+            # Rounded toward negative infinity, as in Python, where C's / and % truncate
+            helper = 'pyrinas_floordiv' if isinstance(node.op, ast.FloorDiv) else 'pyrinas_mod'
+            if getattr(node, 'pyr_type', None) == 'float':
+                helper += '_float'
+            return f'{helper}({self.visit(node.left)}, {self.visit(node.right)})'
+        op_map = {ast.Add: '+', ast.Sub: '-', ast.Mult: '*', ast.Div: '/'}
         return f'({self.visit(node.left)} {op_map[type(node.op)]} {self.visit(node.right)})'
 
     def visit_Compare(self, node):
         op_map = {ast.Eq: '==', ast.NotEq: '!=', ast.Lt: '<', ast.LtE: '<=', ast.Gt: '>', ast.GtE: '>='}
+        if getattr(node.left, 'pyr_type', None) == 'str':
+            left, right = self.visit(node.left), self.visit(node.comparators[0])
+            if isinstance(node.ops[0], (ast.Eq, ast.NotEq)):
+                negate = '!' if isinstance(node.ops[0], ast.NotEq) else ''
+                return f'{negate}pyrinas_str_eq({left}, {right})'
+            return f'(pyrinas_str_compare({left}, {right}) {op_map[type(node.ops[0])]} 0)'
         return f'({self.visit(node.left)} {op_map[type(node.ops[0])]} {self.visit(node.comparators[0])})'
 
     def visit_BoolOp(self, node):
@@ -445,7 +676,9 @@ class CCodeGenerator(ast.NodeVisitor):
             self.loop_labels.pop()
 
     def visit_For(self, node):
-        if isinstance(node.iter, ast.Call) and node.iter.func.id == 'range':
+        if isinstance(node.iter, ast.Call) and node.iter.func.id == 'prange':
+            self._parallel_loop(node)
+        elif isinstance(node.iter, ast.Call) and node.iter.func.id == 'range':
             limit = node.iter.args[0].value
             loop_var = node.target.id
             
@@ -454,6 +687,8 @@ class CCodeGenerator(ast.NodeVisitor):
                 self.current_code_list.append(f'{self._indent()}{label}:')
                 self.loop_labels.append(label)
 
+            if self.simd and getattr(node, 'vectorizable', False):
+                self.current_code_list.append(f'{self._indent()}#pragma GCC ivdep')
             self.current_code_list.append(f'{self._indent()}for (int {loop_var} = 0; {loop_var} < {limit}; {loop_var}++) {{')
             self.indent_level += 1
             for stmt in node.body:
@@ -480,61 +715,45 @@ class CCodeGenerator(ast.NodeVisitor):
             return self.visit(node.operand)
 
     def visit_Call(self, node):
+        # Calls evaluated by the compiler (@comptime)
+        value = getattr(node, 'comptime_value', None)
+        if value is not None and not isinstance(value, list):
+            return self._comptime_literal(value)
+
         # Check if this is a method call (obj.method()) or function call (func())
         if isinstance(node.func, ast.Attribute):
             # Method call
             return self._visit_method_call(node)
+        elif isinstance(node.func, ast.Subscript):
+            # Typed allocation: arena_alloc[T](arena[, count]) or pool_new[T]()
+            elem_type = node.func.slice.id if isinstance(node.func.slice, ast.Name) else node.func.slice.value
+            c_type = self._c_type_from_pyrinas_type(elem_type)
+            if node.func.value.id == 'pool_new':
+                return f'pyrinas_object_pool_new(sizeof({c_type}), _Alignof({c_type}))'
+            arena = self.visit(node.args[0])
+            if len(node.args) == 2:
+                count = self.visit(node.args[1])
+                return f'(({c_type}*)pyrinas_arena_alloc_array({arena}, {count}, sizeof({c_type}), _Alignof({c_type})))'
+            return f'(({c_type}*)pyrinas_arena_alloc({arena}, sizeof({c_type}), _Alignof({c_type})))'
         elif isinstance(node.func, ast.Name):
             # Function call
             if node.func.id == 'print':
-                arg = node.args[0]
-                expr_code = self.visit(arg)
-                
-                # Determine the type of the argument
-                arg_type = 'int'  # default
-                format_specifier = '%d'
-                
-                if isinstance(arg, ast.Name):
-                    # It's a variable, look it up in our local tracking
-                    if arg.id in self.local_vars:
-                        arg_type = self.local_vars[arg.id]
-                elif isinstance(arg, ast.Attribute):
-                    # It's a struct field access, e.g., p.x
-                    var_name = getattr(arg.value, 'id', None)
-                    if var_name in self.local_vars:
-                        struct_type_name = self.local_vars[var_name]
-                        struct_symbol = self.symbol_table.lookup(struct_type_name)
-                        if struct_symbol and struct_symbol.type == 'struct':
-                            field_name = arg.attr
-                            if field_name in struct_symbol.fields:
-                                arg_type = struct_symbol.fields[field_name]
-                elif isinstance(arg, ast.Constant):
-                    # It's a literal constant
-                    if isinstance(arg.value, str):
-                        arg_type = 'string'
-                    elif isinstance(arg.value, float):
-                        arg_type = 'float'
-                    elif isinstance(arg.value, bool):
-                        arg_type = 'bool'
-                    else:
-                        arg_type = 'int'
-                
-                # Set the appropriate format specifier
-                if arg_type == 'float':
-                    format_specifier = '%f'
-                elif arg_type == 'string':
-                    format_specifier = '%s'
-                elif arg_type == 'bool':
-                    format_specifier = '%d'  # booleans are printed as 0/1
-                elif arg_type.startswith('ptr['):
-                    format_specifier = '%p' # Pointers are printed as memory addresses
-                else:  # int
-                    format_specifier = '%d'
-                
-                self.current_code_list.append(f'{self._indent()}printf("{format_specifier}\\n", {expr_code});')
+                # Arguments are space-separated, as in Python
+                writes = []
+                for i, arg in enumerate(node.args):
+                    if i > 0:
+                        writes.append("pyrinas_write_char(' ');")
+                    writes.append(f'{self._write_routine(arg)}({self.visit(arg)});')
+                writes.append("pyrinas_write_char('\\n');")
+                self.current_code_list.append(f'{self._indent()}{" ".join(writes)}')
                 return ""
+            elif node.func.id == 'flush':
+                return 'pyrinas_flush()'
             elif node.func.id == 'addr':
                 return f'&{self.visit(node.args[0])}'
+            elif node.func.id == 'span':
+                # A span[] parameter is a pointer and a length
+                return f'{self.visit(node.args[0])}, {self.visit(node.args[1])}'
             elif node.func.id == 'deref':
                 return f'(*{self.visit(node.args[0])})'
             elif node.func.id == 'assign':
@@ -549,6 +768,29 @@ class CCodeGenerator(ast.NodeVisitor):
             elif node.func.id == 'malloc':
                 size = self.visit(node.args[0])
                 return f'malloc({size})'
+            elif node.func.id == 'len':
+                return f'(int)({self.visit(node.args[0])}).length'
+            elif node.func.id == 'str_free':
+                return f'pyrinas_str_free({self.visit(node.args[0])})'
+            elif node.func.id == 'str_builder_new':
+                capacity = self.visit(node.args[0]) if node.args else '0'
+                return f'pyrinas_str_builder_new({capacity})'
+            elif node.func.id == 'str_builder_append':
+                return f'pyrinas_str_builder_append({self.visit(node.args[0])}, {self.visit(node.args[1])})'
+            elif node.func.id == 'str_builder_finish':
+                return f'pyrinas_str_builder_finish({self.visit(node.args[0])})'
+            elif node.func.id == 'arena_new':
+                block_size = self.visit(node.args[0]) if node.args else '0'
+                return f'pyrinas_arena_new({block_size})'
+            elif node.func.id in ('arena_reset', 'arena_free'):
+                return f'pyrinas_{node.func.id}({self.visit(node.args[0])})'
+            elif node.func.id == 'pool_alloc':
+                elem_type = self._c_type_from_pyrinas_type(self._static_type_of(node.args[0])[5:-1])
+                return f'(({elem_type}*)pyrinas_object_pool_alloc({self.visit(node.args[0])}))'
+            elif node.func.id == 'pool_release':
+                return f'pyrinas_object_pool_release({self.visit(node.args[0])}, {self.visit(node.args[1])})'
+            elif node.func.id == 'pool_free':
+                return f'pyrinas_object_pool_free({self.visit(node.args[0])})'
             elif node.func.id == 'free':
                 ptr = self.visit(node.args[0])
                 self.current_code_list.append(f'{self._indent()}free({ptr});')
@@ -558,23 +800,52 @@ class CCodeGenerator(ast.NodeVisitor):
                 return self.visit(node.args[0])
             elif node.func.id in ('is_ok', 'is_err'):
                 arg_expr = self.visit(node.args[0])
-                return f'{node.func.id}({arg_expr})'
+                return f'{self._result_helper(node.args[0], node.func.id, node.func.id)}({arg_expr})'
             elif node.func.id.startswith('unwrap_or_'):
                 result_expr = self.visit(node.args[0])
                 default_expr = self.visit(node.args[1])
-                return f'{node.func.id}({result_expr}, {default_expr})'
+                return f'{self._result_helper(node.args[0], "unwrap_or", node.func.id)}({result_expr}, {default_expr})'
             elif node.func.id.startswith('unwrap_'):
                 arg_expr = self.visit(node.args[0])
-                return f'{node.func.id}({arg_expr})'
+                return f'{self._result_helper(node.args[0], "unwrap", node.func.id)}({arg_expr})'
             elif node.func.id.startswith('expect_'):
                 result_expr = self.visit(node.args[0])
                 message_expr = self.visit(node.args[1])
-                return f'{node.func.id}({result_expr}, {message_expr})'
+                return f'{self._result_helper(node.args[0], "expect", node.func.id)}({result_expr}, {message_expr})'
+            elif node.func.id == 'spawn':
+                func_name = node.args[0].id
+                self.spawned_functions.add(func_name)
+                self.uses_unit_statics = True
+                args = [f'.arg{i} = {self.visit(arg)}' for i, arg in enumerate(node.args[1:])]
+                if not args and self.symbol_table.lookup(func_name).return_type is None:
+                    return f'pyrinas_spawn({func_name}_task_entry, NULL, 0)'
+                return f'pyrinas_spawn({func_name}_task_entry, &(struct {func_name}_task){{ {", ".join(args) or "0"} }}, sizeof(struct {func_name}_task))'
+            elif node.func.id == 'join':
+                task_expr = self.visit(node.args[0])
+                result_type = (self._static_type_of(node.args[0]) or 'task[None]')[5:-1]
+                if result_type == 'None':
+                    return f'pyrinas_join({task_expr}, NULL, 0)'
+                self.joined_types.add(result_type)
+                self.uses_unit_statics = True
+                return f'{self._task_join_helper(result_type)}({task_expr})'
+            elif node.func.id == 'parallel_for':
+                count = self.visit(node.args[0])
+                func_name = node.args[1].id
+                if len(node.args) == 2:
+                    return f'pyrinas_parallel_for_each({count}, {self._c_name(func_name)})'
+                self.parallel_bodies.add(func_name)
+                self.uses_unit_statics = True
+                return f'pyrinas_parallel_for(0, {count}, 0, {func_name}_range, {self.visit(node.args[2])})'
             elif node.func.id in ('int', 'float', 'str', 'bool'):
                 # Type conversion functions
                 if len(node.args) != 1:
                     raise TypeError(f"{node.func.id}() expects exactly one argument.")
                 arg_expr = self.visit(node.args[0])
+                if node.func.id == 'str':
+                    arg_type = getattr(node.args[0], 'pyr_type', None)
+                    if arg_type == 'str':
+                        return arg_expr
+                    return f'pyrinas_str_from_{"float" if arg_type == "float" else "int"}({arg_expr})'
                 # Convert to C-style type casts
                 c_type = self._c_type_from_pyrinas_type(node.func.id)
                 return f'({c_type}){arg_expr}'
@@ -586,11 +857,55 @@ class CCodeGenerator(ast.NodeVisitor):
                     return f'{{0}}'  # C struct zero initializer
                 else:
                     # Regular function call
-                    args_str = ', '.join([self.visit(arg) for arg in node.args])
-                    return f'{node.func.id}({args_str})'
+                    param_types = getattr(struct_symbol, 'param_types', None) or []
+                    args = [self.visit(arg) for arg in node.args]
+                    args = [self._interface_value(arg, param_types[i], code) if i < len(param_types) else code
+                            for i, (arg, code) in enumerate(zip(node.args, args))]
+                    if getattr(struct_symbol, 'is_c_function', False):
+                        return self._c_function_call(node.func.id, struct_symbol, args, node.args)
+                    args_str = ', '.join(args)
+                    return f'{self._c_name(node.func.id)}({args_str})'
         else:
             raise NotImplementedError(f"Unsupported function call type: {type(node.func).__name__}")
 
+    def _c_function_call(self, name, func_symbol, args, arg_nodes):
+        """
+        Call to an @c_function. str crosses the boundary as a C string, an
+        array passed for a span[] as its elements and length, and a struct
+        passed for a ptr[] as its address; nothing is copied. A str that is
+        not NUL-terminated where it ends (an interior slice) is the one
+        exception: it is copied for the call and freed after it.
+        """
+        param_types = [c_parameter(param_type)[0] for param_type in func_symbol.param_types or []]
+        copies = []
+        for i, (arg_node, param_type) in enumerate(zip(arg_nodes, param_types)):
+            arg_type = getattr(arg_node, 'pyr_type', None) or self._static_type_of(arg_node)
+            if arg_type is None and isinstance(arg_node, ast.Name):
+                arg_type = getattr(self.symbol_table.lookup(arg_node.id), 'type', None)  # a global
+            arg_type = (arg_type or '').replace(' ', '')
+            if param_type == 'str' and isinstance(arg_node, ast.Constant):
+                args[i] = self._c_string_literal(arg_node.value)
+            elif param_type == 'str':
+                copies.append((f'_cstr_{self.c_call_counter}_{len(copies)}', args[i]))
+                args[i] = f'{copies[-1][0]}.data'
+            elif param_type.startswith('span[') and arg_type.startswith('array['):
+                args[i] = f'{args[i]}, {arg_type[:-1].rsplit(",", 1)[1]}'
+            elif param_type == f'ptr[{arg_type}]' and getattr(self.symbol_table.lookup(arg_type), 'type', None) == 'struct':
+                args[i] = f'&{args[i]}'
+        call = f'{name}({", ".join(args)})'
+        if func_symbol.return_type == 'str':
+            call = f'pyrinas_str_from_cstr({call})'
+        if not copies:
+            return call
+        result = f'_c_result_{self.c_call_counter}'
+        self.c_call_counter += 1
+        target = f'&{result}' if func_symbol.return_type == 'str' else 'NULL'
+        setup = ' '.join(f'PyrStr {copy} = pyrinas_str_terminated({code});' for copy, code in copies)
+        releases = ' '.join(f'pyrinas_str_release({copy}, {target});' for copy, _ in copies)
+        if func_symbol.return_type is None:
+            return f'({{ {setup} {call}; {releases} }})'
+        return f'({{ {setup} {self._c_return_type(func_symbol.return_type)} {result} = {call}; {releases} {result}; }})'
+
     def _visit_method_call(self, node):
         """Generate C code for method calls (obj.method()) and module function calls (module.function())"""
         obj_node = node.func.value
@@ -611,12 +926,28 @@ class CCodeGenerator(ast.NodeVisitor):
                 symbol = self.symbol_table.lookup(obj_name)
                 if symbol and symbol.type == 'module':
                     # This is a module function call - call the function directly
+                    func_symbol = symbol.exports.get(method_name)
+                    if getattr(func_symbol, 'is_c_function', False):
+                        return self._c_function_call(method_name, func_symbol, args, node.args)
                     args_str = ', '.join(args)
-                    return f'{method_name}({args_str})'
+                    return f'{getattr(func_symbol, "c_name", None) or method_name}({args_str})'
             
             # Check if this is a regular object
             if obj_name in self.local_vars:
                 obj_type = self.local_vars[obj_name]
+                type_symbol = self.symbol_table.lookup(obj_type)
+                if type_symbol and method_name in (type_symbol.methods or {}):
+                    param_types = type_symbol.methods[method_name][0]
+                    args = [self._interface_value(arg, param_types[i], code) if i < len(param_types) else code
+                            for i, (arg, code) in enumerate(zip(node.args, args))]
+                if type_symbol and type_symbol.type == 'interface':
+                    concrete_type = getattr(node, 'concrete_type', None)
+                    if concrete_type:
+                        # Devirtualized: the struct behind the interface is known
+                        args_str = ', '.join([f'(struct {concrete_type}*){obj_expr}.self'] + args)
+                        return f'{concrete_type}_{method_name}({args_str})'
+                    args_str = ', '.join([f'{obj_expr}.self'] + args)
+                    return f'{obj_expr}.vtable->{method_name}({args_str})'
                 # Generate method call like: Rectangle_draw(&rect, args...)
                 args_str = ', '.join([f'&{obj_expr}'] + args)
                 return f'{obj_type}_{method_name}({args_str})'
@@ -631,15 +962,12 @@ class CCodeGenerator(ast.NodeVisitor):
             is_ok = call.func.id == 'Ok'
             val = self.visit(call.args[0])
 
-            # This part is still simplified. We need to know the type of the value
-            # to pick the right field in the union.
-            # For now, we'll make a guess based on the AST node type.
-            val_type = 'int'
-            if isinstance(call.args[0], ast.Constant):
-                if isinstance(call.args[0].value, str):
-                    val_type = 'str'
-
-            if is_ok:
+            if self.current_result_type:
+                # Specialized Result: the payload is stored with its own type
+                struct_name = self._result_struct(self.current_result_type)
+                field = 'ok' if is_ok else 'err'
+                self.current_code_list.append(f'{self._indent()}return ({struct_name}){{ .value = {{ .{field} = {val} }}, .is_ok = {int(is_ok)} }};')
+            elif is_ok:
                 self.current_code_list.append(f'{self._indent()}return (Result){{ .type = OK, .value = {{ .int_val = {val} }} }};')
             else: # is_err
                 self.current_code_list.append(f'{self._indent()}return (Result){{ .type = ERR, .value = {{ .str_val = {val} }} }};')
@@ -660,10 +988,15 @@ class CCodeGenerator(ast.NodeVisitor):
             else:
                 raise TypeError(f"Invalid array type format: {type_str}")
         elif type_str.startswith('Result[') and type_str.endswith(']'):
-            # Result types map to the C Result struct
-            return 'Result'
+            # Each Result instantiation gets its own C struct
+            return self._result_struct(type_str)
+        elif type_str.startswith('task[') and type_str.endswith(']'):
+            return 'PyrinasTask*'
+        elif type_str.startswith('Pool[') and type_str.endswith(']'):
+            return 'PyrinasObjectPool*'
         else:
-            c_type = {'int': 'int', 'float': 'float', 'bool': 'int', 'str': 'char*', 'void': 'void'}.get(type_str)
+            c_type = {'int': 'int', 'float': 'float', 'bool': 'int', 'str': 'PyrStr', 'void': 'void',
+                      'Arena': 'PyrinasArena*', 'StrBuilder': 'PyrStrBuilder*'}.get(type_str)
             if c_type:
                 return c_type
             
@@ -678,6 +1011,313 @@ class CCodeGenerator(ast.NodeVisitor):
             # Assume it's a struct type if not found (backward compatibility)
             return f'struct {type_str}'
 
+    def _result_struct(self, type_str):
+        """
+        Returns the C struct for a Result instantiation, e.g. Result[int,str] ->
+        Result_int_str and Result[ptr[int],str] -> Result_ptr_int_str,
+        registering it so its definition is emitted.
+        """
+        success_type, error_type = result_type_args(type_str)
+        key = f'Result[{success_type},{error_type}]'
+        if key not in self.result_types:
+            self.result_types[key] = 'Result_' + re.sub(r'\W+', '_', f'{success_type}_{error_type}').strip('_')
+        return self.result_types[key]
+
+    def _static_type_of(self, node):
+        """Best-effort Pyrinas type of an expression, or None if unknown."""
+        if isinstance(node, ast.Name):
+            return self.local_vars.get(node.id)
+        elif isinstance(node, ast.Call) and isinstance(node.func, ast.Name):
+            func_symbol = self.symbol_table.lookup(node.func.id)
+            return getattr(func_symbol, 'return_type', None)
+        elif isinstance(node, ast.Attribute) and isinstance(node.value, ast.Name):
+            struct_symbol = self.symbol_table.lookup(self.local_vars.get(node.value.id, ''))
+            if struct_symbol and struct_symbol.type == 'struct':
+                return struct_symbol.fields.get(node.attr)
+        return None
+
+    def _comptime_literal(self, value):
+        """C literal for a value computed by the compile-time interpreter."""
+        if isinstance(value, bool):
+            return '1' if value else '0'
+        if isinstance(value, int):
+            # -2147483648 is not an int literal in C
+            return '(-2147483647 - 1)' if value == -2**31 else (f'({value})' if value < 0 else str(value))
+        if not math.isfinite(value):
+            raise TypeError(f"Compile-time result {value} has no C literal.")
+        # Shortest decimal that reads back as the same float
+        for digits in range(6, 10):
+            literal = f'{value:.{digits}g}'
+            if to_f32(float(literal)) == value:
+                break
+        if not any(c in literal for c in '.e'):
+            literal += '.0'
+        return f'({literal}f)' if value < 0 else f'{literal}f'
+
+
+    def _array_alignment(self, base_type, size):
+        """
+        Aligns numeric arrays large enough to fill a vector register: 32 bytes
+        suits AVX2, and arrays of a cache line or more get 64.
+        """
+        if base_type not in ('int', 'float'):
+            return ''
+        nbytes = 4 * size
+        if nbytes >= 64:
+            return '_Alignas(64) '
+        if nbytes >= 32:
+            return '_Alignas(32) '
+        return ''
+
+    def _write_routine(self, arg):
+        """Runtime output routine for a print argument."""
+        arg_type = getattr(arg, 'pyr_type', None)
+        if arg_type is None:
+            # Method bodies are not analyzed; fall back to what is known locally
+            if isinstance(arg, ast.Constant):
+                arg_type = {bool: 'bool', float: 'float', str: 'str'}.get(type(arg.value), 'int')
+            else:
+                arg_type = self._static_type_of(arg) or 'int'
+        if arg_type == 'float':
+            return 'pyrinas_write_float'
+        elif arg_type == 'str':
+            return 'pyrinas_write_str'
+        elif isinstance(arg_type, str) and arg_type.startswith('ptr['):
+            return 'pyrinas_write_ptr'
+        return 'pyrinas_write_int'  # int, bool (0/1) and enums
+
+    def _result_type_of(self, node, context):
+        """
+        Result type of an expression, as semantic analysis recorded it.
+        Method bodies are not analyzed, so there the type is taken from what
+        is known locally.
+        """
+        type_str = getattr(node, 'pyr_type', None) or self._static_type_of(node)
+        if not (isinstance(type_str, str) and type_str.startswith('Result[')):
+            raise TypeError(f"{context} needs a Result value, but the type of '{ast.unparse(node)}' "
+                            f"is {type_str or 'unknown'}.")
+        return type_str
+
+    def _result_helper(self, result_node, operation, name):
+        """Helper of the argument's Result instantiation, such as Result_int_str_unwrap."""
+        result_type = self._result_type_of(result_node, f'{name}()')
+        return f'{self._result_struct(result_type)}_{operation}'
+
+    def _task_join_helper(self, result_type):
+        return 'pyrinas_join_' + re.sub(r'\W+', '_', result_type).strip('_')
+
+    def _parallel_loop(self, node):
+        """
+        A prange loop runs on the task scheduler, like spawn() and
+        parallel_for(): its body becomes a chunk function that
+        pyrinas_parallel_for calls on disjoint ranges of iterations. The
+        locals the body reads are copied into the loop's context block,
+        arrays as pointers to their elements; semantic analysis has checked
+        that the body writes no others. A reduction is accumulated in a local
+        of the chunk and merged into the slot of the worker running it when
+        the chunk ends, and the slots are combined after the loop. min and
+        max start from the variable's value, which cannot change their result.
+        """
+        index = len(self.parallel_loops)
+        self.parallel_loops.append(None)  # Keeps this loop's place ahead of loops nested in it
+        name = f'{self.current_function}_prange_{index}'
+        loop_var = node.target.id
+        limit = self.visit(node.iter.args[0])
+        reductions = [(var, op, self._c_type_from_pyrinas_type(self.local_vars[var]))
+                      for var, op in parallel_reductions(node.iter)]
+        body = ast.Module(body=node.body, type_ignores=[])
+        private = {loop_var} | {var for var, _, _ in reductions} | {
+            stmt.target.id for stmt in ast.walk(body) if isinstance(stmt, ast.AnnAssign) and isinstance(stmt.target, ast.Name)}
+        captures = []
+        for child in ast.walk(body):
+            if (isinstance(child, ast.Name) and child.id not in private and child.id not in captures
+                    and child.id in self.local_vars and not self.symbol_table.lookup(child.id)):
+                captures.append(child.id)
+
+        fields, setup, values = [], [], []
+        for var in captures:
+            array = re.fullmatch(r'array\[(\w+),\s*\d+\]', self.local_vars[var])
+            if array:
+                const = 'const ' if var in self.const_arrays else ''
+                c_type = f'{const}{self._c_type_from_pyrinas_type(array.group(1))}*'
+            else:
+                c_type = self._c_type_from_pyrinas_type(self.local_vars[var])
+            fields.append(f'    {c_type} {var};')
+            setup.append(f'    {c_type} {var} = pyrinas_loop->{var};')
+            values.append(f'.{var} = {var}')
+        for var, op, c_type in reductions:
+            if op == '+':
+                setup.append(f'    {c_type} {var} = 0;')
+            else:
+                fields.append(f'    {c_type} {var};')
+                setup.append(f'    {c_type} {var} = pyrinas_loop->{var};')
+                values.append(f'.{var} = {var}')
+        if reductions:
+            fields.append(f'    struct {name}_partial* partials;')
+            values.append(f'.partials = {name}_partials')
+
+        declarations = []
+        if reductions:
+            declarations.append(f'struct {name}_partial {{')
+            declarations.extend(f'    {c_type} {var};' for var, _, c_type in reductions)
+            declarations.append('};')
+        if fields:
+            declarations.append(f'struct {name} {{')
+            declarations.extend(fields)
+            declarations.append('};')
+        declarations.append(f'static void {name}_range(int pyrinas_begin, int pyrinas_end, void* pyrinas_data);')
+        declarations.append('')
+
+        definition = [f'static void {name}_range(int pyrinas_begin, int pyrinas_end, void* pyrinas_data) {{']
+        definition.append(f'    struct {name}* pyrinas_loop = pyrinas_data;' if fields else '    (void)pyrinas_data;')
+        definition.extend(setup)
+        definition.append(f'    for (int {loop_var} = pyrinas_begin; {loop_var} < pyrinas_end; {loop_var}++) {{')
+        old_code_list, old_indent = self.current_code_list, self.indent_level
+        self.current_code_list, self.indent_level = definition, 2
+        self.local_vars[loop_var] = 'int'  # Loops nested in the body capture it
+        for stmt in node.body:
+            self.visit(stmt)
+        self.current_code_list, self.indent_level = old_code_list, old_indent
+        definition.append('    }')
+        if reductions:
+            definition.append(f'    struct {name}_partial* pyrinas_partial = &pyrinas_loop->partials[pyrinas_worker_index()];')
+        for var, op, _ in reductions:
+            if op == '+':
+                definition.append(f'    pyrinas_partial->{var} += {var};')
+            else:
+                definition.append(f'    if ({var} {">" if op == "max" else "<"} pyrinas_partial->{var}) pyrinas_partial->{var} = {var};')
+        definition.append('}')
+        definition.append('')
+        self.parallel_loops[index] = (declarations, definition)
+        self.uses_unit_statics = True
+
+        context = f'&(struct {name}){{ {", ".join(values)} }}' if fields else 'NULL'
+        call = f'pyrinas_parallel_for(0, {limit}, 0, {name}_range, {context});'
+        if not reductions:
+            self.current_code_list.append(f'{self._indent()}{call}')
+            return
+        indent = self._indent()
+        starts = ', '.join('0' if op == '+' else var for var, op, _ in reductions)
+        self.current_code_list.append(f'{indent}{{')
+        self.current_code_list.append(f'{indent}    int {name}_workers = pyrinas_pool_size() + 1;')
+        self.current_code_list.append(f'{indent}    struct {name}_partial {name}_partials[{name}_workers];')
+        self.current_code_list.append(f'{indent}    for (int pyrinas_worker = 0; pyrinas_worker < {name}_workers; pyrinas_worker++) {name}_partials[pyrinas_worker] = (struct {name}_partial){{ {starts} }};')
+        self.current_code_list.append(f'{indent}    {call}')
+        self.current_code_list.append(f'{indent}    for (int pyrinas_worker = 0; pyrinas_worker < {name}_workers; pyrinas_worker++) {{')
+        for var, op, _ in reductions:
+            slot = f'{name}_partials[pyrinas_worker].{var}'
+            if op == '+':
+                self.current_code_list.append(f'{indent}        {var} += {slot};')
+            else:
+                self.current_code_list.append(f'{indent}        if ({slot} {">" if op == "max" else "<"} {var}) {var} = {slot};')
+        self.current_code_list.append(f'{indent}    }}')
+        self.current_code_list.append(f'{indent}}}')
+
+    def _task_declarations(self):
+        """
+        Argument blocks and entry points for spawned functions, and typed join
+        helpers. A task's result is the first member of its block, which is
+        all join copies back.
+        """
+        declarations = []
+        for func_name in sorted(self.spawned_functions):
+            func_symbol = self.symbol_table.lookup(func_name)
+            members = []
+            if func_symbol.return_type is not None:
+                members.append(f'    {self._c_type_from_pyrinas_type(func_symbol.return_type)} result;')
+            for i, param_type in enumerate(func_symbol.param_types):
+                members.append(f'    {self._c_type_from_pyrinas_type(param_type)} arg{i};')
+            if members:
+                declarations.append(f'struct {func_name}_task {{')
+                declarations.extend(members)
+                declarations.append('};')
+            declarations.append(f'static void {func_name}_task_entry(void* data);')
+            declarations.append('')
+        for func_name in sorted(self.parallel_bodies):
+            declarations.append(f'static void {func_name}_range(int begin, int end, void* data);')
+            declarations.append('')
+        for loop_declarations, _ in self.parallel_loops:
+            declarations.extend(loop_declarations)
+        for result_type in sorted(self.joined_types):
+            c_type = self._c_type_from_pyrinas_type(result_type)
+            declarations.append(f'static inline {c_type} {self._task_join_helper(result_type)}(PyrinasTask* task) {{')
+            declarations.append(f'    {c_type} result;')
+            declarations.append('    pyrinas_join(task, &result, sizeof(result));')
+            declarations.append('    return result;')
+            declarations.append('}')
+            declarations.append('')
+        return declarations
+
+    def _task_definitions(self):
+        """Task entry points, parallel_for adapters and prange chunks; they follow the functions they call."""
+        definitions = []
+        for func_name in sorted(self.spawned_functions):
+            func_symbol = self.symbol_table.lookup(func_name)
+            call = f'{self._c_name(func_name)}({", ".join(f"task->arg{i}" for i in range(len(func_symbol.param_types)))})'
+            definitions.append(f'static void {func_name}_task_entry(void* data) {{')
+            if func_symbol.return_type is None and not func_symbol.param_types:
+                definitions.append('    (void)data;')
+                definitions.append(f'    {call};')
+            else:
+                definitions.append(f'    struct {func_name}_task* task = data;')
+                definitions.append(f'    {"task->result = " if func_symbol.return_type is not None else ""}{call};')
+            definitions.append('}')
+            definitions.append('')
+        for func_name in sorted(self.parallel_bodies):
+            data_type = self._c_type_from_pyrinas_type(self.symbol_table.lookup(func_name).param_types[1])
+            definitions.append(f'static void {func_name}_range(int begin, int end, void* data) {{')
+            definitions.append(f'    for (int i = begin; i < end; i++) {self._c_name(func_name)}(i, ({data_type})data);')
+            definitions.append('}')
+            definitions.append('')
+        for _, loop_definition in self.parallel_loops:
+            definitions.extend(loop_definition)
+        return definitions
+
+    def _result_definitions(self):
+        """
+        C definitions for every Result instantiation used. The tag follows the
+        payload so it packs into the payload's trailing padding, and payloads
+        are stored by value, so e.g. Result[int,int] is 8 bytes and returns in
+        a register. Guards let imported modules share instantiations.
+        """
+        definitions = []
+        unwrap_message = '"attempted to unwrap an Err result"'
+        for type_str, name in self.result_types.items():
+            success_type, error_type = result_type_args(type_str)
+            ok_c = self._c_type_from_pyrinas_type(success_type)
+            err_c = self._c_type_from_pyrinas_type(error_type)
+            definitions.extend([
+                f'#ifndef PYRINAS_DEFINED_{name}',
+                f'#define PYRINAS_DEFINED_{name}',
+                'typedef struct {',
+                '    union {',
+                f'        {ok_c} ok;',
+                f'        {err_c} err;',
+                '    } value;',
+                '    bool is_ok;',
+                f'}} {name};',
+                '',
+                f'static inline bool {name}_is_ok({name} r) {{ return r.is_ok; }}',
+                f'static inline bool {name}_is_err({name} r) {{ return !r.is_ok; }}',
+                '',
+                f'static inline {ok_c} {name}_unwrap({name} r) {{',
+                f'    if (PYRINAS_UNLIKELY(!r.is_ok)) pyrinas_panic({unwrap_message});',
+                '    return r.value.ok;',
+                '}',
+                '',
+                f'static inline {ok_c} {name}_unwrap_or({name} r, {ok_c} default_val) {{',
+                '    return PYRINAS_LIKELY(r.is_ok) ? r.value.ok : default_val;',
+                '}',
+                '',
+                f'static inline {ok_c} {name}_expect({name} r, PyrStr message) {{',
+                '    if (PYRINAS_UNLIKELY(!r.is_ok)) pyrinas_panic_str(message);',
+                '    return r.value.ok;',
+                '}',
+                '#endif',
+                '',
+            ])
+        return definitions
+
     def _get_preceding_label(self, loop_node):
         # This is a bit of a hack. We need to find the label
         # that immediately precedes the loop in the AST.
@@ -706,9 +1346,15 @@ class CCodeGenerator(ast.NodeVisitor):
         if self.semantic_analyzer and hasattr(self.semantic_analyzer, 'imported_modules'):
             all_c_includes = set()
             for import_path, module_analyzer in self.semantic_analyzer.imported_modules.items():
-                # Generate code for the imported module
-                module_generator = CCodeGenerator(module_analyzer.symbol_table, module_analyzer)
-                module_code = module_generator.generate_module_code(module_analyzer)
+                if getattr(module_analyzer, 'object_file', None):
+                    # Compiled separately; only its header is needed here
+                    c_code.append(f'#include "{module_analyzer.header_file}"')
+                    continue
+                else:
+                    # Generate code for the imported module
+                    module_generator = CCodeGenerator(module_analyzer.symbol_table, module_analyzer, profile=self.profile,
+                                                      line_directives=self.line_directives)
+                    module_code = module_generator.generate_module_code(module_analyzer)
                 
                 # Collect C includes from the module
                 if hasattr(module_analyzer, 'c_includes'):
@@ -734,29 +1380,58 @@ class CCodeGenerator(ast.NodeVisitor):
             c_code.extend(self.struct_definitions)
             c_code.append('')
         
+        # Add Result instantiations (after structs, which they may contain)
+        c_code.extend(self._result_definitions())
+        c_code.extend(self._task_declarations())
+        
         # Add function definitions
         if self.function_definitions:
             c_code.extend(self.function_definitions)
             c_code.append('')
+        c_code.extend(self._task_definitions())
         
         # Add main code
         c_code.extend(self.main_code)
         
         return '\n'.join(c_code)
 
+    def generate_module_unit(self, module_analyzer):
+        """
+        A module as its own header and translation unit. The header holds its
+        struct layouts, declarations and inline functions, after the headers
+        of the modules it imports; the source holds its other definitions.
+        """
+        self.module_unit = True
+        self.generate_module_code(module_analyzer)
+        guard = f'PYRINAS_MODULE_{module_analyzer.module_prefix.upper()}H'
+        header = [f'#ifndef {guard}', f'#define {guard}', '', '#include "pyrinas.h"']
+        header.extend(f'#include <{name}>' for name in sorted(module_analyzer.c_includes))
+        header.extend(f'#include "{imported.header_file}"' for imported in module_analyzer.imported_modules.values())
+        header.append('')
+        header.extend(self.module_interface)
+        header.extend(['', f'#endif // {guard}', ''])
+        
+        source = [f'#include "{os.path.basename(module_analyzer.header_file)}"', '']
+        source.extend(self.module_definitions)
+        return '\n'.join(header), '\n'.join(source)
+
     def generate_module_code(self, module_analyzer):
-        """Generate C code for an imported module (functions and constants only)."""
-        module_code = []
+        """
+        Generate C code for an imported module: its structs, constants and
+        functions, but not main. The declarations other files need are kept
+        in module_interface and the rest in module_definitions.
+        """
+        self.module_interface = []
+        self.module_definitions = []
         constants = []
+        declarations = []
         functions = []
         
         # Get the module's AST to generate code from
         if hasattr(module_analyzer, 'current_file'):
             try:
-                with open(module_analyzer.current_file, 'r') as f:
-                    code = f.read()
-                from pyrinas.parser import get_ast
-                tree = get_ast(code)
+                # The analyzed tree carries the types codegen reads, such as pyr_type
+                tree = module_analyzer.tree
                 
                 # First, generate constant definitions
                 for item in tree.body:
@@ -766,14 +1441,16 @@ class CCodeGenerator(ast.NodeVisitor):
                         const_symbol = module_analyzer.symbol_table.lookup(const_name)
                         if const_symbol:
                             c_type = self._c_type_from_pyrinas_type(const_symbol.type)
+                            c_name = self._c_name(const_name)
                             if isinstance(item.value, ast.Constant):
                                 const_value = item.value.value
                                 if isinstance(const_value, str):
-                                    constants.append(f'const {c_type} {const_name} = "{const_value}";')
+                                    constants.append(f'const {c_type} {c_name} = "{const_value}";')
                                 else:
-                                    constants.append(f'const {c_type} {const_name} = {const_value};')
+                                    constants.append(f'const {c_type} {c_name} = {const_value};')
+                                declarations.append(f'extern const {c_type} {c_name};')
                 
-                # Then, generate function definitions from the module
+                # Then, generate struct and function definitions from the module
                 for item in tree.body:
                     if isinstance(item, ast.FunctionDef):
                         # Skip import helper functions
@@ -788,20 +1465,64 @@ class CCodeGenerator(ast.NodeVisitor):
                         func_symbol = module_analyzer.symbol_table.lookup(item.name)
                         if func_symbol and hasattr(func_symbol, 'is_c_function') and func_symbol.is_c_function:
                             continue  # Skip external C functions
-                        
-                        old_function_definitions = self.function_definitions
-                        self.function_definitions = []
-                        self.visit(item)
-                        functions.extend(self.function_definitions)
-                        self.function_definitions = old_function_definitions
+                    elif not isinstance(item, ast.ClassDef):
+                        continue
+                    
+                    old_function_definitions = self.function_definitions
+                    self.function_definitions = []
+                    inline_start = len(self.inline_definitions)
+                    self.visit(item)
+                    # Prototypes for every externally visible function defined
+                    declarations.extend(line[:-len(' {')] + ';' for line in self.function_definitions
+                                        if line.endswith(') {') and not line.startswith((' ', 'static')))
+                    declarations.extend(line[:-len(' {')] + ';' for line in self.inline_definitions[inline_start:]
+                                        if line.endswith(') {') and line.startswith('static inline '))
+                    functions.extend(self.function_definitions)
+                    self.function_definitions = old_function_definitions
                 
-                # Combine constants first, then functions
-                module_code.extend(constants)
-                module_code.extend(functions)
+                # Structs first, then the Result instantiations that may contain them
+                self.module_interface.extend(self.struct_definitions)
+                self.module_interface.extend(self._result_definitions())
+                self.module_interface.extend(declarations)
+                if self.inline_definitions:
+                    self.module_interface.append('')
+                    self.module_interface.extend(self.inline_definitions)
+                self.module_definitions.extend(constants)
+                self.module_definitions.extend(self._task_declarations())
+                self.module_definitions.extend(functions)
+                self.module_definitions.extend(self._task_definitions())
                 
             except Exception as e:
                 # If we can't generate module code, just return empty
                 print(f"Warning: Could not generate code for module {module_analyzer.current_file}: {e}")
                 return []
         
-        return module_code
\ No newline at end of file
+        return self.module_interface + self.module_definitions
+
+
+LINE_DIRECTIVE = re.compile(r'#line (\d+) "((?:[^"\\]|\\.)*)"$')
+
+def line_map(c_code, c_file):
+    """
+    Map from lines of generated C to source lines, built from its #line
+    directives: one [c_line, source, line] entry for the C line after each
+    directive, where source indexes sources. C lines without an entry belong
+    to the entry before them.
+    """
+    sources = []
+    mappings = []
+    for c_line, text in enumerate(c_code.split('\n'), start=1):
+        match = LINE_DIRECTIVE.match(text)
+        if match:
+            source = match.group(2).encode('latin-1').decode('unicode_escape').encode('latin-1').decode('utf-8')
+            if source not in sources:
+                sources.append(source)
+            mappings.append([c_line + 1, sources.index(source), int(match.group(1))])
+    return {'version': 1, 'file': c_file, 'sources': sources, 'mappings': mappings}
+
+
+def write_line_map(c_code, c_file):
+    """Writes line_map(c_code, c_file) next to the C file, as <c_file>.map."""
+    with open(f'{c_file}.map', 'w', encoding='utf-8') as f:
+        json.dump(line_map(c_code, c_file), f)
+        f.write('\n')
@@ -0,0 +1,363 @@
+"""
+Compile-time evaluation of @comptime functions.
+
+Bodies are interpreted over the AST with the arithmetic of the generated C:
+32-bit ints with truncating division, float values rounded to single
+precision and float literals and libm results kept in double precision
+until they are stored, as C's usual arithmetic conversions do.
+"""
+
+import ast
+import math
+import struct
+
+INT_MIN = -2**31
+INT_MAX = 2**31 - 1
+
+# Evaluation stops with an error after this many statements
+STEP_LIMIT = 10_000_000
+
+# @c_function declarations the interpreter can evaluate itself
+LIBM_FUNCTIONS = {
+    'sqrt': math.sqrt, 'sin': math.sin, 'cos': math.cos, 'tan': math.tan,
+    'exp': math.exp, 'log': math.log, 'pow': math.pow, 'fabs': math.fabs,
+    'floor': math.floor, 'ceil': math.ceil, 'atan2': math.atan2,
+}
+
+SCALAR_TYPES = ('int', 'float', 'bool')
+
+
+class F32(float):
+    """A value of C type float."""
+
+
+class ComptimeError(TypeError):
+    pass
+
+
+class _Break(Exception):
+    def __init__(self, label):
+        self.label = label
+
+
+class _Continue(Exception):
+    def __init__(self, label):
+        self.label = label
+
+
+class _Return(Exception):
+    def __init__(self, value):
+        self.value = value
+
+
+def to_f32(value):
+    try:
+        return F32(struct.unpack('f', struct.pack('f', value))[0])
+    except OverflowError:
+        raise ComptimeError("float overflow in compile-time evaluation")
+
+
+def array_type(type_name):
+    """(element type, size) of 'array[T,N]', or None."""
+    if type_name and type_name.startswith('array[') and type_name.endswith(']'):
+        element, _, size = type_name[6:-1].partition(',')
+        if size.strip().isdigit():
+            return element.strip(), int(size)
+    return None
+
+
+def convert(value, type_name):
+    """Applies C's conversion on assignment to a variable of type_name."""
+    if type_name == 'float':
+        return to_f32(value)
+    if type_name == 'int':
+        if isinstance(value, float):
+            if not math.isfinite(value) or not INT_MIN <= int(value) <= INT_MAX:
+                raise ComptimeError(f"{value} does not fit in int")
+            return int(value)
+        return int(value)
+    if type_name == 'bool':
+        return bool(value)
+    return value
+
+
+def preceding_label(node):
+    """Label of a loop, break or continue: a string statement just before it."""
+    parent = getattr(node, 'parent', None)
+    body = getattr(parent, 'body', None)
+    if body and node in body:
+        index = body.index(node)
+        if index > 0 and isinstance(body[index - 1], ast.Expr) and isinstance(body[index - 1].value, ast.Constant) \
+                and isinstance(body[index - 1].value.value, str):
+            return body[index - 1].value.value
+    return None
+
+
+class Interpreter:
+    def __init__(self, functions, signatures):
+        self.functions = functions    # name -> FunctionDef of each @comptime function
+        self.signatures = signatures  # name -> (param_types, return_type)
+        self.steps = 0
+
+    def call(self, name, args):
+        func = self.functions[name]
+        param_types, return_type = self.signatures[name]
+        frame = {}
+        for arg, param, type_name in zip(args, func.args.args, param_types):
+            frame[param.arg] = (convert(arg, type_name), type_name)
+        try:
+            self.execute(func.body, frame)
+        except _Return as result:
+            if return_type is None:
+                return None
+            if array_type(return_type):
+                return list(result.value)
+            return convert(result.value, return_type)
+        except RecursionError:
+            raise ComptimeError(f"'{name}' recurses too deeply for compile-time evaluation")
+        if return_type is not None:
+            raise ComptimeError(f"'{name}' reached the end of its body without returning a value")
+        return None
+
+    def execute(self, statements, frame):
+        for stmt in statements:
+            self.steps += 1
+            if self.steps > STEP_LIMIT:
+                raise ComptimeError(f"compile-time evaluation did not finish within {STEP_LIMIT} steps")
+            getattr(self, f'exec_{type(stmt).__name__}')(stmt, frame)
+
+    def exec_Expr(self, stmt, frame):
+        # Docstrings and loop labels
+        pass
+
+    def exec_Pass(self, stmt, frame):
+        pass
+
+    def exec_AnnAssign(self, stmt, frame):
+        type_name = stmt.annotation.value if isinstance(stmt.annotation, ast.Constant) else ast.unparse(stmt.annotation)
+        if type_name.startswith('Final['):
+            type_name = type_name[6:-1].strip('\'"')
+        type_name = type_name.replace(' ', '')
+        shape = array_type(type_name)
+        if shape:
+            element, size = shape
+            array = list(self.eval(stmt.value, frame)) if stmt.value else [convert(0, element)] * size
+            frame[stmt.target.id] = (array, type_name)
+        else:
+            value = self.eval(stmt.value, frame) if stmt.value else 0
+            frame[stmt.target.id] = (convert(value, type_name), type_name)
+
+    def exec_Assign(self, stmt, frame):
+        value = self.eval(stmt.value, frame)
+        target = stmt.targets[0]
+        if isinstance(target, ast.Subscript):
+            array, type_name = frame[target.value.id]
+            index = self.index(target, array, frame)
+            array[index] = convert(value, array_type(type_name)[0])
+        else:
+            # Undeclared names take the type of their first value
+            type_name = frame[target.id][1] if target.id in frame else ('float' if isinstance(value, float) else 'int')
+            frame[target.id] = (convert(value, type_name), type_name)
+
+    def exec_If(self, stmt, frame):
+        self.execute(stmt.body if self.eval(stmt.test, frame) else stmt.orelse, frame)
+
+    def _loop_body(self, stmt, frame, label):
+        """Runs one iteration; returns False when the loop breaks."""
+        try:
+            self.execute(stmt.body, frame)
+        except _Break as signal:
+            if signal.label not in (None, label):
+                raise
+            return False
+        except _Continue as signal:
+            if signal.label not in (None, label):
+                raise
+        return True
+
+    def exec_While(self, stmt, frame):
+        label = preceding_label(stmt)
+        while self.eval(stmt.test, frame):
+            self.steps += 1
+            if not self._loop_body(stmt, frame, label):
+                break
+
+    def exec_For(self, stmt, frame):
+        label = preceding_label(stmt)
+        limit = self.eval(stmt.iter.args[0], frame)
+        for i in range(limit):
+            frame[stmt.target.id] = (i, 'int')
+            if not self._loop_body(stmt, frame, label):
+                break
+
+    def exec_Break(self, stmt, frame):
+        raise _Break(preceding_label(stmt))
+
+    def exec_Continue(self, stmt, frame):
+        raise _Continue(preceding_label(stmt))
+
+    def exec_Return(self, stmt, frame):
+        raise _Return(self.eval(stmt.value, frame) if stmt.value else None)
+
+    def index(self, node, array, frame):
+        index = self.eval(node.slice, frame)
+        if not 0 <= index < len(array):
+            raise ComptimeError(f"index {index} out of bounds for array of size {len(array)}")
+        return index
+
+    def eval(self, node, frame):
+        return getattr(self, f'eval_{type(node).__name__}')(node, frame)
+
+    def eval_Constant(self, node, frame):
+        return node.value  # float literals are doubles in C
+
+    def eval_Name(self, node, frame):
+        return frame[node.id][0]
+
+    def eval_Subscript(self, node, frame):
+        array = frame[node.value.id][0]
+        return array[self.index(node, array, frame)]
+
+    def eval_UnaryOp(self, node, frame):
+        operand = self.eval(node.operand, frame)
+        if isinstance(node.op, ast.Not):
+            return not operand
+        if isinstance(node.op, ast.USub):
+            return self.arithmetic(0, operand, ast.Sub()) if not isinstance(operand, float) else type(operand)(-operand)
+        return operand
+
+    def eval_BoolOp(self, node, frame):
+        if isinstance(node.op, ast.And):
+            return all(self.eval(value, frame) for value in node.values)
+        return any(self.eval(value, frame) for value in node.values)
+
+    def eval_Compare(self, node, frame):
+        left, right = self.promote(self.eval(node.left, frame), self.eval(node.comparators[0], frame))
+        return {ast.Eq: left == right, ast.NotEq: left != right, ast.Lt: left < right,
+                ast.LtE: left <= right, ast.Gt: left > right, ast.GtE: left >= right}[type(node.ops[0])]
+
+    def eval_BinOp(self, node, frame):
+        return self.arithmetic(self.eval(node.left, frame), self.eval(node.right, frame), node.op)
+
+    def promote(self, left, right):
+        """Usual arithmetic conversions: int meets float as float, float meets double as double."""
+        if type(left) is float or type(right) is float:
+            return float(left), float(right)
+        if isinstance(left, F32) or isinstance(right, F32):
+            return to_f32(left), to_f32(right)
+        return left, right
+
+    def arithmetic(self, left, right, op):
+        left, right = self.promote(left, right)
+        if isinstance(left, float):
+            single = isinstance(left, F32)
+            if isinstance(op, (ast.Div, ast.FloorDiv, ast.Mod)):
+                if right == 0:
+                    raise ComptimeError("float division by zero in compile-time evaluation")
+                result = {ast.Div: left / right, ast.FloorDiv: left // right, ast.Mod: left % right}[type(op)]
+            else:
+                result = {ast.Add: left + right, ast.Sub: left - right, ast.Mult: left * right}[type(op)]
+            return to_f32(result) if single else result
+
+        left, right = int(left), int(right)
+        if isinstance(op, (ast.Div, ast.FloorDiv, ast.Mod)):
+            if right == 0:
+                raise ComptimeError("integer division by zero in compile-time evaluation")
+            if isinstance(op, ast.Div):
+                # int / int is emitted as C integer division, which truncates
+                result = abs(left) // abs(right) * (1 if (left < 0) == (right < 0) else -1)
+            else:
+                result = left // right if isinstance(op, ast.FloorDiv) else left % right
+        else:
+            result = {ast.Add: left + right, ast.Sub: left - right, ast.Mult: left * right}[type(op)]
+        if not INT_MIN <= result <= INT_MAX:
+            raise ComptimeError(f"integer overflow in compile-time evaluation ({result})")
+        return result
+
+    def eval_Call(self, node, frame):
+        name = node.func.id
+        args = [self.eval(arg, frame) for arg in node.args]
+        if name == 'int':
+            return convert(args[0], 'int')
+        if name == 'float':
+            return to_f32(args[0])
+        if name in self.functions:
+            return self.call(name, args)
+        try:
+            # libm works in double precision
+            return float(LIBM_FUNCTIONS[name](*(float(arg) for arg in args)))
+        except (ValueError, OverflowError):
+            raise ComptimeError(f"{name}() domain error in compile-time evaluation")
+
+
+def check_function(func, param_types, return_type, symbol_table, comptime_names):
+    """
+    Rejects @comptime functions the interpreter cannot evaluate: parameters
+    must be scalars, locals and the result scalars or arrays of scalars, and
+    calls may only go to other @comptime functions, int(), float() or a libm
+    @c_function.
+    """
+    name = func.name
+
+    def is_value_type(type_name):
+        shape = array_type(type_name)
+        return type_name in SCALAR_TYPES or (shape is not None and shape[0] in SCALAR_TYPES)
+
+    for param, type_name in zip(func.args.args, param_types):
+        if type_name not in SCALAR_TYPES:
+            raise TypeError(f"@comptime function '{name}' parameter '{param.arg}' must be int, float or bool.")
+    if not is_value_type(return_type):
+        raise TypeError(f"@comptime function '{name}' must return a scalar or an array of scalars.")
+
+    # Annotations are types, not evaluated code
+    skipped = set()
+    for stmt in ast.walk(func):
+        if isinstance(stmt, ast.AnnAssign):
+            skipped.update(id(n) for n in ast.walk(stmt.annotation))
+
+    for stmt in func.body:
+        for node in ast.walk(stmt):
+            if id(node) in skipped or isinstance(node, (ast.expr_context, ast.operator, ast.unaryop,
+                                                          ast.boolop, ast.cmpop, ast.Pass)):
+                continue
+            if isinstance(node, ast.AnnAssign):
+                type_name = ast.unparse(node.annotation).strip('\'"').replace(' ', '')
+                if type_name.startswith('Final['):
+                    type_name = type_name[6:-1].strip('\'"')
+                if not is_value_type(type_name):
+                    raise TypeError(f"@comptime function '{name}' declares '{node.target.id}' of type "
+                                    f"{type_name}; only scalars and arrays of scalars are supported.")
+            elif isinstance(node, ast.Call):
+                callee = getattr(node.func, 'id', None)
+                symbol = symbol_table.lookup(callee) if callee else None
+                if callee in ('int', 'float') or callee in comptime_names:
+                    pass
+                elif callee == 'range':
+                    if not (isinstance(node.parent, ast.For) and node.parent.iter is node):
+                        raise TypeError(f"@comptime function '{name}' may only use range() in a for loop.")
+                elif symbol and symbol.is_c_function and callee in LIBM_FUNCTIONS:
+                    pass
+                else:
+                    raise TypeError(f"@comptime function '{name}' calls '{callee or ast.unparse(node.func)}', "
+                                    f"which cannot run at compile time.")
+                if node.keywords:
+                    raise TypeError(f"@comptime function '{name}' may not pass keyword arguments.")
+            elif isinstance(node, ast.Subscript):
+                if not isinstance(node.value, ast.Name) or isinstance(node.slice, ast.Slice):
+                    raise TypeError(f"@comptime function '{name}' may only index local arrays.")
+            elif isinstance(node, ast.Constant):
+                if isinstance(node.value, str) and not isinstance(node.parent, ast.Expr):
+                    raise TypeError(f"@comptime function '{name}' may not use strings.")
+            elif isinstance(node, ast.Assign):
+                if len(node.targets) != 1 or not isinstance(node.targets[0], (ast.Name, ast.Subscript)):
+                    raise TypeError(f"@comptime function '{name}' may only assign to locals.")
+            elif isinstance(node, ast.For):
+                if not (isinstance(node.iter, ast.Call) and getattr(node.iter.func, 'id', None) == 'range') or node.orelse:
+                    raise TypeError(f"@comptime function '{name}' may only loop over range().")
+            elif isinstance(node, ast.BinOp):
+                if not isinstance(node.op, (ast.Add, ast.Sub, ast.Mult, ast.Div, ast.FloorDiv, ast.Mod)):
+                    raise TypeError(f"@comptime function '{name}' uses an unsupported operator.")
+            elif not isinstance(node, (ast.If, ast.While, ast.Break, ast.Continue, ast.Return,
+                                       ast.Expr, ast.Name, ast.UnaryOp, ast.BoolOp, ast.Compare)):
+                raise TypeError(f"@comptime function '{name}' uses {type(node).__name__}, "
+                                f"which cannot run at compile time.")
@@ -0,0 +1,126 @@
+"""
+Compile Server and Watch Mode
+
+`--serve SOCKET` keeps one compiler process running, so a compile does not
+pay for starting Python and importing the compiler, and module summaries
+stay in memory between compiles (see build_cache). A request is one line
+of JSON, {"cwd": "/dir", "argv": ["prog.pyr", "-o", "prog"]}, answered
+with one line {"status": 0, "output": "..."}; `--connect SOCKET` sends its
+own arguments this way, and `python3 -m pyrinas.daemon SOCKET args...`
+does so without importing the compiler. Requests are compiled one at a
+time in the client's working directory.
+
+`--watch` recompiles whenever the program or a module it imports changes,
+by polling their modification times.
+"""
+
+import io
+import json
+import os
+import signal
+import socket
+import socketserver
+import sys
+import time
+import traceback
+from contextlib import redirect_stderr, redirect_stdout
+
+POLL_INTERVAL = 0.1  # seconds between checks in watch mode
+
+
+def compile_request(request):
+    """Compiles one request in the server process; returns (status, output)."""
+    from pyrinas import cli
+    output = io.StringIO()
+    status = 0
+    cwd = os.getcwd()
+    try:
+        with redirect_stdout(output), redirect_stderr(output):
+            args = cli.build_parser().parse_args(request['argv'])
+            if args.serve or args.connect or args.watch or not args.input_file:
+                raise ValueError("a compile request needs an input file and no --serve, --connect or --watch")
+            os.chdir(request['cwd'])
+            cli.run(args)
+    except SystemExit as e:
+        status = e.code if isinstance(e.code, int) else 1
+    except Exception:
+        output.write(traceback.format_exc())
+        status = 1
+    finally:
+        os.chdir(cwd)
+    return status, output.getvalue()
+
+
+class CompileHandler(socketserver.StreamRequestHandler):
+    def handle(self):
+        try:
+            request = json.loads(self.rfile.readline())
+            status, output = compile_request(request)
+        except (ValueError, KeyError, TypeError) as e:
+            status, output = 1, f"Bad compile request: {e}\n"
+        self.wfile.write((json.dumps({'status': status, 'output': output}) + '\n').encode())
+
+
+def serve(socket_path):
+    """Serves compile requests on a Unix socket until interrupted."""
+    if os.path.exists(socket_path):
+        os.unlink(socket_path)
+    # Clean up the socket when stopped with kill as well as with Ctrl-C
+    signal.signal(signal.SIGTERM, signal.default_int_handler)
+    with socketserver.UnixStreamServer(socket_path, CompileHandler) as server:
+        print(f"Serving compile requests on {socket_path}")
+        try:
+            server.serve_forever()
+        except KeyboardInterrupt:
+            pass
+        finally:
+            os.unlink(socket_path)
+
+
+def request(socket_path, argv):
+    """Sends a compile request to the server and prints its output; returns its status."""
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(socket_path)
+        sock.sendall((json.dumps({'cwd': os.getcwd(), 'argv': argv}) + '\n').encode())
+        response = sock.makefile('rb').readline()
+    reply = json.loads(response)
+    sys.stdout.write(reply['output'])
+    return reply['status']
+
+
+def _snapshot(paths):
+    stamps = {}
+    for path in paths:
+        try:
+            stamps[path] = os.stat(path).st_mtime_ns
+        except OSError:
+            stamps[path] = None
+    return stamps
+
+
+def watch(args):
+    """Compiles the program, then again after every change to its sources."""
+    from pyrinas import cli
+    sources = [os.path.abspath(args.input_file)]
+    while True:
+        try:
+            sources = cli.run(args)
+        except SystemExit:
+            pass
+        except Exception:
+            traceback.print_exc()
+        sys.stdout.flush()
+        print(f"Watching {len(sources)} file(s) for changes")
+
+        stamps = _snapshot(sources)
+        try:
+            while _snapshot(sources) == stamps:
+                time.sleep(POLL_INTERVAL)
+        except KeyboardInterrupt:
+            return
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 3:
+        sys.exit("usage: python3 -m pyrinas.daemon SOCKET input.pyr [options]")
+    sys.exit(request(sys.argv[1], sys.argv[2:]))
@@ -9,22 +9,84 @@ Handles importing modules from various sources:
 """
 
 import os
+import re
 import urllib.request
 import urllib.parse
 import hashlib
 import tempfile
+from concurrent.futures import ProcessPoolExecutor, wait, FIRST_COMPLETED
 from pathlib import Path
 from typing import Optional, List, Dict, Set
 from pyrinas.parser import get_ast
 from pyrinas.semantic import SemanticAnalyzer, ParentageVisitor
+from pyrinas.codegen import CCodeGenerator, write_line_map
+from pyrinas.build_cache import ModuleCache, ModuleSummary
+
+# @module_import("path") and @module_from_import("path", ...), found without parsing
+IMPORT_DECORATOR = re.compile(r'^\s*@module_(?:from_)?import\(\s*["\']([^"\']+)["\']', re.MULTILINE)
+
+
+class ModuleNode:
+    """A module in the import graph, before it is loaded."""
+    def __init__(self, resolved_path: str, source: str, module_prefix: str):
+        self.resolved_path = resolved_path
+        self.source = source
+        self.module_prefix = module_prefix
+        self.imports: Dict[str, str] = {}  # import path -> resolved path
+        self.source_key = None
+        self.cache_key = None
+
+
+def analyze_module(base_path: str, node: ModuleNode, entry: str, imported: Dict[str, ModuleSummary],
+                   bounds_check: bool, simd: bool, profile: bool, debug: bool) -> dict:
+    """
+    Parses and analyzes one module against the summaries of the modules it
+    imports, and writes its header and source to the cache entry. Runs on
+    a worker process; returns the module's summary.
+    """
+    resolver = ModuleResolver(base_path)
+    resolver.loaded_modules.update(imported)
+    resolver.module_symbols.update(imported)
+    
+    tree = get_ast(node.source)
+    ParentageVisitor().visit(tree)
+    analyzer = SemanticAnalyzer(current_file=node.resolved_path, module_resolver=resolver)
+    analyzer.visit(tree)
+    resolver._mangle_globals(analyzer, node.module_prefix)
+    
+    analyzer.header_file = os.path.join(entry, 'module.h')
+    generator = CCodeGenerator(analyzer.symbol_table, analyzer, bounds_check=bounds_check, simd=simd, profile=profile,
+                               line_directives=debug)
+    header, source = generator.generate_module_unit(analyzer)
+    os.makedirs(entry, exist_ok=True)
+    with open(analyzer.header_file, 'w', encoding='utf-8') as f:
+        f.write(header)
+    with open(os.path.join(entry, 'module.c'), 'w', encoding='utf-8') as f:
+        f.write(source)
+    if debug:
+        write_line_map(source, os.path.join(entry, 'module.c'))
+    
+    return {
+        'module_prefix': node.module_prefix,
+        'exports': resolver.get_module_exports(analyzer),
+        'c_includes': sorted(analyzer.c_includes),
+        'c_libraries': sorted(analyzer.c_libraries),
+        'cache_key': node.cache_key,
+    }
 
 
 class ModuleResolver:
-    def __init__(self, base_path: str = "."):
+    def __init__(self, base_path: str = ".", build_options=None):
         self.base_path = Path(base_path).resolve()
         self.cache_dir = Path(tempfile.gettempdir()) / "pyrinas_cache"
         self.cache_dir.mkdir(exist_ok=True)
         
+        # With build options, modules are loaded as a graph, compiled
+        # separately and cached
+        self.build_options = build_options
+        self.module_cache = (ModuleCache(self.cache_dir, build_options.cache_key(), build_options.pgo_key())
+                             if build_options else None)
+        
         # Track loaded modules to prevent circular imports
         self.loaded_modules: Set[str] = set()
         self.module_symbols: Dict[str, object] = {}  # Module path -> SemanticAnalyzer
@@ -169,6 +231,10 @@ class ModuleResolver:
         if resolved_path in self.loaded_modules:
             return self.module_symbols[resolved_path]
         
+        if self.module_cache:
+            self._load_graph([resolved_path])
+            return self.module_symbols[resolved_path]
+        
         # Mark as being loaded
         self.loaded_modules.add(resolved_path)
         
@@ -183,6 +249,7 @@ class ModuleResolver:
             ParentageVisitor().visit(tree)
             analyzer = SemanticAnalyzer(current_file=resolved_path, module_resolver=self)
             analyzer.visit(tree)
+            self._mangle_globals(analyzer, self._module_prefix(resolved_path, self.loaded_modules))
             
             # Store the analyzer
             self.module_symbols[resolved_path] = analyzer
@@ -194,6 +261,137 @@ class ModuleResolver:
             self.loaded_modules.discard(resolved_path)
             raise ImportError(f"Failed to load module '{import_path}': {e}")
 
+    def load_imports(self, code: str, current_file: str):
+        """
+        Loads every module a program imports, directly or not, before the
+        program is analyzed. Only used with build options.
+        """
+        if self.module_cache:
+            self._load_graph([self.resolve_import(path, current_file) for path in IMPORT_DECORATOR.findall(code)])
+
+    def _load_graph(self, roots: List[str]):
+        """
+        Loads the modules reachable from roots. The import graph is scanned
+        first, so every module's cache key is known up front; cached modules
+        are reused, and the rest are analyzed on a worker pool, each as soon
+        as the modules it imports are ready.
+        """
+        graph: Dict[str, ModuleNode] = {}
+        order: List[ModuleNode] = []  # Each module after the modules it imports
+        
+        def scan(resolved_path, stack):
+            if resolved_path in self.loaded_modules:
+                return
+            if resolved_path in stack:
+                raise ImportError(f"Circular import of '{resolved_path}'")
+            if resolved_path in graph:
+                return
+            with open(resolved_path, 'r') as f:
+                source = f.read()
+            node = ModuleNode(resolved_path, source, self._module_prefix(resolved_path, list(graph) + list(self.loaded_modules)))
+            graph[resolved_path] = node
+            stack.append(resolved_path)
+            for import_path in IMPORT_DECORATOR.findall(source):
+                node.imports[import_path] = self.resolve_import(import_path, resolved_path)
+                scan(node.imports[import_path], stack)
+            stack.pop()
+            order.append(node)
+        
+        for root in roots:
+            scan(root, [])
+        
+        def key_of(resolved_path):
+            return graph[resolved_path].cache_key if resolved_path in graph else self.module_symbols[resolved_path].cache_key
+        
+        for node in order:
+            node.source_key = self.module_cache.source_key(node.source, node.module_prefix)
+            node.cache_key = self.module_cache.module_key(node.source_key, [key_of(path) for path in node.imports.values()])
+        
+        def finish(node, summary, compiled):
+            imported = {import_path: self.module_symbols[path] for import_path, path in node.imports.items()}
+            self.module_symbols[node.resolved_path] = ModuleSummary(
+                node.resolved_path, summary, self.module_cache.entry_dir(node.source_key), node.source_key,
+                imported, compiled)
+            self.loaded_modules.add(node.resolved_path)
+        
+        pending = []
+        for node in order:
+            summary = self.module_cache.load(node.source_key, node.cache_key)
+            if summary:
+                finish(node, summary, compiled=True)
+            else:
+                pending.append(node)
+        
+        def analyze(node, pool=None):
+            imported = {path: self.module_symbols[path] for path in node.imports.values()}
+            args = (str(self.base_path), node, str(self.module_cache.entry_dir(node.source_key)), imported,
+                    self.build_options.bounds_check, self.build_options.simd, self.build_options.profile,
+                    self.build_options.debug)
+            return pool.submit(analyze_module, *args) if pool else analyze_module(*args)
+        
+        current = None
+        try:
+            if len(pending) <= 1 or self.build_options.jobs == 1:
+                for node in pending:
+                    current = node
+                    finish(node, analyze(node), compiled=False)
+                return
+            
+            with ProcessPoolExecutor(max_workers=min(self.build_options.jobs, len(pending))) as pool:
+                running = {}
+                while pending or running:
+                    for node in [node for node in pending if all(path in self.loaded_modules for path in node.imports.values())]:
+                        pending.remove(node)
+                        running[analyze(node, pool)] = node
+                    done, _ = wait(running, return_when=FIRST_COMPLETED)
+                    for future in done:
+                        current = running.pop(future)
+                        finish(current, future.result(), compiled=False)
+        except Exception as e:
+            raise ImportError(f"Failed to load module '{current.resolved_path if current else roots[0]}': {e}")
+
+    def _module_prefix(self, resolved_path: str, known_paths) -> str:
+        """
+        Prefix for the C names of a module's globals: its file name, plus a
+        hash of its path if another known module has the same file name.
+        """
+        stem = ''.join(c if c.isalnum() else '_' for c in Path(resolved_path).stem)
+        if any(Path(path).stem == Path(resolved_path).stem for path in known_paths if path != resolved_path):
+            stem += '_' + hashlib.sha256(resolved_path.encode()).hexdigest()[:8]
+        return stem + '_'
+
+    def _mangle_globals(self, analyzer: 'SemanticAnalyzer', module_prefix: str):
+        """Gives the module's own functions and constants C names that cannot collide."""
+        analyzer.module_prefix = module_prefix
+        for name, symbol in self.get_module_exports(analyzer).items():
+            if symbol.c_name or getattr(symbol, 'is_c_function', False):
+                continue  # Imported from another module, or defined in C
+            if symbol.type == 'function' and (name == 'main' or name.startswith('_import_')):
+                continue
+            if symbol.type in ('function', 'int', 'float', 'str', 'bool'):
+                symbol.c_name = f'{module_prefix}_{name}'
+
+    def store_module(self, module: ModuleSummary):
+        """Records a freshly compiled module in the cache."""
+        self.module_cache.store(module.source_key, module.summary)
+
+    def build_order(self) -> List[object]:
+        """Every loaded module, each after the modules it imports."""
+        order = []
+        seen = set()
+        
+        def visit(module):
+            if module.current_file in seen:
+                return
+            seen.add(module.current_file)
+            for imported in module.imported_modules.values():
+                visit(imported)
+            order.append(module)
+        
+        for module in list(self.module_symbols.values()):
+            visit(module)
+        return order
+
     def get_module_exports(self, analyzer: 'SemanticAnalyzer') -> Dict[str, object]:
         """Extract exportable symbols from a module's semantic analyzer."""
         exports = {}
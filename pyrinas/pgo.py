@@ -0,0 +1,96 @@
+"""
+Profile-Guided Optimization
+
+--pgo-generate builds the program, its modules and the runtime with
+-fprofile-generate, so running the program records how often each branch
+is taken and each function is called. --pgo-use builds them again with
+-fprofile-use, and GCC lays out, inlines and unrolls code for what was
+recorded. --pgo-train "<cmd>" does both around one run of cmd.
+
+Each compiled unit (the program, a module, the runtime) keeps its profile
+in a directory of its own under the profile directory, named by a hash of
+the unit's C source and the build options. A unit that changed since it
+was trained finds no profile there, and is compiled without one and with
+a warning instead of with stale data. -dumpdir and -fprofile-prefix-path
+(GCC 11 and later) name the profile file after the object alone, not its
+directory, so the instrumented and the optimized objects may be built in
+different places.
+"""
+
+import glob
+import hashlib
+import os
+import subprocess
+import tempfile
+
+DEFAULT_DIR = os.path.join(tempfile.gettempdir(), 'pyrinas_cache', 'pgo')
+
+
+def unit_dir(options, c_file, extra_sources=()):
+    """The profile directory of one unit: a hash of its sources and the build options."""
+    digest = hashlib.sha256(options.cache_key().encode())
+    for path in (c_file,) + tuple(extra_sources):
+        with open(path, 'rb') as f:
+            digest.update(f.read())
+        digest.update(b'\0')
+    return os.path.join(options.pgo_dir, digest.hexdigest()[:32])
+
+
+def profile_file(options, c_file, object_file, extra_sources=()):
+    """Where the profile of this unit's object is written and read."""
+    stem = os.path.splitext(os.path.basename(object_file))[0]
+    return os.path.join(unit_dir(options, c_file, extra_sources), f'.#{stem}.gcda')
+
+
+def compile_flags(options, c_file, object_file, extra_sources=()):
+    """PGO flags for compiling c_file to object_file; extra_sources also key the profile."""
+    if not options.pgo:
+        return []
+    directory = unit_dir(options, c_file, extra_sources)
+    options.pgo_units.add(directory)
+    # The profile is named after <cwd>/./<object stem>, less the cwd
+    flags = ['-dumpdir', './', f'-fprofile-prefix-path={os.getcwd()}']
+    if options.pgo == 'generate':
+        os.makedirs(directory, exist_ok=True)
+        # Tasks and parallel loops update the counters from several threads
+        return flags + [f'-fprofile-generate={directory}', '-fprofile-update=prefer-atomic']
+    if not os.path.exists(profile_file(options, c_file, object_file, extra_sources)):
+        print(f"Warning: no profile data for {c_file}; it changed since training or was not run. "
+              f"Compiling it without PGO.")
+        return []
+    return flags + [f'-fprofile-use={directory}', '-Wno-missing-profile']
+
+
+def link_flags(options):
+    """The instrumented program links the profiling runtime."""
+    return ['-fprofile-generate'] if options.pgo == 'generate' else []
+
+
+def profile_key(pgo_dir):
+    """Changes whenever profile data is recorded, so objects built from older data are rebuilt."""
+    digest = hashlib.sha256()
+    for path in sorted(glob.glob(os.path.join(pgo_dir, '*', '*.gcda'))):
+        stat = os.stat(path)
+        digest.update(f'{os.path.relpath(path, pgo_dir)} {stat.st_size} {stat.st_mtime_ns}\n'.encode())
+    return digest.hexdigest()[:16]
+
+
+def train(compile_program, options, command):
+    """
+    Builds an instrumented program, runs command (a shell command, in the
+    current directory) to record a fresh profile, then builds the program
+    with it. compile_program(options) builds and returns the source files.
+    """
+    options.pgo = 'generate'
+    compile_program(options)
+    for directory in options.pgo_units:
+        for path in glob.glob(os.path.join(directory, '*.gcda')):
+            os.remove(path)
+    print(f"Training: {command}")
+    status = subprocess.run(command, shell=True).returncode
+    if status != 0:
+        print(f"Error: training command exited with status {status}")
+        exit(1)
+    options.pgo = 'use'
+    options.pgo_units = set()
+    return compile_program(options)
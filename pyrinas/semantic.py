@@ -2,8 +2,85 @@ import ast
 import re
 from typing import Optional
 
+from pyrinas import comptime
+
+def c_parameter(type_name):
+    """
+    Splits an @c_function parameter type into its type and its qualifiers:
+    'const[span[float]]' is ('span[float]', {'const'}).
+    """
+    type_name = type_name.replace(' ', '')
+    qualifiers = set()
+    match = re.fullmatch(r'(const|restrict)\[(.*)\]', type_name)
+    while match:
+        qualifiers.add(match.group(1))
+        type_name = match.group(2)
+        match = re.fullmatch(r'(const|restrict)\[(.*)\]', type_name)
+    return type_name, qualifiers
+
+def type_name_of(annotation):
+    """Pyrinas type named by an annotation node, e.g. Result[ptr[int],str], or None."""
+    if isinstance(annotation, ast.Name):
+        return annotation.id
+    elif isinstance(annotation, ast.Constant) and isinstance(annotation.value, str):
+        return annotation.value
+    elif isinstance(annotation, ast.Subscript):
+        # Handle subscript annotations like ptr[str], array[int, 5], Result[int, str]
+        base_name = getattr(annotation.value, 'id', None)
+        if base_name == 'ptr':
+            inner_type = getattr(annotation.slice, 'id', None)
+            return f'ptr[{inner_type}]'
+        elif base_name == 'array':
+            if isinstance(annotation.slice, ast.Tuple) and len(annotation.slice.elts) == 2:
+                type_name = getattr(annotation.slice.elts[0], 'id', None)
+                size = annotation.slice.elts[1].value
+                return f'array[{type_name},{size}]'
+        elif base_name in ('Pool', 'span', 'const', 'restrict'):
+            elem_type = type_name_of(annotation.slice)
+            return f'{base_name}[{elem_type}]' if elem_type else None
+        elif base_name == 'Result':
+            if isinstance(annotation.slice, ast.Tuple) and len(annotation.slice.elts) == 2:
+                success_type = type_name_of(annotation.slice.elts[0])
+                error_type = type_name_of(annotation.slice.elts[1])
+                if success_type and error_type:
+                    return f'Result[{success_type},{error_type}]'
+        return None
+    else:
+        return None
+
+def result_type_args(type_str):
+    """
+    Splits 'Result[T,E]' into (T, E), matching brackets so that either may
+    itself be a type such as ptr[int].
+    """
+    if type_str.startswith('Result[') and type_str.endswith(']'):
+        inner = type_str[len('Result['):-1]
+        depth = 0
+        for i, char in enumerate(inner):
+            if char == '[':
+                depth += 1
+            elif char == ']':
+                depth -= 1
+            elif char == ',' and depth == 0:
+                return inner[:i].strip(), inner[i + 1:].strip()
+    raise TypeError(f"Invalid Result type format: {type_str}")
+
+def parallel_reductions(iter_node):
+    """(variable, operator) pairs from prange(n, sum=x, max=(y, z)); the operators are '+', 'min' and 'max'."""
+    operators = {'sum': '+', 'min': 'min', 'max': 'max'}
+    reductions = []
+    for keyword in iter_node.keywords:
+        if keyword.arg not in operators:
+            raise TypeError(f"Unknown prange() reduction '{keyword.arg}'; expected sum, min or max.")
+        names = keyword.value.elts if isinstance(keyword.value, ast.Tuple) else [keyword.value]
+        for name in names:
+            if not isinstance(name, ast.Name):
+                raise TypeError(f"prange() {keyword.arg} reduction expects variable names.")
+            reductions.append((name.id, operators[keyword.arg]))
+    return reductions
+
 class Symbol:
-    def __init__(self, name, type, param_types=None, return_type=None, fields=None, immutable=False, methods=None, implements=None, enum_members=None, is_c_function=False, c_library=None):
+    def __init__(self, name, type, param_types=None, return_type=None, fields=None, immutable=False, methods=None, implements=None, enum_members=None, is_c_function=False, c_library=None, is_comptime=False):
         self.name = name
         self.type = type
         self.param_types = param_types
@@ -16,6 +93,8 @@ class Symbol:
         # C interop attributes
         self.is_c_function = is_c_function # Whether this is a C function
         self.c_library = c_library # C library name (if any)
+        self.is_comptime = is_comptime # @comptime: constant calls are evaluated by the compiler
+        self.c_name = None # Mangled C name of an imported module's function or constant
 
 class SymbolTable:
     def __init__(self):
@@ -56,42 +135,32 @@ class SemanticAnalyzer(ast.NodeVisitor):
         self.current_file = current_file
         self.module_resolver = module_resolver
         self.imported_modules = {}  # import_path -> analyzer
+        # Devirtualization: interface-typed locals whose concrete struct is known
+        self.concrete_types = {}
+        self.reassigned_names = set()
+        # Bounds-check elimination: loop variable -> constant range() limit
+        self.loop_bounds = {}
+        # @comptime functions: name -> FunctionDef, and the interpreter that runs them
+        self.comptime_functions = {}
+        self.comptime = None
+        self.in_compile_time_only = False
     
-    def _get_type_name(self, annotation):
-        """Extract type name from annotation node (handles both ast.Name and ast.Constant)"""
-        if isinstance(annotation, ast.Name):
-            return annotation.id
-        elif isinstance(annotation, ast.Constant) and isinstance(annotation.value, str):
-            return annotation.value
-        elif isinstance(annotation, ast.Subscript):
-            # Handle subscript annotations like ptr[str], array[int, 5], Result[int, str]
-            base_name = getattr(annotation.value, 'id', None)
-            if base_name == 'ptr':
-                inner_type = getattr(annotation.slice, 'id', None)
-                return f'ptr[{inner_type}]'
-            elif base_name == 'array':
-                if isinstance(annotation.slice, ast.Tuple) and len(annotation.slice.elts) == 2:
-                    type_name = getattr(annotation.slice.elts[0], 'id', None)
-                    size = annotation.slice.elts[1].value
-                    return f'array[{type_name},{size}]'
-            elif base_name == 'Result':
-                if isinstance(annotation.slice, ast.Tuple) and len(annotation.slice.elts) == 2:
-                    success_type = getattr(annotation.slice.elts[0], 'id', None)
-                    error_type = getattr(annotation.slice.elts[1], 'id', None)
-                    return f'Result[{success_type},{error_type}]'
-            return None
-        else:
-            return None
-
     def _process_decorators(self, decorators):
-        """Process function decorators for C interop"""
+        """Process function decorators for C interop and compile-time evaluation"""
         is_c_function = False
         c_library = None
+        is_comptime = False
+        is_inline = False
         
         for decorator in decorators:
             if isinstance(decorator, ast.Name):
                 if decorator.id == 'c_function':
                     is_c_function = True
+                elif decorator.id in ('comptime', 'const'):
+                    is_comptime = True
+                elif decorator.id == 'inline':
+                    # Only changes the generated C; see CCodeGenerator._is_inline
+                    is_inline = True
                 elif decorator.id == 'c_include':
                     # This should be handled at module level, not function level
                     pass
@@ -105,7 +174,11 @@ class SemanticAnalyzer(ast.NodeVisitor):
                         if isinstance(decorator.args[0], ast.Constant):
                             self.c_includes.add(decorator.args[0].value)
         
-        return is_c_function, c_library
+        if is_comptime and is_c_function:
+            raise TypeError("A @c_function cannot be @comptime.")
+        if is_inline and is_c_function:
+            raise TypeError("A @c_function cannot be @inline.")
+        return is_c_function, c_library, is_comptime
 
     def _is_external_function(self, node):
         """Check if a function is external (has only pass statements)"""
@@ -173,6 +246,8 @@ class SemanticAnalyzer(ast.NodeVisitor):
         return False
 
     def visit_Module(self, node):
+        self.tree = node  # Module codegen reads the annotated tree
+        
         # Phase 0: Process imports first
         for item in node.body:
             if self._handle_import_statement(item):
@@ -200,7 +275,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 func_name = item.name
                 
                 # Process decorators for C interop
-                is_c_function, c_library = self._process_decorators(item.decorator_list)
+                is_c_function, c_library, is_comptime = self._process_decorators(item.decorator_list)
                 
                 # Determine return type
                 return_type = None
@@ -209,6 +284,8 @@ class SemanticAnalyzer(ast.NodeVisitor):
                         return_type = item.returns.id
                     elif isinstance(item.returns, ast.Constant) and isinstance(item.returns.value, str):
                         return_type = item.returns.value  # Handle string literal annotations like 'ptr[float]'
+                        if return_type.startswith('array['):
+                            return_type = return_type.replace(' ', '')
                     elif isinstance(item.returns, ast.Tuple) and len(item.returns.elts) == 2:
                         success_type = getattr(item.returns.elts[0], 'id', 'unknown')
                         error_type = getattr(item.returns.elts[1], 'id', 'unknown')
@@ -216,8 +293,8 @@ class SemanticAnalyzer(ast.NodeVisitor):
                     elif isinstance(item.returns, ast.Subscript) and getattr(item.returns.value, 'id', None) == 'Result':
                         # Handle Result[type1,type2] syntax
                         if isinstance(item.returns.slice, ast.Tuple) and len(item.returns.slice.elts) == 2:
-                            success_type = getattr(item.returns.slice.elts[0], 'id', 'unknown')
-                            error_type = getattr(item.returns.slice.elts[1], 'id', 'unknown')
+                            success_type = type_name_of(item.returns.slice.elts[0]) or 'unknown'
+                            error_type = type_name_of(item.returns.slice.elts[1]) or 'unknown'
                             return_type = f'Result[{success_type},{error_type}]'
                     elif isinstance(item.returns, ast.Constant) and item.returns.value is None:
                         # Handle None return type
@@ -226,7 +303,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 # Extract parameter types
                 param_types = []
                 for arg in item.args.args:
-                    type_name = self._get_type_name(arg.annotation)
+                    type_name = type_name_of(arg.annotation)
                     if type_name is None:
                         raise TypeError(f"Parameter '{arg.arg}' must have a type annotation.")
                     param_types.append(type_name)
@@ -240,12 +317,22 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 # Register the function
                 if self.symbol_table.lookup_current_scope(func_name):
                     raise NameError(f"Function '{func_name}' already defined.")
-                symbol = Symbol(func_name, 'function', param_types=param_types, return_type=return_type, is_c_function=is_c_function, c_library=c_library)
+                symbol = Symbol(func_name, 'function', param_types=param_types, return_type=return_type, is_c_function=is_c_function, c_library=c_library, is_comptime=is_comptime)
                 self.symbol_table.insert(symbol)
+                if is_comptime:
+                    self.comptime_functions[func_name] = item
             elif isinstance(item, ast.ClassDef):
                 # Register struct definition
                 self.visit_ClassDef(item)
         
+        # Compile-time functions must be interpretable before any call is evaluated
+        signatures = {}
+        for func_name, func in self.comptime_functions.items():
+            symbol = self.symbol_table.lookup(func_name)
+            comptime.check_function(func, symbol.param_types, symbol.return_type, self.symbol_table, self.comptime_functions)
+            signatures[func_name] = (symbol.param_types, symbol.return_type)
+        self.comptime = comptime.Interpreter(self.comptime_functions, signatures)
+
         # Second pass: visit all nodes including function bodies
         for item in node.body:
             if isinstance(item, ast.FunctionDef):
@@ -253,6 +340,113 @@ class SemanticAnalyzer(ast.NodeVisitor):
             elif not isinstance(item, ast.ClassDef):
                 self.visit(item)
 
+        # Aliasing facts need every call site, which only a program's main file has
+        if main_found:
+            self._find_restrict_params(node)
+            self._mark_vectorizable_loops(node)
+
+    def _is_flat_pointer(self, type_name):
+        """Array or pointer whose elements hold no further pointers."""
+        return bool(type_name) and re.fullmatch(r'(array\[(int|float|bool),\s*\d+\]|ptr\[(int|float|bool)\])', type_name) is not None
+
+    def _local_arrays(self, func):
+        """Arrays of scalars declared in a function body."""
+        arrays = set()
+        for stmt in ast.walk(func):
+            if isinstance(stmt, ast.AnnAssign) and isinstance(stmt.target, ast.Name):
+                type_name = type_name_of(stmt.annotation)
+                if self._is_flat_pointer(type_name) and type_name.startswith('array['):
+                    arrays.add(stmt.target.id)
+        return arrays
+
+    def _pointer_root(self, arg, local_names, local_arrays):
+        """Local whose memory a pointer argument refers to, or None if unknown."""
+        if isinstance(arg, ast.Name):
+            return arg.id if arg.id in local_arrays else None
+        if isinstance(arg, ast.Call) and getattr(arg.func, 'id', None) == 'addr' and len(arg.args) == 1:
+            target = arg.args[0]
+            if isinstance(target, ast.Subscript):
+                return self._pointer_root(target.value, local_names, local_arrays)
+            while isinstance(target, ast.Attribute):
+                target = target.value
+            if isinstance(target, ast.Name) and target.id in local_names:
+                return target.id
+        return None
+
+    def _find_restrict_params(self, module):
+        """
+        Sets FunctionDef.restrict_params to the indices of array and pointer
+        parameters that never alias another argument: every call passes them
+        a local array, or addr() of a local, that no other argument of the call
+        can reach. Functions used other than by a direct call keep none.
+        """
+        functions = {}
+        for item in module.body:
+            symbol = self.symbol_table.lookup(item.name) if isinstance(item, ast.FunctionDef) else None
+            if symbol and symbol.type == 'function' and not symbol.is_c_function:
+                item.restrict_params = {i for i, t in enumerate(symbol.param_types) if self._is_flat_pointer(t)}
+                functions[item.name] = item
+
+        callers = [node for node in ast.walk(module) if isinstance(node, ast.FunctionDef)]
+        direct_calls = set()
+        for caller in callers:
+            local_names = {stmt.target.id for stmt in ast.walk(caller)
+                           if isinstance(stmt, ast.AnnAssign) and isinstance(stmt.target, ast.Name)}
+            local_arrays = self._local_arrays(caller)
+            for call in ast.walk(caller):
+                if not (isinstance(call, ast.Call) and isinstance(call.func, ast.Name) and call.func.id in functions):
+                    continue
+                direct_calls.add(id(call.func))
+                restrict = functions[call.func.id].restrict_params
+                roots = []
+                for arg in call.args:
+                    root = self._pointer_root(arg, local_names, local_arrays)
+                    if root is None and getattr(arg, 'pyr_type', None) not in ('int', 'float', 'bool', 'str'):
+                        # A pointer of unknown origin could reach any argument
+                        restrict.clear()
+                        break
+                    roots.append(root)
+                restrict.intersection_update(i for i, root in enumerate(roots)
+                                             if root is not None and roots.count(root) == 1)
+
+        # Functions passed to spawn(), parallel_for() and the like have unknown callers
+        for node in ast.walk(module):
+            if isinstance(node, ast.Name) and node.id in functions and id(node) not in direct_calls:
+                functions[node.id].restrict_params = set()
+
+    def _mark_vectorizable_loops(self, module):
+        """
+        Sets For.vectorizable on range() loops whose iterations are
+        independent: every array used is a local or a restrict parameter, so
+        distinct names are distinct memory; arrays written at the loop index
+        are read only there; and scalars written are declared in the body.
+        The loop must be innermost and call nothing.
+        """
+        for func in module.body:
+            if not isinstance(func, ast.FunctionDef):
+                continue
+            restrict = getattr(func, 'restrict_params', set())
+            arrays = self._local_arrays(func) | {func.args.args[i].arg for i in restrict}
+            for loop in ast.walk(func):
+                if not (isinstance(loop, ast.For) and isinstance(loop.iter, ast.Call)
+                        and getattr(loop.iter.func, 'id', None) == 'range' and isinstance(loop.target, ast.Name)):
+                    continue
+                loop_var = loop.target.id
+                body = list(ast.walk(ast.Module(body=loop.body, type_ignores=[])))
+                # Variables written must be declared in the body, so that no scalar
+                # (such as a float sum ivdep could let GCC reorder) carries over
+                private = {n.target.id for n in body if isinstance(n, ast.AnnAssign) and isinstance(n.target, ast.Name)}
+                if any(isinstance(n, (ast.For, ast.While, ast.Call, ast.Break, ast.Continue, ast.Return))
+                       or (isinstance(n, ast.Name) and isinstance(n.ctx, ast.Store) and n.id not in private)
+                       for n in body):
+                    continue
+                subscripts = [n for n in body if isinstance(n, ast.Subscript)]
+                if not all(isinstance(n.value, ast.Name) and n.value.id in arrays for n in subscripts):
+                    continue
+                at_loop_var = lambda n: isinstance(n.slice, ast.Name) and n.slice.id == loop_var
+                written = {n.value.id for n in subscripts if isinstance(n.ctx, ast.Store)}
+                loop.vectorizable = all(at_loop_var(n) for n in subscripts if n.value.id in written)
+
     def visit_ClassDef(self, node):
         class_name = node.name
         if self.symbol_table.lookup_current_scope(class_name):
@@ -302,7 +496,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 if isinstance(stmt, ast.AnnAssign):
                     # Field declaration
                     field_name = stmt.target.id
-                    field_type = self._get_type_name(stmt.annotation)
+                    field_type = type_name_of(stmt.annotation)
                     if field_type is None:
                         field_type = "unknown"
                     fields[field_name] = field_type
@@ -315,7 +509,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
                     # Extract parameter types (skip 'self' parameter)
                     param_types = []
                     for arg in stmt.args.args[1:]:  # Skip self
-                        type_name = self._get_type_name(arg.annotation)
+                        type_name = type_name_of(arg.annotation)
                         if type_name is None:
                             raise TypeError(f"Method parameter '{arg.arg}' must have a type annotation.")
                         param_types.append(type_name)
@@ -377,6 +571,103 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 if struct_return_type != interface_return_type:
                     raise TypeError(f"Method '{method_name}' in struct '{struct_name}' has return type '{struct_return_type}', but interface '{interface_name}' requires '{interface_return_type}'.")
 
+    def _is_assignable(self, value_type, target_type):
+        """A struct value can be used where an interface it implements is expected."""
+        if value_type == target_type:
+            return True
+        target_symbol = self.symbol_table.lookup(target_type) if isinstance(target_type, str) else None
+        if target_symbol and target_symbol.type == 'interface':
+            value_symbol = self.symbol_table.lookup(value_type) if isinstance(value_type, str) else None
+            return bool(value_symbol and value_symbol.type == 'struct' and target_type in value_symbol.implements)
+        return False
+
+    def _has_c_layout(self, type_name):
+        """Scalars, enums and pointers are laid out as in C; a struct is if all its fields are."""
+        if type_name in ('int', 'float', 'bool') or type_name.startswith('ptr['):
+            return True
+        symbol = self.symbol_table.lookup(type_name)
+        if symbol and symbol.type == 'struct':
+            return self._non_c_field(type_name) is None
+        return bool(symbol and symbol.type == 'enum')
+
+    def _non_c_field(self, struct_name):
+        """The first field of a struct that is not laid out as in C, as (name, type), or None."""
+        for field_name, field_type in self.symbol_table.lookup(struct_name).fields.items():
+            if not self._has_c_layout(field_type):
+                return field_name, field_type
+        return None
+
+    def _check_c_parameters(self, func_name, param_types):
+        """const[] and restrict[] qualify pointers; a struct shared by pointer must be laid out as in C."""
+        for i, type_name in enumerate(param_types):
+            base_type, qualifiers = c_parameter(type_name)
+            buffer = re.fullmatch(r'(?:ptr|span)\[(.+)\]|array\[(.+),\d+\]', base_type)
+            if qualifiers and not buffer:
+                raise TypeError(f"Parameter {i+1} of '{func_name}' is {type_name}, but const[] and restrict[] only apply to pointers, arrays and spans.")
+            element_type = buffer and (buffer.group(1) or buffer.group(2))
+            symbol = self.symbol_table.lookup(element_type) if element_type else None
+            if symbol and symbol.type == 'struct':
+                field = self._non_c_field(element_type)
+                if field:
+                    raise TypeError(f"Struct '{element_type}' cannot be shared with C by '{func_name}': field '{field[0]}' has type {field[1]}, which has no C layout.")
+
+    def _decays_to(self, arg_type, param_type):
+        """
+        An array is passed to C as a pointer to its first element, so it can
+        be passed for a pointer, a span or an array of no more elements.
+        """
+        array = re.fullmatch(r'array\[(.+),\s*(\d+)\]', arg_type or '')
+        if param_type == 'ptr[void]':
+            return bool(array) or (arg_type or '').startswith('ptr[')
+        target = re.fullmatch(r'(?:ptr|span)\[(.+)\]|array\[(.+),(\d+)\]', param_type)
+        if not array or not target:
+            return False
+        if target.group(1):
+            return array.group(1) == target.group(1)
+        return array.group(1) == target.group(2) and int(array.group(2)) >= int(target.group(3))
+
+    def _argument_root(self, node):
+        """The variable a pointer argument points into, or None if it is not known."""
+        if isinstance(node, ast.Call) and getattr(node.func, 'id', None) in ('span', 'addr') and node.args:
+            return self._argument_root(node.args[0])
+        while isinstance(node, (ast.Attribute, ast.Subscript)):
+            node = node.value
+        return node.id if isinstance(node, ast.Name) else None
+
+    def _check_c_call(self, node, func_symbol, func_name):
+        """
+        Arguments of an @c_function call. Arrays, spans and pointers are
+        passed as the address of their elements and a struct for a ptr[]
+        parameter as its own address, so nothing is copied. Only const[]
+        parameters take immutable data, and a restrict[] argument must not
+        point into the same variable as another pointer argument; distinct
+        variables are taken to be distinct memory.
+        """
+        if len(node.args) != len(func_symbol.param_types):
+            raise TypeError(f"Function '{func_name}' expects {len(func_symbol.param_types)} arguments, but got {len(node.args)}.")
+        pointers = []
+        for i, (arg_node, param_type) in enumerate(zip(node.args, func_symbol.param_types)):
+            expected_type, qualifiers = c_parameter(param_type)
+            arg_node.c_parameter = expected_type  # lets span() check where it is used
+            arg_type = self.visit(arg_node)
+            arg_symbol = self.symbol_table.lookup(arg_type) if isinstance(arg_type, str) else None
+            by_address = expected_type == f'ptr[{arg_type}]' and bool(arg_symbol and arg_symbol.type == 'struct')
+            if not (by_address or self._is_assignable(arg_type, expected_type) or self._decays_to(arg_type, expected_type)):
+                raise TypeError(f"Argument {i+1} of function '{func_name}' has type {arg_type}, but expected {param_type}.")
+            if by_address and not isinstance(arg_node, (ast.Name, ast.Attribute)):
+                raise TypeError(f"Argument {i+1} of function '{func_name}' is passed by address, so it must be a variable or a field.")
+            if not re.match(r'(ptr|array|span)\[', expected_type):
+                continue
+            root = self._argument_root(arg_node)
+            root_symbol = self.symbol_table.lookup(root) if root else None
+            if root_symbol and root_symbol.immutable and 'const' not in qualifiers:
+                raise TypeError(f"Immutable '{root}' can only be passed to a const[] parameter of '{func_name}', which could otherwise modify it.")
+            pointers.append((i, root, 'restrict' in qualifiers))
+        for i, root, restrict in pointers:
+            for j, other_root, _ in pointers:
+                if restrict and root and i != j and root == other_root:
+                    raise TypeError(f"Argument {i+1} of '{func_name}' is restrict[], but argument {j+1} also points into '{root}'.")
+
     def visit_FunctionDef(self, node):
         # Set current function return type for return statement validation
         return_type = None
@@ -385,6 +676,8 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 return_type = node.returns.id
             elif isinstance(node.returns, ast.Constant) and isinstance(node.returns.value, str):
                 return_type = node.returns.value  # Handle string literal annotations like 'ptr[float]'
+                if return_type.startswith('array['):
+                    return_type = return_type.replace(' ', '')
             elif isinstance(node.returns, ast.Tuple) and len(node.returns.elts) == 2:
                 success_type = getattr(node.returns.elts[0], 'id', 'unknown')
                 error_type = getattr(node.returns.elts[1], 'id', 'unknown')
@@ -392,8 +685,8 @@ class SemanticAnalyzer(ast.NodeVisitor):
             elif isinstance(node.returns, ast.Subscript) and getattr(node.returns.value, 'id', None) == 'Result':
                 # Handle Result[type1,type2] syntax
                 if isinstance(node.returns.slice, ast.Tuple) and len(node.returns.slice.elts) == 2:
-                    success_type = getattr(node.returns.slice.elts[0], 'id', 'unknown')
-                    error_type = getattr(node.returns.slice.elts[1], 'id', 'unknown')
+                    success_type = type_name_of(node.returns.slice.elts[0]) or 'unknown'
+                    error_type = type_name_of(node.returns.slice.elts[1]) or 'unknown'
                     return_type = f'Result[{success_type},{error_type}]'
                 else:
                     raise TypeError("Result return type must have exactly two type parameters.")
@@ -404,20 +697,35 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 raise TypeError("Unsupported return type annotation.")
         self.current_function_return_type = return_type
 
+        # An interface local declared once and never reassigned keeps the
+        # concrete type it was initialized with
+        self.concrete_types = {}
+        self.reassigned_names = {target.id for stmt in ast.walk(node) if isinstance(stmt, ast.Assign)
+                                 for target in stmt.targets if isinstance(target, ast.Name)}
+
         # Push a new scope for function parameters and local variables
         self.symbol_table.push_scope()
 
         # Register parameters in the new scope
         for arg in node.args.args:
             var_name = arg.arg
-            type_name = self._get_type_name(arg.annotation)
+            type_name = type_name_of(arg.annotation)
             if type_name is None:
                 raise TypeError(f"Parameter '{var_name}' must have a type annotation.")
             self.symbol_table.insert(Symbol(var_name, type_name))
 
         # Check if this is an external C function
-        is_c_function, _ = self._process_decorators(node.decorator_list)
+        is_c_function, _, is_comptime = self._process_decorators(node.decorator_list)
         is_external = self._is_external_function(node)
+        param_types = [type_name_of(arg.annotation) for arg in node.args.args]
+        if is_c_function:
+            self._check_c_parameters(node.name, param_types)
+        else:
+            for arg, type_name in zip(node.args.args, param_types):
+                if re.match(r'(span|const|restrict)\[', type_name):
+                    raise TypeError(f"Parameter '{arg.arg}' of '{node.name}': span[], const[] and restrict[] are only for @c_function parameters.")
+        # Array-returning @comptime functions only run in the compiler
+        self.in_compile_time_only = is_comptime and return_type is not None and return_type.startswith('array[')
         
         # For external C functions, skip body validation
         if is_c_function and is_external:
@@ -431,6 +739,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
         # Pop the scope after visiting the body
         self.symbol_table.pop_scope()
         self.current_function_return_type = None # Reset
+        self.in_compile_time_only = False
 
     def visit_AnnAssign(self, node):
         var_name = node.target.id
@@ -492,13 +801,27 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 success_type_node = node.annotation.slice.elts[0]
                 error_type_node = node.annotation.slice.elts[1]
                 
-                success_type = getattr(success_type_node, 'id', None)
-                error_type = getattr(error_type_node, 'id', None)
+                success_type = type_name_of(success_type_node)
+                error_type = type_name_of(error_type_node)
                 
                 if not success_type or not error_type:
-                    raise TypeError("Result types must be simple type names.")
+                    raise TypeError("Result type arguments must be types.")
 
                 type_name = f'Result[{success_type},{error_type}]'
+            elif annotation_name == 'Pool':
+                elem_type = type_name_of(node.annotation.slice)
+                if elem_type is None:
+                    raise TypeError("Pool annotation requires an element type.")
+                type_name = f'Pool[{elem_type}]'
+            elif annotation_name == 'task':
+                # Handle task[result_type] handles returned by spawn()
+                result_node = node.annotation.slice
+                if isinstance(result_node, ast.Name):
+                    type_name = f'task[{result_node.id}]'
+                elif isinstance(result_node, ast.Constant) and result_node.value is None:
+                    type_name = 'task[None]'
+                else:
+                    raise TypeError("task annotation requires a simple result type or None.")
             else:
                 raise TypeError(f"Unsupported subscript type annotation: {annotation_name}")
         else:
@@ -515,11 +838,21 @@ class SemanticAnalyzer(ast.NodeVisitor):
         
         if node.value:
             value_type = self.visit(node.value)
+            if isinstance(getattr(node.value, 'comptime_value', None), list):
+                # A table computed at compile time is emitted as static const
+                self.symbol_table.lookup_current_scope(var_name).immutable = True
+                if value_type == type_name.replace(' ', ''):
+                    value_type = type_name
             # Allow assigning ptr[void] (from malloc) to any other pointer type
             if value_type == 'ptr[void]' and type_name.startswith('ptr['):
                 pass # This is a valid assignment
-            elif value_type != type_name and not (type_name == 'bool' and value_type == 'int'):
+            elif not self._is_assignable(value_type, type_name) and not (type_name == 'bool' and value_type == 'int'):
                 raise TypeError(f"Type mismatch assigning to '{var_name}': expected {type_name}, got {value_type}")
+            # Remember the struct behind an interface local that is never reassigned
+            if value_type != type_name and self._is_assignable(value_type, type_name) and var_name not in self.reassigned_names:
+                self.concrete_types[var_name] = value_type
+            else:
+                self.concrete_types.pop(var_name, None)
     
     def visit_Assign(self, node):
         """Handle assignments and check for immutability violations"""
@@ -539,7 +872,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
                         
                     # Type check the assignment
                     value_type = self.visit(node.value)
-                    if value_type != symbol.type and not (symbol.type == 'bool' and value_type == 'int'):
+                    if not self._is_assignable(value_type, symbol.type) and not (symbol.type == 'bool' and value_type == 'int'):
                         raise TypeError(f"Type mismatch assigning to '{var_name}': expected {symbol.type}, got {value_type}")
                     
             elif isinstance(target, ast.Subscript):
@@ -579,6 +912,10 @@ class SemanticAnalyzer(ast.NodeVisitor):
         left_type = self.visit(node.left)
         right_type = self.visit(node.right)
 
+        if left_type == 'str' or right_type == 'str':
+            if left_type == right_type and isinstance(node.op, ast.Add):
+                return 'str'
+            raise TypeError(f"Unsupported binary operation between {left_type} and {right_type}")
         # Simple type promotion for now
         if left_type == 'float' or right_type == 'float':
             return 'float'
@@ -602,6 +939,9 @@ class SemanticAnalyzer(ast.NodeVisitor):
             if left_type != right_type:
                 raise TypeError(f"Cannot compare different enum types: '{left_type}' and '{right_type}'.")
 
+        if (left_type == 'str') != (right_type == 'str'):
+            raise TypeError(f"Cannot compare {left_type} with {right_type}.")
+
         # Comparison operations always result in a boolean
         return 'bool'
 
@@ -664,6 +1004,16 @@ class SemanticAnalyzer(ast.NodeVisitor):
         return struct_symbol.fields[field_name]
 
     def visit_Subscript(self, node):
+        if isinstance(node.slice, ast.Slice):
+            # s[start:end] shares the string's buffer
+            if self.visit(node.value) != 'str':
+                raise TypeError("Only str values can be sliced.")
+            if node.slice.step is not None:
+                raise TypeError("String slices do not support a step.")
+            for bound in (node.slice.lower, node.slice.upper):
+                if bound is not None and self.visit(bound) != 'int':
+                    raise TypeError("String slice bounds must be integers.")
+            return 'str'
         var_name = getattr(node.value, 'id', None)
         symbol = self.symbol_table.lookup(var_name)
         
@@ -682,11 +1032,29 @@ class SemanticAnalyzer(ast.NodeVisitor):
             
         # Return the base type of the array
         match = re.match(r'array\[(\w+),\s*(\d+)\]', symbol_type)
-        if match:
-            return match.group(1)
-        else:
+        if not match:
             raise TypeError(f"Could not parse array type: {symbol_type}")
 
+        # Indices proven in range need no check under --bounds-check
+        size = int(match.group(2))
+        index = self._constant_int(node.slice)
+        if index is not None:
+            if not 0 <= index < size:
+                raise TypeError(f"Index {index} is out of bounds for '{var_name}' of type {symbol_type}.")
+            node.index_in_bounds = True
+        elif isinstance(node.slice, ast.Name):
+            node.index_in_bounds = self.loop_bounds.get(node.slice.id, size + 1) <= size
+        return match.group(1)
+
+    def _constant_int(self, node):
+        """Value of an integer literal such as 3 or -1, else None."""
+        if isinstance(node, ast.UnaryOp) and isinstance(node.op, ast.USub):
+            value = self._constant_int(node.operand)
+            return -value if value is not None else None
+        if isinstance(node, ast.Constant) and type(node.value) is int:
+            return node.value
+        return None
+
     def visit_Match(self, node):
         subject_type = self.visit(node.subject)
         if not subject_type.startswith('Result['):
@@ -708,9 +1076,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
                  self.symbol_table.push_scope()
                  
                  # Determine the type of the captured variable
-                 import re
-                 match = re.match(r'Result\[(\w+),(\w+)\]', subject_type)
-                 success_type, error_type = match.groups()
+                 success_type, error_type = result_type_args(subject_type)
                  captured_var_type = success_type if class_name == 'Ok' else error_type
                  
                  captured_var_name = case.pattern.name
@@ -769,12 +1135,20 @@ class SemanticAnalyzer(ast.NodeVisitor):
 
         # Visit the iterable (e.g., range() call)
         self.visit(node.iter)
+        is_parallel = isinstance(node.iter, ast.Call) and getattr(node.iter.func, 'id', None) == 'prange'
+
+        # The loop variable stays in [0, n) for a constant n unless reassigned
+        limit = node.iter.args[0] if isinstance(node.iter, ast.Call) and node.iter.args else None
+        if self._constant_int(limit) is not None and loop_var_name not in self.reassigned_names:
+            self.loop_bounds[loop_var_name] = self._constant_int(limit)
 
         # Visit the body of the loop
         self.loop_depth += 1
         # Check for a label preceding the loop
         label = self._get_preceding_label(node)
         if label:
+            if is_parallel:
+                raise TypeError("prange loops cannot be labeled.")
             self.loop_labels.append(label)
 
         for statement in node.body:
@@ -783,6 +1157,118 @@ class SemanticAnalyzer(ast.NodeVisitor):
         if label:
             self.loop_labels.pop()
         self.loop_depth -= 1
+        self.loop_bounds.pop(loop_var_name, None)
+
+        if is_parallel:
+            reductions = parallel_reductions(node.iter)
+            self._check_parallel_loop(node, reductions)
+
+    def _task_function(self, node, builtin):
+        """The Pyrinas function passed to spawn() or parallel_for()."""
+        index = 0 if builtin == 'spawn' else 1
+        if len(node.args) <= index or not isinstance(node.args[index], ast.Name):
+            raise TypeError(f"{builtin}() expects a function name.")
+        func_symbol = self.symbol_table.lookup(node.args[index].id)
+        if not func_symbol or func_symbol.type != 'function' or func_symbol.is_c_function:
+            raise TypeError(f"{builtin}() expects a Pyrinas function, got '{node.args[index].id}'.")
+        return func_symbol
+
+    def _check_parallel_loop(self, node, reductions):
+        """
+        Rejects loop-carried dependencies in a prange body. Iterations may only
+        write variables declared in the body, declared reductions, and array
+        elements indexed by the loop variable; an array written this way must
+        also be read only at the loop variable.
+        """
+        loop_var = node.target.id
+        body = ast.Module(body=node.body, type_ignores=[])
+        private = {loop_var} | {stmt.target.id for stmt in ast.walk(body)
+                                if isinstance(stmt, ast.AnnAssign) and isinstance(stmt.target, ast.Name)}
+        reduction_ops = dict(reductions)
+        written_arrays = set()
+        
+        def mentions(node, name):
+            return any(isinstance(child, ast.Name) and child.id == name for child in ast.walk(node))
+        
+        def sum_terms(node, sign=1):
+            """The terms of a chain of + and -, with their signs."""
+            if isinstance(node, ast.BinOp) and isinstance(node.op, (ast.Add, ast.Sub)):
+                return sum_terms(node.left, sign) + sum_terms(node.right, -sign if isinstance(node.op, ast.Sub) else sign)
+            return [(node, sign)]
+        
+        def guards_extremum(guard, name, value, op):
+            """Whether guard is `if value > name:` (max) or `if value < name:` (min), either way round."""
+            test = guard.test if isinstance(guard, ast.If) else None
+            if not (isinstance(test, ast.Compare) and len(test.ops) == 1):
+                return False
+            left, right, compare = test.left, test.comparators[0], test.ops[0]
+            if isinstance(left, ast.Name) and left.id == name:
+                left, right = right, left
+                compare = {ast.Lt: ast.Gt(), ast.LtE: ast.GtE(), ast.Gt: ast.Lt(), ast.GtE: ast.LtE()}.get(type(compare), compare)
+            wanted = (ast.Gt, ast.GtE) if op == 'max' else (ast.Lt, ast.LtE)
+            return (isinstance(right, ast.Name) and right.id == name and isinstance(compare, wanted)
+                    and ast.dump(left) == ast.dump(value))
+        
+        def check_target(target, stmt, guard):
+            if isinstance(target, ast.Name):
+                if target.id in private:
+                    return
+                op = reduction_ops.get(target.id)
+                if op is None:
+                    raise TypeError(f"prange loop writes outer variable '{target.id}'; declare it as a reduction.")
+                name, value = target.id, stmt.value
+                if op == '+':
+                    terms = sum_terms(value)
+                    own = [sign for term, sign in terms if isinstance(term, ast.Name) and term.id == name]
+                    others = [term for term, _ in terms if not (isinstance(term, ast.Name) and term.id == name)]
+                    if own != [1] or any(mentions(term, name) for term in others):
+                        raise TypeError(f"Sum reduction '{name}' may only be updated as {name} = {name} + ..., "
+                                        f"with '{name}' appearing nowhere else in the expression.")
+                elif mentions(value, name) or not guards_extremum(guard, name, value, op):
+                    compare = '>' if op == 'max' else '<'
+                    raise TypeError(f"{op.capitalize()} reduction '{name}' may only be updated as "
+                                    f"if value {compare} {name}: {name} = value")
+            elif isinstance(target, ast.Subscript):
+                index = target.slice
+                if not (isinstance(index, ast.Name) and index.id == loop_var):
+                    raise TypeError(f"prange loop may only write array elements indexed by '{loop_var}'.")
+                if isinstance(target.value, ast.Name):
+                    written_arrays.add(target.value.id)
+            elif isinstance(target, ast.Attribute):
+                base = target.value
+                while isinstance(base, ast.Attribute):
+                    base = base.value
+                if not (isinstance(base, ast.Name) and base.id in private):
+                    raise TypeError("prange loop may not write fields of outer structs.")
+        
+        # guard is the if directly around the statements, whose test may
+        # make an assignment a min or max update
+        def check(statements, loop_nesting, guard=None):
+            for stmt in statements:
+                if isinstance(stmt, ast.Assign):
+                    for target in stmt.targets:
+                        check_target(target, stmt, guard)
+                elif isinstance(stmt, ast.AnnAssign):
+                    check_target(stmt.target, stmt, guard)
+                elif isinstance(stmt, ast.Break) and loop_nesting == 0:
+                    raise TypeError("break is not allowed inside a prange loop.")
+                elif isinstance(stmt, (ast.For, ast.While)):
+                    check(stmt.body, loop_nesting + 1)
+                elif isinstance(stmt, ast.If):
+                    check(stmt.body, loop_nesting, stmt)
+                    check(stmt.orelse, loop_nesting)
+        
+        check(node.body, 0)
+        for child in ast.walk(body):
+            if isinstance(child, ast.Return):
+                raise TypeError("return is not allowed inside a prange loop.")
+            elif isinstance(child, ast.Call) and getattr(child.func, 'id', None) == 'assign':
+                raise TypeError("prange loop may not write through pointers.")
+            elif isinstance(child, ast.Subscript) and isinstance(child.ctx, ast.Load):
+                array = getattr(child.value, 'id', None)
+                index = child.slice
+                if array in written_arrays and not (isinstance(index, ast.Name) and index.id == loop_var):
+                    raise TypeError(f"prange loop reads '{array}' at another iteration's index.")
 
     def visit_UnaryOp(self, node):
         operand_type = self.visit(node.operand)
@@ -827,9 +1313,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
 
         # Handle Result types
         if self.current_function_return_type.startswith('Result['):
-            import re
-            match = re.match(r'Result\[(\w+),(\w+)\]', self.current_function_return_type)
-            success_type, error_type = match.groups()
+            success_type, error_type = result_type_args(self.current_function_return_type)
 
             if returned_type.startswith('Ok[') and returned_type.endswith(']'):
                 inner_type = returned_type[3:-1]
@@ -842,7 +1326,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
             else:
                 raise TypeError(f"Must return an Ok or Err value from a function with a Result return type.")
 
-        elif returned_type != self.current_function_return_type:
+        elif (returned_type or '').replace(' ', '') != self.current_function_return_type:
             raise TypeError(f"Return type mismatch: expected {self.current_function_return_type}, got {returned_type}.")
 
     def visit_Constant(self, node):
@@ -862,10 +1346,13 @@ class SemanticAnalyzer(ast.NodeVisitor):
         if isinstance(node.func, ast.Name):
             func_name = node.func.id
             if func_name == 'print':
-                # For print, we just visit the arguments to ensure they are semantically valid
                 for arg in node.args:
                     self.visit(arg)
                 return # print doesn't return a value we care about for type checking
+            elif func_name == 'flush':
+                if node.args:
+                    raise TypeError("flush() takes no arguments.")
+                return None
             elif func_name in ('int', 'float', 'str', 'bool'):
                 # Built-in type conversion functions
                 if len(node.args) != 1:
@@ -877,6 +1364,52 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 if len(node.args) != 1 or not isinstance(node.args[0], ast.Constant) or not isinstance(node.args[0].value, int):
                     raise TypeError("range() expects exactly one integer argument.")
                 return 'range_object' # A special type to indicate it's a range object
+            elif func_name == 'prange':
+                if len(node.args) != 1 or self.visit(node.args[0]) != 'int':
+                    raise TypeError("prange() expects exactly one integer argument.")
+                for name, op in parallel_reductions(node):
+                    symbol = self.symbol_table.lookup(name)
+                    if not symbol:
+                        raise NameError(f"Reduction variable '{name}' not declared.")
+                    if symbol.type not in ('int', 'float'):
+                        raise TypeError(f"Reduction variable '{name}' must be int or float, not {symbol.type}.")
+                return 'range_object'
+            elif func_name == 'spawn':
+                # spawn(function, args...) runs function(args...) on the task scheduler
+                func_symbol = self._task_function(node, 'spawn')
+                if len(node.args) - 1 != len(func_symbol.param_types):
+                    raise TypeError(f"spawn() of '{func_symbol.name}' expects {len(func_symbol.param_types)} arguments, but got {len(node.args) - 1}.")
+                for i, arg_node in enumerate(node.args[1:]):
+                    arg_type = self.visit(arg_node)
+                    if not self._is_assignable(arg_type, func_symbol.param_types[i]):
+                        raise TypeError(f"Argument {i+1} of spawned function '{func_symbol.name}' has type {arg_type}, but expected {func_symbol.param_types[i]}.")
+                return f'task[{func_symbol.return_type or "None"}]'
+            elif func_name == 'join':
+                if len(node.args) != 1:
+                    raise TypeError("join() expects exactly one task.")
+                task_type = self.visit(node.args[0])
+                if not (isinstance(task_type, str) and task_type.startswith('task[')):
+                    raise TypeError(f"join() expects a task, got {task_type}.")
+                result_type = task_type[5:-1]
+                return None if result_type == 'None' else result_type
+            elif func_name == 'parallel_for':
+                # parallel_for(n, body) or parallel_for(n, body, data) calls body(i[, data]) for i in [0, n)
+                if len(node.args) not in (2, 3):
+                    raise TypeError("parallel_for() expects a count, a function and optionally a shared argument.")
+                if self.visit(node.args[0]) != 'int':
+                    raise TypeError("parallel_for() count must be an int.")
+                func_symbol = self._task_function(node, 'parallel_for')
+                expected = ['int'] + ([self.visit(node.args[2])] if len(node.args) == 3 else [])
+                if func_symbol.return_type is not None or func_symbol.param_types[:1] != ['int'] or \
+                        len(func_symbol.param_types) != len(expected):
+                    raise TypeError(f"parallel_for() body '{func_symbol.name}' must take (i: int{', data' if len(node.args) == 3 else ''}) and return None.")
+                if len(node.args) == 3:
+                    data_type = expected[1]
+                    if not (data_type.startswith('ptr[') or data_type.startswith('array[')):
+                        raise TypeError("parallel_for() shared argument must be a pointer or an array.")
+                    if not self._is_assignable(data_type, func_symbol.param_types[1]):
+                        raise TypeError(f"parallel_for() shared argument has type {data_type}, but '{func_symbol.name}' expects {func_symbol.param_types[1]}.")
+                return None
             elif func_name == 'addr':
                 if len(node.args) != 1 or not isinstance(node.args[0], ast.Name):
                     raise TypeError("addr() expects a single variable name as an argument.")
@@ -885,6 +1418,18 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 if not symbol:
                     raise NameError(f"Variable '{var_name}' not declared.")
                 return f'ptr[{symbol.type}]'
+            elif func_name == 'span':
+                if not getattr(node, 'c_parameter', '').startswith('span['):
+                    raise TypeError("span() can only be passed to a span[] parameter of a @c_function.")
+                if len(node.args) != 2:
+                    raise TypeError("span() expects a pointer or an array and a length.")
+                data_type = self.visit(node.args[0])
+                match = re.fullmatch(r'ptr\[(.+)\]|array\[(.+),\s*\d+\]', data_type or '')
+                if not match:
+                    raise TypeError(f"First argument to span() must be a pointer or an array, got {data_type}")
+                if self.visit(node.args[1]) != 'int':
+                    raise TypeError("Second argument to span() must be an int length.")
+                return f'span[{match.group(1) or match.group(2)}]'
             elif func_name == 'deref':
                 if len(node.args) != 1:
                     raise TypeError("deref() expects a single argument.")
@@ -915,6 +1460,51 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 if size_type != 'int':
                     raise TypeError(f"Argument to malloc() must be an integer, but got {size_type}.")
                 return 'ptr[void]' # malloc returns a generic pointer
+            elif func_name == 'len':
+                if len(node.args) != 1 or self.visit(node.args[0]) != 'str':
+                    raise TypeError("len() expects a single str argument.")
+                return 'int'
+            elif func_name == 'str_free':
+                if len(node.args) != 1 or self.visit(node.args[0]) != 'str':
+                    raise TypeError("str_free() expects a single str argument.")
+                return None
+            elif func_name == 'str_builder_new':
+                if len(node.args) > 1 or (node.args and self.visit(node.args[0]) != 'int'):
+                    raise TypeError("str_builder_new() expects an optional integer capacity.")
+                return 'StrBuilder'
+            elif func_name == 'str_builder_append':
+                if len(node.args) != 2 or self.visit(node.args[0]) != 'StrBuilder' or self.visit(node.args[1]) != 'str':
+                    raise TypeError("str_builder_append() expects a StrBuilder and a str.")
+                return None
+            elif func_name == 'str_builder_finish':
+                if len(node.args) != 1 or self.visit(node.args[0]) != 'StrBuilder':
+                    raise TypeError("str_builder_finish() expects a single StrBuilder argument.")
+                return 'str'
+            elif func_name == 'arena_new':
+                if len(node.args) > 1 or (node.args and self.visit(node.args[0]) != 'int'):
+                    raise TypeError("arena_new() expects an optional integer block size.")
+                return 'Arena'
+            elif func_name in ('arena_reset', 'arena_free'):
+                if len(node.args) != 1 or self.visit(node.args[0]) != 'Arena':
+                    raise TypeError(f"{func_name}() expects a single Arena argument.")
+                return None
+            elif func_name == 'pool_alloc':
+                if len(node.args) != 1:
+                    raise TypeError("pool_alloc() expects a single Pool argument.")
+                return f'ptr[{self._pool_element_type(node, func_name)}]'
+            elif func_name == 'pool_release':
+                if len(node.args) != 2:
+                    raise TypeError("pool_release() expects a Pool and a pointer.")
+                elem_type = self._pool_element_type(node, func_name)
+                ptr_type = self.visit(node.args[1])
+                if ptr_type != f'ptr[{elem_type}]':
+                    raise TypeError(f"pool_release() expects ptr[{elem_type}], but got {ptr_type}.")
+                return None
+            elif func_name == 'pool_free':
+                if len(node.args) != 1:
+                    raise TypeError("pool_free() expects a single Pool argument.")
+                self._pool_element_type(node, func_name)
+                return None
             elif func_name == 'free':
                 if len(node.args) != 1:
                     raise TypeError("free() expects a single pointer argument.")
@@ -974,7 +1564,10 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 func_symbol = self.symbol_table.lookup(func_name) # Use lookup for functions as they can be defined before use
                 if not func_symbol or func_symbol.type != 'function':
                     raise NameError(f"Function '{func_name}' not defined.")
-                
+                if func_symbol.is_c_function:
+                    self._check_c_call(node, func_symbol, func_name)
+                    return func_symbol.return_type
+
                 # Validate argument count and types
                 if len(node.args) != len(func_symbol.param_types):
                     raise TypeError(f"Function '{func_name}' expects {len(func_symbol.param_types)} arguments, but got {len(node.args)}.")
@@ -982,16 +1575,84 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 for i, arg_node in enumerate(node.args):
                     arg_type = self.visit(arg_node)
                     expected_type = func_symbol.param_types[i]
-                    if arg_type != expected_type:
+                    if not self._is_assignable(arg_type, expected_type):
                         raise TypeError(f"Argument {i+1} of function '{func_name}' has type {arg_type}, but expected {expected_type}.")
+                    arg_symbol = self.symbol_table.lookup(arg_node.id) if isinstance(arg_node, ast.Name) else None
+                    if arg_symbol and arg_symbol.immutable and arg_symbol.type.startswith('array['):
+                        raise TypeError(f"Immutable array '{arg_node.id}' cannot be passed to '{func_name}', which could modify it.")
                 
+                if func_symbol.is_comptime:
+                    self._evaluate_comptime_call(node, func_symbol)
                 return func_symbol.return_type
         elif isinstance(node.func, ast.Attribute):
             # Method call (e.g., obj.method())
             return self._visit_method_call(node)
+        elif isinstance(node.func, ast.Subscript):
+            # Typed allocation (e.g., arena_alloc[Node](arena))
+            return self._visit_typed_allocation(node)
         else:
             raise NotImplementedError("Only direct function calls and method calls are supported.")
 
+    def _comptime_argument(self, node):
+        """Value of a compile-time constant argument, or None."""
+        if isinstance(node, ast.Constant) and isinstance(node.value, (int, float)):
+            return node.value
+        if isinstance(node, ast.UnaryOp) and isinstance(node.op, (ast.USub, ast.UAdd)):
+            value = self._comptime_argument(node.operand)
+            if value is not None and not isinstance(value, bool):
+                return -value if isinstance(node.op, ast.USub) else value
+            return None
+        return getattr(node, 'comptime_value', None)
+
+    def _evaluate_comptime_call(self, node, func_symbol):
+        """
+        Sets Call.comptime_value when every argument is a constant. Scalar
+        results replace the call; array results may only initialize a local,
+        which becomes a static const table.
+        """
+        func_name = node.func.id
+        returns_array = func_symbol.return_type and func_symbol.return_type.startswith('array[')
+        args = [self._comptime_argument(arg) for arg in node.args]
+        if func_name in self.comptime_functions and all(arg is not None for arg in args):
+            try:
+                self.comptime.steps = 0
+                node.comptime_value = self.comptime.call(func_name, args)
+            except comptime.ComptimeError as e:
+                raise TypeError(f"Cannot evaluate {func_name}() at compile time: {e}")
+        if returns_array and not self.in_compile_time_only:
+            if getattr(node, 'comptime_value', None) is None:
+                raise TypeError(f"@comptime function '{func_name}' returns an array and must be called with constant arguments.")
+            if not (isinstance(node.parent, ast.AnnAssign) and node.parent.value is node):
+                raise TypeError(f"The array returned by @comptime function '{func_name}' can only initialize a variable declaration.")
+
+    def _visit_typed_allocation(self, node):
+        """arena_alloc[T](arena[, count]) -> ptr[T] and pool_new[T]() -> Pool[T]."""
+        func_name = getattr(node.func.value, 'id', None)
+        elem_type = type_name_of(node.func.slice)
+        if elem_type is None:
+            raise TypeError(f"{func_name}[...] expects a type.")
+        if func_name == 'arena_alloc':
+            if len(node.args) not in (1, 2):
+                raise TypeError("arena_alloc[T]() expects an arena and an optional count.")
+            arena_type = self.visit(node.args[0])
+            if arena_type != 'Arena':
+                raise TypeError(f"arena_alloc[T]() expects an Arena, but got {arena_type}.")
+            if len(node.args) == 2 and self.visit(node.args[1]) != 'int':
+                raise TypeError("arena_alloc[T]() count must be an int.")
+            return f'ptr[{elem_type}]'
+        elif func_name == 'pool_new':
+            if node.args:
+                raise TypeError("pool_new[T]() takes no arguments.")
+            return f'Pool[{elem_type}]'
+        raise NotImplementedError(f"'{func_name}' cannot be called with a type argument.")
+
+    def _pool_element_type(self, node, func_name):
+        """T for the Pool[T] passed as the first argument of a pool builtin."""
+        pool_type = self.visit(node.args[0]) if node.args else None
+        if not (isinstance(pool_type, str) and pool_type.startswith('Pool[')):
+            raise TypeError(f"{func_name}() expects a Pool, but got {pool_type}.")
+        return pool_type[5:-1]
+
     def _visit_method_call(self, node):
         """Handle method calls like obj.method() and module function calls like module.function()"""
         # Get the object being called
@@ -1014,7 +1675,10 @@ class SemanticAnalyzer(ast.NodeVisitor):
                     # Validate function call
                     if func_symbol.type != 'function':
                         raise TypeError(f"'{method_name}' in module '{obj_name}' is not a function.")
-                    
+                    if func_symbol.is_c_function:
+                        self._check_c_call(node, func_symbol, f'{obj_name}.{method_name}')
+                        return func_symbol.return_type
+
                     # Validate argument count and types
                     if len(node.args) != len(func_symbol.param_types):
                         raise TypeError(f"Function '{obj_name}.{method_name}' expects {len(func_symbol.param_types)} arguments, but got {len(node.args)}.")
@@ -1022,7 +1686,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
                     for i, arg_node in enumerate(node.args):
                         arg_type = self.visit(arg_node)
                         expected_type = func_symbol.param_types[i]
-                        if arg_type != expected_type:
+                        if not self._is_assignable(arg_type, expected_type):
                             raise TypeError(f"Argument {i+1} of function '{obj_name}.{method_name}' has type {arg_type}, but expected {expected_type}.")
                     
                     return func_symbol.return_type
@@ -1043,6 +1707,12 @@ class SemanticAnalyzer(ast.NodeVisitor):
         if not type_symbol.methods or method_name not in type_symbol.methods:
             raise AttributeError(f"Type '{obj_type}' has no method '{method_name}'.")
         
+        # Calls through an interface whose concrete struct is known bind statically
+        if type_symbol.type == 'interface' and isinstance(obj_node, ast.Name):
+            concrete_type = self.concrete_types.get(obj_node.id)
+            if concrete_type:
+                node.concrete_type = concrete_type
+        
         # Get method signature
         param_types, return_type = type_symbol.methods[method_name]
         
@@ -1053,7 +1723,7 @@ class SemanticAnalyzer(ast.NodeVisitor):
         for i, arg_node in enumerate(node.args):
             arg_type = self.visit(arg_node)
             expected_type = param_types[i]
-            if arg_type != expected_type:
+            if not self._is_assignable(arg_type, expected_type):
                 raise TypeError(f"Argument {i+1} of method '{method_name}' has type {arg_type}, but expected {expected_type}.")
         
         return return_type
@@ -1072,6 +1742,13 @@ class SemanticAnalyzer(ast.NodeVisitor):
                 return body[idx - 1].value.value
         return None
 
+    def visit(self, node):
+        result = super().visit(node)
+        if isinstance(node, ast.expr):
+            # Codegen picks print routines and string operations from this
+            node.pyr_type = result
+        return result
+
 class ParentageVisitor(ast.NodeVisitor):
     def visit(self, node):
         for child in ast.iter_child_nodes(node):
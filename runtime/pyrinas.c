@@ -1,105 +1,933 @@
+// Out-of-line definitions of the Result helpers; the program may use the
+// static inline copies from pyrinas.h instead
+#undef PYRINAS_INLINE_RUNTIME
+#define PYRINAS_RUNTIME_IMPL
 #include "pyrinas.h"
 #include <stdio.h>
 #include <stdlib.h>
 
-// Result utility functions
+void pyrinas_panic(const char* message) {
+    pyrinas_flush();  // Keep earlier program output ahead of the message
+    fprintf(stderr, "Error: %s\n", message);
+    exit(1);
+}
 
-bool is_ok(Result r) {
-    return r.type == OK;
+void pyrinas_panic_str(PyrStr message) {
+    pyrinas_flush();
+    fputs("Error: ", stderr);
+    fwrite(message.data, 1, message.length, stderr);
+    fputc('\n', stderr);
+    exit(1);
 }
 
-bool is_err(Result r) {
-    return r.type == ERR;
+void pyrinas_bounds_fail(long long index, long long size) {
+    pyrinas_flush();
+    fprintf(stderr, "Error: index %lld out of bounds for array of size %lld\n", index, size);
+    exit(1);
 }
 
-int unwrap_int(Result r) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: attempted to unwrap an Err result\n");
-        exit(1);
+// Floor division and modulo on floats
+
+#include <math.h>
+
+// Mirrors CPython's float_divmod
+static void float_divmod(double a, double b, double* floordiv, double* mod) {
+    double m = fmod(a, b);
+    double div = (a - m) / b;
+
+    if (m != 0.0) {
+        if ((b < 0) != (m < 0)) {
+            m += b;
+            div -= 1.0;
+        }
+    } else {
+        m = copysign(0.0, b);
+    }
+
+    if (div != 0.0) {
+        double floored = floor(div);
+        if (div - floored > 0.5) floored += 1.0;
+        div = floored;
+    } else {
+        div = copysign(0.0, a / b);
     }
-    return r.value.int_val;
+
+    *floordiv = div;
+    *mod = m;
+}
+
+float pyrinas_floordiv_float(float a, float b) {
+    double div, mod;
+    float_divmod(a, b, &div, &mod);
+    return (float)div;
+}
+
+float pyrinas_mod_float(float a, float b) {
+    double div, mod;
+    float_divmod(a, b, &div, &mod);
+    return (float)mod;
+}
+
+// Strings
+
+// Owned, NUL-terminated buffer for a string of the given length
+static PyrStr str_allocate(size_t length, char** data) {
+    *data = malloc(length + 1);
+    if (!*data) pyrinas_panic("out of memory for string");
+    (*data)[length] = '\0';
+    return (PyrStr){ *data, length, length + 1 };
+}
+
+int pyrinas_str_compare(PyrStr a, PyrStr b) {
+    size_t common = a.length < b.length ? a.length : b.length;
+    int order = common ? memcmp(a.data, b.data, common) : 0;
+    if (order != 0) return order;
+    return (a.length > b.length) - (a.length < b.length);
+}
+
+PyrStr pyrinas_str_concat(PyrStr a, PyrStr b) {
+    if (b.length == 0) return a;
+    if (a.length == 0) return b;
+    if (a.length > SIZE_MAX - 1 - b.length) pyrinas_panic("string too long");
+
+    char* data;
+    PyrStr result = str_allocate(a.length + b.length, &data);
+    memcpy(data, a.data, a.length);
+    memcpy(data + a.length, b.data, b.length);
+    return result;
+}
+
+static PyrStr str_copy(const char* value, size_t length) {
+    char* data;
+    PyrStr result = str_allocate(length, &data);
+    memcpy(data, value, length);
+    return result;
+}
+
+PyrStr pyrinas_str_from_int(long long value) {
+    char text[24];
+    int length = snprintf(text, sizeof(text), "%lld", value);
+    return str_copy(text, (size_t)length);
 }
 
-float unwrap_float(Result r) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: attempted to unwrap an Err result\n");
-        exit(1);
+PyrStr pyrinas_str_from_float(double value) {
+    char text[512];
+    int length = snprintf(text, sizeof(text), "%f", value);
+    return str_copy(text, (size_t)length < sizeof(text) ? (size_t)length : sizeof(text) - 1);
+}
+
+PyrStr pyrinas_str_terminated(PyrStr s) {
+    if (s.length == 0) return PYRINAS_STR("");
+    if (s.data[s.length] == '\0') return (PyrStr){ s.data, s.length, 0 };
+    return str_copy(s.data, s.length);
+}
+
+void pyrinas_str_release(PyrStr copy, PyrStr* result) {
+    if (!copy.capacity) return;
+    if (result && result->data >= copy.data && result->data <= copy.data + copy.length) {
+        *result = str_copy(result->data, result->length);
     }
-    return r.value.float_val;
+    free((char*)copy.data);
+}
+
+void pyrinas_str_free(PyrStr s) {
+    if (s.capacity) free((char*)s.data);
 }
 
-char* unwrap_str(Result r) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: attempted to unwrap an Err result\n");
-        exit(1);
+PyrStrBuilder* pyrinas_str_builder_new(size_t capacity) {
+    PyrStrBuilder* builder = malloc(sizeof(PyrStrBuilder));
+    if (!builder) pyrinas_panic("out of memory for string builder");
+    builder->capacity = capacity ? capacity : 64;
+    builder->length = 0;
+    builder->data = malloc(builder->capacity);
+    if (!builder->data) pyrinas_panic("out of memory for string builder");
+    return builder;
+}
+
+void pyrinas_str_builder_append(PyrStrBuilder* builder, PyrStr s) {
+    // Keep one byte spare for the terminator added by finish
+    if (s.length >= builder->capacity - builder->length) {
+        if (s.length > SIZE_MAX / 2 - builder->length) pyrinas_panic("string too long");
+        size_t capacity = builder->capacity * 2;
+        if (capacity <= builder->length + s.length) capacity = builder->length + s.length + 1;
+        char* data = realloc(builder->data, capacity);
+        if (!data) pyrinas_panic("out of memory for string builder");
+        builder->data = data;
+        builder->capacity = capacity;
     }
-    return r.value.str_val;
+    if (s.length) memcpy(builder->data + builder->length, s.data, s.length);
+    builder->length += s.length;
+}
+
+PyrStr pyrinas_str_builder_finish(PyrStrBuilder* builder) {
+    builder->data[builder->length] = '\0';
+    PyrStr result = { builder->data, builder->length, builder->capacity };
+    free(builder);
+    return result;
 }
 
-void* unwrap_ptr(Result r) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: attempted to unwrap an Err result\n");
-        exit(1);
+// Buffered output
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PYRINAS_OUTPUT_BUFFER 8192
+
+typedef struct {
+    size_t length;
+    char data[PYRINAS_OUTPUT_BUFFER];
+} OutputBuffer;
+
+static _Thread_local OutputBuffer* thread_output;
+static pthread_key_t output_key;
+static pthread_once_t output_once = PTHREAD_ONCE_INIT;
+
+static void output_write(OutputBuffer* buffer) {
+    fflush(stdout);
+    size_t written = 0;
+    while (written < buffer->length) {
+        ssize_t n = write(STDOUT_FILENO, buffer->data + written, buffer->length - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        written += (size_t)n;
     }
-    return r.value.ptr_val;
+    buffer->length = 0;
+}
+
+// Runs when a thread that printed exits
+static void output_release(void* buffer) {
+    output_write(buffer);
+    free(buffer);
+}
+
+// Exit does not run thread destructors for the exiting thread
+static void output_flush_at_exit(void) {
+    if (thread_output) output_write(thread_output);
+}
+
+static void output_init(void) {
+    pthread_key_create(&output_key, output_release);
+    atexit(output_flush_at_exit);
+}
+
+static OutputBuffer* output_buffer(void) {
+    if (PYRINAS_LIKELY(thread_output != NULL)) return thread_output;
+    pthread_once(&output_once, output_init);
+    OutputBuffer* buffer = malloc(sizeof(OutputBuffer));
+    if (!buffer) pyrinas_panic("out of memory for output buffer");
+    buffer->length = 0;
+    pthread_setspecific(output_key, buffer);
+    thread_output = buffer;
+    return buffer;
 }
 
-int unwrap_or_int(Result r, int default_val) {
-    if (r.type == ERR) {
-        return default_val;
+static void output_append(const char* data, size_t length) {
+    OutputBuffer* buffer = output_buffer();
+    while (length > 0) {
+        if (buffer->length == PYRINAS_OUTPUT_BUFFER) output_write(buffer);
+        size_t chunk = PYRINAS_OUTPUT_BUFFER - buffer->length;
+        if (chunk > length) chunk = length;
+        memcpy(buffer->data + buffer->length, data, chunk);
+        buffer->length += chunk;
+        data += chunk;
+        length -= chunk;
     }
-    return r.value.int_val;
 }
 
-float unwrap_or_float(Result r, float default_val) {
-    if (r.type == ERR) {
-        return default_val;
+void pyrinas_write_int(long long value) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    // Negate through unsigned so LLONG_MIN works
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    output_append(p, (size_t)(end - p));
+}
+
+void pyrinas_write_float(double value) {
+    char text[512];
+    int length = snprintf(text, sizeof(text), "%f", value);
+    if (length > 0) output_append(text, (size_t)length < sizeof(text) ? (size_t)length : sizeof(text) - 1);
+}
+
+void pyrinas_write_str(PyrStr value) {
+    output_append(value.data, value.length);
+}
+
+void pyrinas_write_cstr(const char* value) {
+    if (!value) value = "(null)";
+    output_append(value, strlen(value));
+}
+
+void pyrinas_write_char(char value) {
+    OutputBuffer* buffer = output_buffer();
+    if (buffer->length == PYRINAS_OUTPUT_BUFFER) output_write(buffer);
+    buffer->data[buffer->length++] = value;
+}
+
+void pyrinas_write_ptr(const void* value) {
+    char text[32];
+    int length = snprintf(text, sizeof(text), "%p", value);
+    if (length > 0) output_append(text, (size_t)length);
+}
+
+void pyrinas_flush(void) {
+    if (thread_output) output_write(thread_output);
+}
+
+// Work-stealing scheduler
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+struct PyrinasTask {
+    void (*fn)(void* data);
+    atomic_bool done;
+    max_align_t data[];  // Copy of the spawn arguments
+};
+
+// Circular buffer of a deque; replaced by one twice the size when full
+typedef struct TaskBuffer {
+    int64_t mask;  // Capacity - 1 (capacity is a power of two)
+    struct TaskBuffer* previous;  // Retired buffers, freed with the deque
+    _Atomic(PyrinasTask*) items[];
+} TaskBuffer;
+
+// Chase-Lev deque (C11 formulation by Le, Pop, Cohen and Zappa Nardelli)
+typedef struct {
+    _Alignas(64) atomic_int_fast64_t top;
+    _Alignas(64) atomic_int_fast64_t bottom;
+    _Atomic(TaskBuffer*) buffer;
+} TaskDeque;
+
+typedef struct {
+    TaskDeque deque;
+    uint32_t seed;  // Xorshift state for victim selection
+    pthread_t thread;
+} Worker;
+
+static struct {
+    Worker* workers;
+    int size;
+    atomic_bool running;
+    atomic_int queued;    // Tasks in any deque
+    atomic_int sleeping;  // Workers waiting on `wake`
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+} pool = {.lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER};
+
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static int pool_requested_size;
+static _Thread_local Worker* current_worker;
+
+static TaskBuffer* task_buffer_new(int64_t capacity) {
+    TaskBuffer* buffer = malloc(sizeof(TaskBuffer) + sizeof(_Atomic(PyrinasTask*)) * (size_t)capacity);
+    if (!buffer) pyrinas_panic("out of memory in task scheduler");
+    buffer->mask = capacity - 1;
+    buffer->previous = NULL;
+    return buffer;
+}
+
+static void task_deque_init(TaskDeque* deque) {
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->buffer, task_buffer_new(256));
+}
+
+static void task_deque_destroy(TaskDeque* deque) {
+    TaskBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    while (buffer) {
+        TaskBuffer* previous = buffer->previous;
+        free(buffer);
+        buffer = previous;
     }
-    return r.value.float_val;
 }
 
-char* unwrap_or_str(Result r, char* default_val) {
-    if (r.type == ERR) {
-        return default_val;
+// Owner only
+static TaskBuffer* task_deque_grow(TaskDeque* deque, TaskBuffer* old, int64_t top, int64_t bottom) {
+    TaskBuffer* buffer = task_buffer_new((old->mask + 1) * 2);
+    for (int64_t i = top; i < bottom; i++) {
+        PyrinasTask* task = atomic_load_explicit(&old->items[i & old->mask], memory_order_relaxed);
+        atomic_store_explicit(&buffer->items[i & buffer->mask], task, memory_order_relaxed);
     }
-    return r.value.str_val;
+    // Thieves may still read the old buffer, so it is retired rather than freed
+    buffer->previous = old;
+    atomic_store_explicit(&deque->buffer, buffer, memory_order_release);
+    return buffer;
 }
 
-void* unwrap_or_ptr(Result r, void* default_val) {
-    if (r.type == ERR) {
-        return default_val;
+// Owner only
+static void task_deque_push(TaskDeque* deque, PyrinasTask* task) {
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    TaskBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    if (bottom - top > buffer->mask) buffer = task_deque_grow(deque, buffer, top, bottom);
+    atomic_store_explicit(&buffer->items[bottom & buffer->mask], task, memory_order_relaxed);
+    // Publishes the task to thieves, which load `bottom` with acquire
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+}
+
+// Owner only; takes the most recently pushed task
+static PyrinasTask* task_deque_pop(TaskDeque* deque) {
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    TaskBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+    PyrinasTask* task = atomic_load_explicit(&buffer->items[bottom & buffer->mask], memory_order_relaxed);
+    if (top == bottom) {
+        // Last task: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                     memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+// Any thread; takes the oldest task
+static PyrinasTask* task_deque_steal(TaskDeque* deque) {
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) return NULL;
+
+    TaskBuffer* buffer = atomic_load_explicit(&deque->buffer, memory_order_acquire);
+    PyrinasTask* task = atomic_load_explicit(&buffer->items[top & buffer->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL;
     }
-    return r.value.ptr_val;
+    return task;
 }
 
-int expect_int(Result r, char* message) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: %s\n", message);
-        exit(1);
+// A thread writes out what it printed before handing work to another thread
+// and before a task counts as done, so text appears in the order the
+// spawns and joins put it
+static void run_task(PyrinasTask* task) {
+    atomic_fetch_sub_explicit(&pool.queued, 1, memory_order_relaxed);
+    task->fn(task->data);
+    pyrinas_flush();
+    atomic_store_explicit(&task->done, true, memory_order_release);
+}
+
+// Own deque first, then one pass over the others from a random victim
+static PyrinasTask* find_task(Worker* self) {
+    PyrinasTask* task = task_deque_pop(&self->deque);
+    if (task || pool.size == 1) return task;
+
+    self->seed ^= self->seed << 13;
+    self->seed ^= self->seed >> 17;
+    self->seed ^= self->seed << 5;
+    int start = (int)(self->seed % (uint32_t)pool.size);
+    for (int i = 0; i < pool.size && !task; i++) {
+        Worker* victim = &pool.workers[(start + i) % pool.size];
+        if (victim != self) task = task_deque_steal(&victim->deque);
     }
-    return r.value.int_val;
+    return task;
 }
 
-float expect_float(Result r, char* message) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: %s\n", message);
-        exit(1);
+static void* worker_main(void* arg) {
+    Worker* self = arg;
+    current_worker = self;
+
+    while (atomic_load_explicit(&pool.running, memory_order_acquire)) {
+        PyrinasTask* task = find_task(self);
+        if (task) {
+            run_task(task);
+            continue;
+        }
+
+        // Sleep until a spawn makes work available. `sleeping` is raised
+        // before `queued` is checked and spawns raise `queued` before
+        // checking `sleeping`, so a wakeup cannot be missed.
+        pthread_mutex_lock(&pool.lock);
+        atomic_fetch_add(&pool.sleeping, 1);
+        while (atomic_load(&pool.queued) == 0 && atomic_load(&pool.running)) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        atomic_fetch_sub(&pool.sleeping, 1);
+        pthread_mutex_unlock(&pool.lock);
     }
-    return r.value.float_val;
+    return NULL;
+}
+
+static void pool_shutdown(void) {
+    pthread_mutex_lock(&pool.lock);
+    atomic_store(&pool.running, false);
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (int i = 1; i < pool.size; i++) pthread_join(pool.workers[i].thread, NULL);
+    for (int i = 0; i < pool.size; i++) task_deque_destroy(&pool.workers[i].deque);
+    free(pool.workers);
+    pool.workers = NULL;
+}
+
+static void pool_start(void) {
+    int size = pool_requested_size;
+    const char* env = getenv("PYRINAS_NUM_THREADS");
+    if (size <= 0 && env) size = atoi(env);
+    if (size <= 0) size = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (size <= 0) size = 1;
+
+    pool.workers = calloc((size_t)size, sizeof(Worker));
+    if (!pool.workers) pyrinas_panic("out of memory in task scheduler");
+    pool.size = size;
+    atomic_init(&pool.queued, 0);
+    atomic_init(&pool.sleeping, 0);
+    atomic_init(&pool.running, true);
+
+    for (int i = 0; i < size; i++) {
+        task_deque_init(&pool.workers[i].deque);
+        pool.workers[i].seed = (uint32_t)i * 2654435761u + 1;
+    }
+    current_worker = &pool.workers[0];
+    for (int i = 1; i < size; i++) {
+        if (pthread_create(&pool.workers[i].thread, NULL, worker_main, &pool.workers[i]) != 0) {
+            pyrinas_panic("cannot start task scheduler thread");
+        }
+    }
+    atexit(pool_shutdown);
+}
+
+void pyrinas_pool_init(int threads) {
+    pool_requested_size = threads;
+    pthread_once(&pool_once, pool_start);
+}
+
+int pyrinas_pool_size(void) {
+    pthread_once(&pool_once, pool_start);
+    return pool.size;
+}
+
+int pyrinas_worker_index(void) {
+    pthread_once(&pool_once, pool_start);
+    return current_worker ? (int)(current_worker - pool.workers) : pool.size;
+}
+
+PyrinasTask* pyrinas_spawn(void (*fn)(void* data), const void* data, size_t size) {
+    pthread_once(&pool_once, pool_start);
+    pyrinas_flush();
+
+    PyrinasTask* task = malloc(sizeof(PyrinasTask) + size);
+    if (!task) pyrinas_panic("out of memory in task scheduler");
+    task->fn = fn;
+    atomic_init(&task->done, false);
+    if (size > 0) memcpy(task->data, data, size);
+
+    Worker* self = current_worker;
+    if (!self) {
+        // Not a pool thread: run it here
+        atomic_fetch_add_explicit(&pool.queued, 1, memory_order_relaxed);
+        run_task(task);
+        return task;
+    }
+
+    atomic_fetch_add(&pool.queued, 1);
+    task_deque_push(&self->deque, task);
+    if (atomic_load(&pool.sleeping) > 0) {
+        pthread_mutex_lock(&pool.lock);
+        pthread_cond_signal(&pool.wake);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    return task;
+}
+
+void pyrinas_join(PyrinasTask* task, void* out, size_t size) {
+    Worker* self = current_worker;
+    // Help with other work instead of blocking
+    while (!atomic_load_explicit(&task->done, memory_order_acquire)) {
+        PyrinasTask* other = self ? find_task(self) : NULL;
+        if (other) {
+            run_task(other);
+        } else {
+            sched_yield();
+        }
+    }
+    if (out && size > 0) memcpy(out, task->data, size);
+    free(task);
+}
+
+typedef struct {
+    int start;
+    int end;
+    int grain;
+    void (*body)(int begin, int end, void* ctx);
+    void* ctx;
+} RangeJob;
+
+// Splits the range in half, spawning the right half, down to one grain
+static void run_range(void* data) {
+    RangeJob job = *(RangeJob*)data;
+    if (job.end - job.start <= job.grain) {
+        job.body(job.start, job.end, job.ctx);
+        return;
+    }
+    RangeJob right = job;
+    right.start = job.start + (job.end - job.start) / 2;
+    PyrinasTask* task = pyrinas_spawn(run_range, &right, sizeof(right));
+    job.end = right.start;
+    run_range(&job);
+    pyrinas_join(task, NULL, 0);
+}
+
+void pyrinas_parallel_for(int start, int end, int grain,
+                          void (*body)(int begin, int end, void* ctx), void* ctx) {
+    if (start >= end) return;
+    pyrinas_flush();
+    if (grain <= 0) {
+        // About eight chunks per worker balances load against task overhead
+        grain = (end - start) / (8 * pyrinas_pool_size());
+        if (grain < 1) grain = 1;
+    }
+    RangeJob job = {start, end, grain, body, ctx};
+    run_range(&job);
+}
+
+typedef struct {
+    void (*body)(int i);
+} EachJob;
+
+static void run_each(int begin, int end, void* ctx) {
+    EachJob* job = ctx;
+    for (int i = begin; i < end; i++) job->body(i);
+}
+
+void pyrinas_parallel_for_each(int n, void (*body)(int i)) {
+    EachJob job = {body};
+    pyrinas_parallel_for(0, n, 0, run_each, &job);
+}
+
+// Region allocator
+
+struct PyrinasArenaBlock {
+    PyrinasArenaBlock* next;
+    size_t size;
+    max_align_t data[];
+};
+
+#define PYRINAS_ARENA_DEFAULT_BLOCK (64 * 1024)
+
+static PyrinasArenaBlock* arena_block_new(size_t size) {
+    PyrinasArenaBlock* block = malloc(sizeof(PyrinasArenaBlock) + size);
+    if (!block) pyrinas_panic("out of memory in arena");
+    block->next = NULL;
+    block->size = size;
+    return block;
+}
+
+static void arena_enter(PyrinasArena* arena, PyrinasArenaBlock* block) {
+    arena->current = block;
+    arena->cursor = (char*)block->data;
+    arena->limit = (char*)block->data + block->size;
+}
+
+PyrinasArena* pyrinas_arena_new(size_t block_size) {
+    PyrinasArena* arena = malloc(sizeof(PyrinasArena));
+    if (!arena) pyrinas_panic("out of memory in arena");
+    arena->block_size = block_size ? block_size : PYRINAS_ARENA_DEFAULT_BLOCK;
+    arena->blocks = arena_block_new(arena->block_size);
+    arena_enter(arena, arena->blocks);
+    return arena;
+}
+
+void* pyrinas_arena_alloc_slow(PyrinasArena* arena, size_t size, size_t align) {
+    if (size > SIZE_MAX - align) pyrinas_panic("arena allocation too large");
+    size_t needed = size + align;
+
+    // Reuse the next block kept by a reset if it is big enough, otherwise
+    // link a new one in after the current block
+    PyrinasArenaBlock* next = arena->current->next;
+    if (!next || next->size < needed) {
+        PyrinasArenaBlock* block = arena_block_new(needed > arena->block_size ? needed : arena->block_size);
+        block->next = next;
+        arena->current->next = block;
+        next = block;
+    }
+    arena_enter(arena, next);
+    return pyrinas_arena_alloc(arena, size, align);
+}
+
+void* pyrinas_arena_alloc_array(PyrinasArena* arena, int count, size_t size, size_t align) {
+    if (count < 0 || (size && (size_t)count > SIZE_MAX / size)) pyrinas_panic("invalid arena array size");
+    return pyrinas_arena_alloc(arena, (size_t)count * size, align);
+}
+
+void pyrinas_arena_reset(PyrinasArena* arena) {
+    arena_enter(arena, arena->blocks);
+}
+
+void pyrinas_arena_free(PyrinasArena* arena) {
+    PyrinasArenaBlock* block = arena->blocks;
+    while (block) {
+        PyrinasArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+PyrinasObjectPool* pyrinas_object_pool_new(size_t object_size, size_t align) {
+    PyrinasObjectPool* pool = malloc(sizeof(PyrinasObjectPool));
+    if (!pool) pyrinas_panic("out of memory in object pool");
+    // Free objects hold the free-list link
+    if (object_size < sizeof(void*)) object_size = sizeof(void*);
+    if (align < _Alignof(void*)) align = _Alignof(void*);
+    object_size = (object_size + align - 1) & ~(align - 1);
+
+    pool->free_list = NULL;
+    pool->object_size = object_size;
+    pool->align = align;
+    pool->arena = pyrinas_arena_new(0);
+    return pool;
+}
+
+void pyrinas_object_pool_free(PyrinasObjectPool* pool) {
+    pyrinas_arena_free(pool->arena);
+    free(pool);
+}
+
+// Function profiler
+
+#include <pthread.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define PROFILE_RING_SIZE 16384  // Calls kept per thread for the trace
+
+typedef struct {
+    uint64_t calls;
+    uint64_t inclusive;  // Outermost activations only, so recursion is not counted twice
+    uint64_t exclusive;
+    int active;          // Activations on this thread's stack
+} ProfileStats;
+
+typedef struct {
+    int site;
+    uint64_t start;
+    uint64_t end;
+} ProfileEvent;
+
+// Owned by one thread, and kept after it exits so the report can read it
+typedef struct ProfileThread {
+    struct ProfileThread* next;
+    int index;
+    PyrinasProfileFrame* current;
+    ProfileStats* stats;  // By site id
+    int capacity;
+    ProfileEvent* ring;   // NULL unless tracing
+    uint64_t events;      // Calls recorded, including overwritten ones
+} ProfileThread;
+
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t profile_once = PTHREAD_ONCE_INIT;
+static _Thread_local ProfileThread* profile_thread;
+static ProfileThread* profile_threads;
+static int profile_thread_count;
+static PyrinasProfileSite** profile_sites;  // By id; 0 is unused
+static int profile_site_count;
+static int profile_site_capacity;
+static const char* profile_trace_path;
+static uint64_t profile_start_ticks;
+static struct timespec profile_start_time;
+
+static inline uint64_t profile_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Nanoseconds per tick, measured over the whole run
+static double profile_tick_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t ticks = profile_ticks() - profile_start_ticks;
+    double ns = (double)(now.tv_sec - profile_start_time.tv_sec) * 1e9 +
+                (double)(now.tv_nsec - profile_start_time.tv_nsec);
+    return ticks > 0 && ns > 0 ? ns / (double)ticks : 1.0;
+}
+
+typedef struct {
+    int site;
+    ProfileStats total;
+} ProfileRow;
+
+static int profile_compare_exclusive(const void* a, const void* b) {
+    uint64_t x = ((const ProfileRow*)a)->total.exclusive;
+    uint64_t y = ((const ProfileRow*)b)->total.exclusive;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+static void profile_write_trace(double tick_ns) {
+    FILE* out = fopen(profile_trace_path, "w");
+    if (!out) {
+        fprintf(stderr, "Error: cannot write profile trace '%s'\n", profile_trace_path);
+        return;
+    }
+    fputs("{\"traceEvents\": [", out);
+    bool first = true;
+    for (ProfileThread* thread = profile_threads; thread; thread = thread->next) {
+        uint64_t kept = thread->events < PROFILE_RING_SIZE ? thread->events : PROFILE_RING_SIZE;
+        for (uint64_t i = thread->events - kept; i < thread->events; i++) {
+            ProfileEvent* event = &thread->ring[i % PROFILE_RING_SIZE];
+            PyrinasProfileSite* site = profile_sites[event->site];
+            fprintf(out, "%s\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                    "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"file\": \"%s\", \"line\": %d}}",
+                    first ? "" : ",", site->name, thread->index,
+                    (double)(event->start - profile_start_ticks) * tick_ns / 1000.0,
+                    (double)(event->end - event->start) * tick_ns / 1000.0, site->file, site->line);
+            first = false;
+        }
+    }
+    fputs("\n]}\n", out);
+    fclose(out);
+}
+
+// Covers the calls that have returned; threads still running are read as they are
+static void profile_report(void) {
+    pthread_mutex_lock(&profile_lock);
+    double tick_ns = profile_tick_ns();
+    ProfileRow* rows = calloc((size_t)profile_site_count + 1, sizeof(ProfileRow));
+    if (!rows) {
+        pthread_mutex_unlock(&profile_lock);
+        return;
+    }
+    for (int i = 0; i < profile_site_count; i++) {
+        rows[i].site = i + 1;
+        for (ProfileThread* thread = profile_threads; thread; thread = thread->next) {
+            if (i + 1 >= thread->capacity) continue;
+            rows[i].total.calls += thread->stats[i + 1].calls;
+            rows[i].total.inclusive += thread->stats[i + 1].inclusive;
+            rows[i].total.exclusive += thread->stats[i + 1].exclusive;
+        }
+    }
+    qsort(rows, (size_t)profile_site_count, sizeof(ProfileRow), profile_compare_exclusive);
+
+    pyrinas_flush();
+    fprintf(stderr, "\nProfile (%d thread%s, times in ms)\n", profile_thread_count,
+            profile_thread_count == 1 ? "" : "s");
+    fprintf(stderr, "%12s %14s %14s  %s\n", "calls", "inclusive", "exclusive", "function");
+    for (int i = 0; i < profile_site_count; i++) {
+        PyrinasProfileSite* site = profile_sites[rows[i].site];
+        fprintf(stderr, "%12llu %14.3f %14.3f  %s (%s:%d)\n", (unsigned long long)rows[i].total.calls,
+                (double)rows[i].total.inclusive * tick_ns / 1e6, (double)rows[i].total.exclusive * tick_ns / 1e6,
+                site->name, site->file, site->line);
+    }
+    free(rows);
+    if (profile_trace_path) profile_write_trace(tick_ns);
+    pthread_mutex_unlock(&profile_lock);
+}
+
+static void profile_init(void) {
+    profile_trace_path = getenv("PYRINAS_PROFILE_TRACE");
+    if (profile_trace_path && !*profile_trace_path) profile_trace_path = NULL;
+    clock_gettime(CLOCK_MONOTONIC, &profile_start_time);
+    profile_start_ticks = profile_ticks();
+    atexit(profile_report);
+}
+
+static ProfileThread* profile_thread_new(void) {
+    ProfileThread* thread = calloc(1, sizeof(ProfileThread));
+    if (!thread) pyrinas_panic("out of memory in the profiler");
+    if (profile_trace_path) {
+        thread->ring = malloc(PROFILE_RING_SIZE * sizeof(ProfileEvent));
+        if (!thread->ring) pyrinas_panic("out of memory in the profiler");
+    }
+    pthread_mutex_lock(&profile_lock);
+    thread->index = profile_thread_count++;
+    thread->next = profile_threads;
+    profile_threads = thread;
+    pthread_mutex_unlock(&profile_lock);
+    return thread;
+}
+
+static int profile_register(PyrinasProfileSite* site) {
+    pthread_mutex_lock(&profile_lock);
+    int id = site->id;
+    if (!id) {
+        if (profile_site_count + 1 >= profile_site_capacity) {
+            int capacity = profile_site_capacity ? profile_site_capacity * 2 : 64;
+            PyrinasProfileSite** sites = realloc(profile_sites, (size_t)capacity * sizeof(*sites));
+            if (!sites) pyrinas_panic("out of memory in the profiler");
+            profile_sites = sites;
+            profile_site_capacity = capacity;
+        }
+        id = ++profile_site_count;
+        profile_sites[id] = site;
+        __atomic_store_n(&site->id, id, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&profile_lock);
+    return id;
+}
+
+static void profile_grow(ProfileThread* thread, int id) {
+    int capacity = thread->capacity ? thread->capacity : 64;
+    while (capacity <= id) capacity *= 2;
+    // Resized under the lock, since the report may be reading the table
+    pthread_mutex_lock(&profile_lock);
+    ProfileStats* stats = realloc(thread->stats, (size_t)capacity * sizeof(ProfileStats));
+    if (!stats) pyrinas_panic("out of memory in the profiler");
+    memset(stats + thread->capacity, 0, (size_t)(capacity - thread->capacity) * sizeof(ProfileStats));
+    thread->stats = stats;
+    thread->capacity = capacity;
+    pthread_mutex_unlock(&profile_lock);
 }
 
-char* expect_str(Result r, char* message) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: %s\n", message);
-        exit(1);
+void pyrinas_profile_enter(PyrinasProfileFrame* frame, PyrinasProfileSite* site) {
+    ProfileThread* thread = profile_thread;
+    if (PYRINAS_UNLIKELY(!thread)) {
+        pthread_once(&profile_once, profile_init);
+        thread = profile_thread = profile_thread_new();
     }
-    return r.value.str_val;
+    int id = __atomic_load_n(&site->id, __ATOMIC_ACQUIRE);
+    if (PYRINAS_UNLIKELY(!id)) id = profile_register(site);
+    if (PYRINAS_UNLIKELY(id >= thread->capacity)) profile_grow(thread, id);
+    thread->stats[id].active++;
+    frame->parent = thread->current;
+    frame->site = site;
+    frame->children = 0;
+    thread->current = frame;
+    frame->start = profile_ticks();
 }
 
-void* expect_ptr(Result r, char* message) {
-    if (r.type == ERR) {
-        fprintf(stderr, "Error: %s\n", message);
-        exit(1);
+void pyrinas_profile_exit(PyrinasProfileFrame* frame) {
+    uint64_t end = profile_ticks();
+    ProfileThread* thread = profile_thread;
+    uint64_t elapsed = end - frame->start;
+    ProfileStats* stats = &thread->stats[frame->site->id];
+    stats->calls++;
+    stats->exclusive += elapsed - frame->children;
+    if (--stats->active == 0) stats->inclusive += elapsed;
+    if (frame->parent) frame->parent->children += elapsed;
+    thread->current = frame->parent;
+    if (thread->ring) {
+        ProfileEvent* event = &thread->ring[thread->events++ % PROFILE_RING_SIZE];
+        event->site = frame->site->id;
+        event->start = frame->start;
+        event->end = end;
     }
-    return r.value.ptr_val;
 }
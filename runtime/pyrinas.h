@@ -3,7 +3,74 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Length-prefixed string, the C type of Pyrinas `str`. data always points
+// into a NUL-terminated buffer, so data[length] is readable; slices share
+// their parent's buffer. capacity is nonzero only for strings that own a
+// heap buffer (concatenations, builder results, conversions), which
+// pyrinas_str_free releases. Literals, slices and C strings are borrowed.
+typedef struct {
+    const char* data;
+    size_t length;
+    size_t capacity;
+} PyrStr;
+
+#define PYRINAS_STR(literal) ((PyrStr){ "" literal, sizeof(literal) - 1, 0 })
+
+// Growable buffer for building a string with amortized appends
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} PyrStrBuilder;
+
+// Borrows a NUL-terminated C string; NULL becomes the empty string
+static inline PyrStr pyrinas_str_from_cstr(const char* value) {
+    if (!value) value = "";
+    return (PyrStr){ value, strlen(value), 0 };
+}
+
+// Python-style s[start:end]: negative bounds count from the end and are
+// clamped to the string. Shares s's buffer.
+static inline PyrStr pyrinas_str_slice(PyrStr s, long long start, long long end) {
+    long long length = (long long)s.length;
+    if (start < 0) start += length;
+    if (end < 0) end += length;
+    if (start < 0) start = 0;
+    if (end > length) end = length;
+    if (end <= start) return (PyrStr){ s.data ? s.data + s.length : "", 0, 0 };
+    return (PyrStr){ s.data + start, (size_t)(end - start), 0 };
+}
+
+static inline bool pyrinas_str_eq(PyrStr a, PyrStr b) {
+    return a.length == b.length && (a.length == 0 || memcmp(a.data, b.data, a.length) == 0);
+}
+
+// <0, 0 or >0, comparing bytes like strcmp
+int pyrinas_str_compare(PyrStr a, PyrStr b);
+
+// New owned string; returns the other operand unchanged when one is empty
+PyrStr pyrinas_str_concat(PyrStr a, PyrStr b);
+PyrStr pyrinas_str_from_int(long long value);
+PyrStr pyrinas_str_from_float(double value);  // Formatted like printf("%f")
+
+// NUL-terminated string for C interop: s, borrowed, when s.data is already
+// terminated, else an owned copy. pyrinas_str_release frees the copy after
+// the call, first copying out a C result that points into it.
+PyrStr pyrinas_str_terminated(PyrStr s);
+void pyrinas_str_release(PyrStr copy, PyrStr* result);
+
+void pyrinas_str_free(PyrStr s);
+
+PyrStrBuilder* pyrinas_str_builder_new(size_t capacity);
+void pyrinas_str_builder_append(PyrStrBuilder* builder, PyrStr s);
+// Returns the built string (owned) and frees the builder
+PyrStr pyrinas_str_builder_finish(PyrStrBuilder* builder);
 
 // Generic Result type for error handling
 typedef enum {
@@ -15,7 +82,7 @@ typedef enum {
 typedef union {
     int int_val;
     float float_val;
-    char* str_val;
+    PyrStr str_val;
     void* ptr_val;
 } Value;
 
@@ -24,20 +91,278 @@ typedef struct {
     Value value;
 } Result;
 
+// Branch hints and attributes
+#if defined(__GNUC__) || defined(__clang__)
+#define PYRINAS_LIKELY(x) __builtin_expect(!!(x), 1)
+#define PYRINAS_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define PYRINAS_COLD __attribute__((cold, noinline, noreturn))
+#else
+#define PYRINAS_LIKELY(x) (x)
+#define PYRINAS_UNLIKELY(x) (x)
+#define PYRINAS_COLD
+#endif
+
+// Prints "Error: <message>" and exits; kept out of line so the error path
+// does not bloat callers
+PYRINAS_COLD void pyrinas_panic(const char* message);
+PYRINAS_COLD void pyrinas_panic_str(PyrStr message);
+
+// Array index check inserted by --bounds-check; yields the index
+PYRINAS_COLD void pyrinas_bounds_fail(long long index, long long size);
+
+static inline int pyrinas_check_index(long long index, long long size) {
+    if (PYRINAS_UNLIKELY(index < 0 || index >= size)) pyrinas_bounds_fail(index, size);
+    return (int)index;
+}
+
+// Python's // and %: the quotient rounds toward negative infinity and the
+// remainder takes the sign of the divisor
+static inline int pyrinas_floordiv(int a, int b) {
+    int quotient = a / b;
+    if (a % b != 0 && (a < 0) != (b < 0)) quotient--;
+    return quotient;
+}
+
+static inline int pyrinas_mod(int a, int b) {
+    int remainder = a % b;
+    if (remainder != 0 && (remainder < 0) != (b < 0)) remainder += b;
+    return remainder;
+}
+
+// Out of line so that this header does not pull in <math.h>
+float pyrinas_floordiv_float(float a, float b);
+float pyrinas_mod_float(float a, float b);
+
+// Result utility functions. With PYRINAS_INLINE_RUNTIME defined they are
+// static inline here; otherwise they are declared here and defined once in
+// pyrinas.c (which defines PYRINAS_RUNTIME_IMPL).
+#if defined(PYRINAS_INLINE_RUNTIME) || defined(PYRINAS_RUNTIME_IMPL)
+
+#ifdef PYRINAS_INLINE_RUNTIME
+#define PYRINAS_RESULT_API static inline
+#else
+#define PYRINAS_RESULT_API
+#endif
+
+PYRINAS_RESULT_API bool is_ok(Result r) {
+    return r.type == OK;
+}
+
+PYRINAS_RESULT_API bool is_err(Result r) {
+    return r.type == ERR;
+}
+
+PYRINAS_RESULT_API int unwrap_int(Result r) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic("attempted to unwrap an Err result");
+    return r.value.int_val;
+}
+
+PYRINAS_RESULT_API float unwrap_float(Result r) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic("attempted to unwrap an Err result");
+    return r.value.float_val;
+}
+
+PYRINAS_RESULT_API PyrStr unwrap_str(Result r) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic("attempted to unwrap an Err result");
+    return r.value.str_val;
+}
+
+PYRINAS_RESULT_API void* unwrap_ptr(Result r) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic("attempted to unwrap an Err result");
+    return r.value.ptr_val;
+}
+
+PYRINAS_RESULT_API int unwrap_or_int(Result r, int default_val) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) return default_val;
+    return r.value.int_val;
+}
+
+PYRINAS_RESULT_API float unwrap_or_float(Result r, float default_val) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) return default_val;
+    return r.value.float_val;
+}
+
+PYRINAS_RESULT_API PyrStr unwrap_or_str(Result r, PyrStr default_val) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) return default_val;
+    return r.value.str_val;
+}
+
+PYRINAS_RESULT_API void* unwrap_or_ptr(Result r, void* default_val) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) return default_val;
+    return r.value.ptr_val;
+}
+
+PYRINAS_RESULT_API int expect_int(Result r, PyrStr message) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic_str(message);
+    return r.value.int_val;
+}
+
+PYRINAS_RESULT_API float expect_float(Result r, PyrStr message) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic_str(message);
+    return r.value.float_val;
+}
+
+PYRINAS_RESULT_API PyrStr expect_str(Result r, PyrStr message) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic_str(message);
+    return r.value.str_val;
+}
+
+PYRINAS_RESULT_API void* expect_ptr(Result r, PyrStr message) {
+    if (PYRINAS_UNLIKELY(r.type == ERR)) pyrinas_panic_str(message);
+    return r.value.ptr_val;
+}
+
+#undef PYRINAS_RESULT_API
+
+#else
+
 // Result utility functions
 bool is_ok(Result r);
 bool is_err(Result r);
 int unwrap_int(Result r);
 float unwrap_float(Result r);
-char* unwrap_str(Result r);
+PyrStr unwrap_str(Result r);
 void* unwrap_ptr(Result r);
 int unwrap_or_int(Result r, int default_val);
 float unwrap_or_float(Result r, float default_val);
-char* unwrap_or_str(Result r, char* default_val);
+PyrStr unwrap_or_str(Result r, PyrStr default_val);
 void* unwrap_or_ptr(Result r, void* default_val);
-int expect_int(Result r, char* message);
-float expect_float(Result r, char* message);
-char* expect_str(Result r, char* message);
-void* expect_ptr(Result r, char* message);
+int expect_int(Result r, PyrStr message);
+float expect_float(Result r, PyrStr message);
+PyrStr expect_str(Result r, PyrStr message);
+void* expect_ptr(Result r, PyrStr message);
+
+#endif // PYRINAS_INLINE_RUNTIME || PYRINAS_RUNTIME_IMPL
+
+// Buffered standard output used by print. Each thread appends to its own
+// buffer without locking; a buffer is written with one write() when it
+// fills, on pyrinas_flush(), when its thread exits and, for the thread
+// calling exit(), at exit. Earlier stdio output is flushed first. The
+// scheduler also flushes a thread's buffer before it spawns work and when
+// a task finishes, so output keeps the order spawns and joins give it.
+void pyrinas_write_int(long long value);
+void pyrinas_write_float(double value);  // Formatted like printf("%f")
+void pyrinas_write_str(PyrStr value);
+void pyrinas_write_cstr(const char* value);
+void pyrinas_write_char(char value);
+void pyrinas_write_ptr(const void* value);
+void pyrinas_flush(void);
+
+// Work-stealing task scheduler. Each worker owns a Chase-Lev deque: it
+// pushes and pops its own tasks at the bottom while idle workers steal from
+// the top. The pool starts on first use with one worker per core (or
+// PYRINAS_NUM_THREADS); the thread that starts it becomes worker 0. Tasks
+// spawned from threads outside the pool run immediately on that thread.
+typedef struct PyrinasTask PyrinasTask;
+
+// Starts the pool with `threads` workers (0: default); optional
+void pyrinas_pool_init(int threads);
+int pyrinas_pool_size(void);
+
+// Index of the calling worker in [0, pyrinas_pool_size()), or
+// pyrinas_pool_size() on a thread outside the pool
+int pyrinas_worker_index(void);
+
+// Copies `size` bytes of `data` into the task and runs fn on that copy
+PyrinasTask* pyrinas_spawn(void (*fn)(void* data), const void* data, size_t size);
+
+// Runs other tasks until `task` is done, copies the first `size` bytes of
+// its data to `out` (if non-NULL) and frees it. Join each task exactly once.
+void pyrinas_join(PyrinasTask* task, void* out, size_t size);
+
+// Calls body on disjoint [begin, end) chunks of [start, end) in parallel,
+// splitting down to `grain` iterations (0: chosen from the pool size)
+void pyrinas_parallel_for(int start, int end, int grain,
+                          void (*body)(int begin, int end, void* ctx), void* ctx);
+
+// Calls body(i) for every i in [0, n) in parallel
+void pyrinas_parallel_for_each(int n, void (*body)(int i));
+
+// Function profiler for --profile. An instrumented function starts with
+// PYRINAS_PROFILE_FUNCTION, which keeps a frame on its stack until it
+// returns; the cleanup attribute runs the exit probe on every return path.
+// Each thread counts calls and ticks per function in its own table, and
+// when PYRINAS_PROFILE_TRACE names a file, also keeps its most recent calls
+// in a ring buffer. At exit the tables are merged into a report on stderr
+// of calls and inclusive and exclusive time per function, and the ring
+// buffers are written to the trace file as Chrome trace JSON. Ticks come
+// from the TSC on x86 and from the monotonic clock elsewhere.
+typedef struct PyrinasProfileSite {
+    const char* name;
+    const char* file;
+    int line;
+    int id;  // Assigned on the first call
+} PyrinasProfileSite;
+
+typedef struct PyrinasProfileFrame {
+    struct PyrinasProfileFrame* parent;
+    PyrinasProfileSite* site;
+    uint64_t start;
+    uint64_t children;  // Ticks spent in instrumented callees
+} PyrinasProfileFrame;
+
+void pyrinas_profile_enter(PyrinasProfileFrame* frame, PyrinasProfileSite* site);
+void pyrinas_profile_exit(PyrinasProfileFrame* frame);
+
+#define PYRINAS_PROFILE_FUNCTION(name, file, line) \
+    static PyrinasProfileSite pyrinas_profile_site = { name, file, line, 0 }; \
+    PyrinasProfileFrame pyrinas_profile_frame __attribute__((cleanup(pyrinas_profile_exit))); \
+    pyrinas_profile_enter(&pyrinas_profile_frame, &pyrinas_profile_site)
+
+// Region allocator. Allocation bumps a cursor through malloc'd blocks;
+// reset rewinds to the first block and keeps every block for reuse, free
+// releases them all. Memory is not zeroed. Not thread-safe.
+typedef struct PyrinasArenaBlock PyrinasArenaBlock;
+
+typedef struct PyrinasArena {
+    char* cursor;
+    char* limit;
+    PyrinasArenaBlock* current;  // Block the cursor is in
+    PyrinasArenaBlock* blocks;   // First block
+    size_t block_size;
+} PyrinasArena;
+
+// block_size 0 uses 64 KiB blocks
+PyrinasArena* pyrinas_arena_new(size_t block_size);
+void* pyrinas_arena_alloc_slow(PyrinasArena* arena, size_t size, size_t align);
+void* pyrinas_arena_alloc_array(PyrinasArena* arena, int count, size_t size, size_t align);
+void pyrinas_arena_reset(PyrinasArena* arena);
+void pyrinas_arena_free(PyrinasArena* arena);
+
+// align must be a power of two
+static inline void* pyrinas_arena_alloc(PyrinasArena* arena, size_t size, size_t align) {
+    uintptr_t start = ((uintptr_t)arena->cursor + (align - 1)) & ~(uintptr_t)(align - 1);
+    if (PYRINAS_LIKELY(start <= (uintptr_t)arena->limit && size <= (uintptr_t)arena->limit - start)) {
+        arena->cursor = (char*)(start + size);
+        return (void*)start;
+    }
+    return pyrinas_arena_alloc_slow(arena, size, align);
+}
+
+// Fixed-size object pool: released objects go on a free list and are
+// handed out again before new ones are carved from the pool's arena.
+typedef struct PyrinasObjectPool {
+    void* free_list;
+    size_t object_size;
+    size_t align;
+    PyrinasArena* arena;
+} PyrinasObjectPool;
+
+PyrinasObjectPool* pyrinas_object_pool_new(size_t object_size, size_t align);
+void pyrinas_object_pool_free(PyrinasObjectPool* pool);
+
+static inline void* pyrinas_object_pool_alloc(PyrinasObjectPool* pool) {
+    void* object = pool->free_list;
+    if (object) {
+        pool->free_list = *(void**)object;
+        return object;
+    }
+    return pyrinas_arena_alloc(pool->arena, pool->object_size, pool->align);
+}
+
+static inline void pyrinas_object_pool_release(PyrinasObjectPool* pool, void* object) {
+    *(void**)object = pool->free_list;
+    pool->free_list = object;
+}
 
 #endif // PYRINAS_H
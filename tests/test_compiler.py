@@ -10,6 +10,7 @@ EXAMPLES_DIR = os.path.join(os.path.dirname(__file__), '..', 'examples')
 # the format is (example_name, expected_output)
 EXAMPLES = [
     ('expressions', '13.500000\n5\n7.000000\n2.500000\n1\n0\n'),
+    ('integer_division', '-4\n-4\n2\n2\n-4\n-1\n-4.000000\n-4.000000\n0.500000\n0.500000\n'),
     ('for_loop', '0\n1\n2\n3\n4\n5\n'),
     ('functions', '8\n'),
     ('if_else', 'x is greater than y\nx is 10\ny is not 10\n'),
@@ -17,15 +18,24 @@ EXAMPLES = [
     ('variables', '10\n3.140000\n'),
     ('while_loop', '0\n1\n2\n3\n4\n'),
     ('hello', 'Hello, Pyrinas!\n'),
+    ('printing', 'total 3 3.500000\n1.500000\n1 -2147483648\nDone\n'),
+    ('strings', 'Hello, World! 13\nWorld 5\n1 0\n3\nWorld-World-World-42\n5\n'),
+    ('comptime', '7 137 243\n0.000000 0.707107 0.980785\n3628800 132\n120\n194\n'),
     ('break', '0\n1\n2\n3\n4\n'),
     ('continue', '1\n3\n5\n7\n9\n'),
     ('labeled_break', '0\n0\n0\n0\n0\n0\n0\n0\n0\n0\n0\n1\n2\n3\n4\n5\n6\n7\n8\n9\n0\n2\n4\n6\n8\n10\n12\n14\n16\n18\n0\n3\n6\n9\n12\n15\n18\n21\n24\n27\n0\n4\n8\n12\n16\n20\n24\n28\n'),
     ('pointers', '42\n100\n'),
     ('multilevel_pointers', '42\n100\n50\n'),
     ('memory', '255\n'),
+    ('arenas', '499500\n42\n1\n'),
     ('arrays', '0\n10\n20\n30\n40\n'),
+    ('parallel', '2001\n998001\n0\n998001\n'),
+    ('tasks', '17711\n0\n9801\n'),
+    ('task_output', '1\n25\n75025\n196418\n'),
     ('structs', '10\n20.500000\n10\n30\n'),
     ('errors', '5\ndivision by zero\n'),
+    ('result_structs', '3\n4\n1\n0\n5\n'),
+    ('result_imports', '5\ndivision by zero\n1\n7\n'),
     ('immutable', '5\n10\n42\n'),
     # Integration tests - combining multiple features
     ('integration_simple', '3\n4\n25\n'),
@@ -38,14 +48,17 @@ EXAMPLES = [
     ('integration_kitchen_sink', '48\n1\n5\n2\n30\n'),
     ('integration_memory_pointers_functions', '14\n255\n'),
     ('interfaces', 'Drawing rectangle\n50\nDrawing circle\n27\n'),
+    ('interface_dispatch', '36\n40\n6\n36\n40\n'),
     ('enums', 'Red color selected\nStatus is pending\n0\n1\n2\n3\n'),
     ('recursion', '120\n8\n3\n2\n1\n'),
     ('nested_structs', '10\n20\n5\n100\n50\n100\n5\n10\n'),
     ('simple_recursive_test', '42\n84\n84\n'),
     # C interop tests
     ('c_math_demo', '1\n0\n5\n8\n7\n5\n'),
+    ('c_buffers', '100 16\n0\n4.000000\n'),
     # Import system tests
     ('import_demo', '25\n3\n5\n13\n1\n8\n5\n'),
+    ('inline_functions', '16\n0\n120\n55\n'),
 ]
 
 @pytest.mark.parametrize("example, expected_output", EXAMPLES)
@@ -59,8 +72,10 @@ def test_example(example, expected_output):
     # Compile the example
     subprocess.run(['python3', '-m', 'pyrinas.cli', input_file, '-o', output_executable], check=True)
     
-    # Run the compiled executable and capture the output
-    result = subprocess.run([output_executable], capture_output=True, text=True, check=True)
+    # Run the compiled executable and capture the output. Several workers
+    # make the task examples cross threads even on a single-core machine.
+    env = dict(os.environ, PYRINAS_NUM_THREADS='4')
+    result = subprocess.run([output_executable], capture_output=True, text=True, check=True, env=env)
     
     # a.out and its .c file are temporary files, so they should be removed
     os.remove(output_executable)